@@ -0,0 +1,33 @@
+#pragma once
+
+#if defined( _WIN32 )
+#include <windows.h>
+#include <winternl.h>
+#else
+#include <cstdint>
+
+/**
+ * @brief Minimal Win32 type and calling-convention shims for non-Windows builds
+ *
+ * Only the platform-neutral parts of the modules (aggregation cores, parsers,
+ * portable providers) are compiled outside Windows, and they only need the
+ * handful of aliases used by the shared structures in types.hpp.
+ */
+using ULONG  = uint32_t;
+using UCHAR  = uint8_t;
+using USHORT = uint16_t;
+using DWORD  = uint32_t;
+using PVOID  = void *;
+
+#ifndef __cdecl
+#define __cdecl
+#endif
+
+#ifndef __stdcall
+#define __stdcall
+#endif
+
+#ifndef __fastcall
+#define __fastcall
+#endif
+#endif
@@ -1,9 +1,9 @@
 #pragma once
 
+#include "platform.hpp"
+
 #include <array>
 #include <cstdint>
-#include <windows.h>
-#include <winternl.h>
 
 namespace vac::common {
     /**
@@ -111,7 +111,9 @@ namespace vac::common {
         query_directory_api_missing = 410, ///< NtQueryDirectoryObject API not found
         section_access_failed       = 440, ///< Section access failed (not ERROR_FILE_NOT_FOUND)
         directory_enum_failed       = 466, ///< Directory enumeration failed
-        section_mapping_failed      = 483  ///< MapViewOfFile failed
+        section_mapping_failed      = 483, ///< MapViewOfFile failed
+        section_read_contended      = 496, ///< No consistent section copy within the seqlock retry budget
+        section_checksum_mismatch   = 497  ///< CRC32C of m_process_data does not match m_checksum
     };
 
     /**
@@ -127,21 +129,24 @@ namespace vac::common {
         uint32_t m_process_count        = { }; ///< +8: Number of processes
         uint32_t m_last_update_time     = { }; ///< +12: Last update timestamp
         uint32_t m_flags                = { }; ///< +16: Section flags
-        uint32_t m_reserved             = { }; ///< +20: Reserved field
+        uint32_t m_reserved             = { }; ///< +20: Update sequence counter, odd while the producer writes (seqlock)
         uint8_t  m_process_data[ 4072 ] = { }; ///< +24: Process information data
-        uint32_t m_checksum             = { }; ///< +4096: Data integrity checksum
+        uint32_t m_checksum             = { }; ///< +4096: CRC32C of m_process_data
     };
 
     /**
      * @brief CPU information entry structure (24 bytes each)
+     *
+     * The query inputs come first and CPUID writes EAX..EDX behind them, the layout the
+     * server parses out of the output buffer.
      */
     struct cpu_info_entry_t {
-        uint32_t m_eax_value     = { }; ///< +0: EAX register value
-        uint32_t m_ebx_value     = { }; ///< +4: EBX register value
-        uint32_t m_ecx_value     = { }; ///< +8: ECX register value
-        uint32_t m_edx_value     = { }; ///< +12: EDX register value
-        uint32_t m_function_code = { }; ///< +16: CPUID function code used
-        uint32_t m_sub_function  = { }; ///< +20: CPUID sub-function/leaf
+        uint32_t m_function_code = { }; ///< +0: CPUID function code used (EAX input)
+        uint32_t m_sub_function  = { }; ///< +4: CPUID sub-function/leaf (ECX input)
+        uint32_t m_eax_value     = { }; ///< +8: EAX register value
+        uint32_t m_ebx_value     = { }; ///< +12: EBX register value
+        uint32_t m_ecx_value     = { }; ///< +16: ECX register value
+        uint32_t m_edx_value     = { }; ///< +20: EDX register value
     };
 
     /**
@@ -160,14 +165,14 @@ namespace vac::common {
      */
     struct cpuid_function_descriptor_t {
         uint32_t m_function_code                                      = { }; ///< CPUID function code to query
-        bool( __cdecl *m_validator )( int context, int entry_offset ) = { }; ///< Validation function pointer
+        bool( __cdecl *m_validator )( intptr_t context, intptr_t entry_offset ) = { }; ///< Validation function pointer, addresses pointer-sized
     };
 
     /**
      * @brief PnP device entry structure (8 bytes each)
      */
     struct pnp_device_entry_t {
-        uint32_t m_type_and_class = { }; ///< +0: Type flags (bits 0-3) | Class code (bits 4-31)
+        uint32_t m_type_and_class = { }; ///< +0: Type flags (bits 0-3) | Classification tag (bits 4-7) | Class code (bits 8-31)
         uint16_t m_vendor_id      = { }; ///< +4: Vendor ID (VID)
         uint16_t m_product_id     = { }; ///< +6: Product ID (PID)
     };
@@ -1,4 +1,7 @@
 ﻿#include "anti_debugging.hpp"
+#include "../../utils/vac_clock_utils.hpp"
+#include "../../utils/vac_instrumentation.hpp"
+
 #include <Windows.h>
 #include <winternl.h>
 
@@ -6,21 +9,13 @@
 
 namespace vac::modules::anti_debugging {
     static uint32_t read_vac_timestamp( ) {
-        while ( *reinterpret_cast< volatile uint32_t * >( 0x7FFE0324 ) != *reinterpret_cast< volatile uint32_t * >( 0x7FFE0328 ) ) { }
-
-        const uint32_t tsc_high   = *reinterpret_cast< volatile uint32_t * >( 0x7FFE0320 );
-        const uint32_t tsc_low    = *reinterpret_cast< volatile uint32_t * >( 0x7FFE0328 );
-        const uint32_t multiplier = *reinterpret_cast< volatile uint32_t * >( 0x7FFE0004 );
-        const uint32_t base       = *reinterpret_cast< volatile uint32_t * >( 0x7FFE0000 );
-
-        if ( tsc_high | tsc_low ) {
-            return multiplier * ( tsc_low << 8 ) + static_cast< uint32_t >( ( static_cast< uint64_t >( tsc_high ) * multiplier ) >> 24 );
-        } else {
-            return static_cast< uint32_t >( ( static_cast< uint64_t >( multiplier ) * base ) >> 24 );
-        }
+        // GetTickCount() milliseconds, the value the encoding below expects; never the TSC clock
+        return utils::platform_clock( ).now_ms( );
     }
 
     int antidebug_check( [[maybe_unused]] void *context, uint32_t *out_buffer, uint32_t *out_size ) {
+        VAC_TRACE_FUNCTION( );
+
         if ( !out_buffer || !out_size )
             return 0;
 
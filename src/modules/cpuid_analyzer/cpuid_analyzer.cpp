@@ -1,177 +1,138 @@
 #include "cpuid_analyzer.hpp"
-#include <intrin.h>
+#include "cpuid_backend.hpp"
+#include "../../utils/vac_instrumentation.hpp"
+
+#include <atomic>
+#include <mutex>
 
 namespace vac::modules::cpuid_analyzer {
 
-    // Global CPUID support detection flag - exact VAC location dword_100067D0
-    static uint32_t g_cpuid_support_flag = 0;
+    // CPUID support detection flag - VAC location dword_100067D0; probed once, readable from any thread
+    static std::atomic< uint32_t > g_cpuid_support_flag = { 0 };
+    static std::once_flag          g_cpuid_support_probe;
 
-    // CPUID function lookup table - exact VAC data at dword_10006570 and off_10006574
+    // CPUID validator table, sorted by function code - VAC data at dword_10006570 and off_10006574 without the terminator
     constexpr common::cpuid_function_descriptor_t g_cpuid_function_table[] = {
         { 0x40000000, validate_hypervisor_info }, // Hypervisor information function
-        {          0,                  nullptr }  // Terminator
     };
 
-    int __fastcall execute_cpuid_instruction( uint32_t *eax_function_code, uint32_t *ebx_output, uint32_t *ecx_output,
-                                              uint32_t *edx_output ) {
-        // Check if CPUID support has been tested
-        if ( !g_cpuid_support_flag ) {
-            uint32_t eflags_test_bit = 0x200000; // CPUID flag (bit 21)
-
-            uint32_t original_eflags = __readeflags( );
-            uint32_t saved_eflags    = original_eflags;
+    constexpr uint32_t cpuid_validator_key( const common::cpuid_function_descriptor_t &descriptor ) { return descriptor.m_function_code; }
 
-            uint32_t modified_eflags = __readeflags( );
-            __writeeflags( modified_eflags ^ eflags_test_bit );
-            uint32_t tested_eflags = __readeflags( );
+    static_assert( is_sorted_table( g_cpuid_function_table, cpuid_validator_key ), "g_cpuid_function_table must be sorted by function code" );
 
-            __writeeflags( saved_eflags );
+    namespace {
+        bool( __cdecl *find_cpuid_validator( const uint32_t function_code ) )( intptr_t, intptr_t ) {
+            const common::cpuid_function_descriptor_t *descriptor
+                = find_sorted_entry( g_cpuid_function_table, function_code, cpuid_validator_key );
+            return descriptor ? descriptor->m_validator : nullptr;
+        }
+    } // namespace
 
-            // Check if CPUID flag could be toggled
-            if ( ( ( modified_eflags ^ tested_eflags ) & eflags_test_bit ) == 0 ) {
-                return 0; // CPUID not supported
-            }
+    int __fastcall execute_cpuid_instruction( uint32_t *eax_function_code, uint32_t *ebx_output, uint32_t *ecx_output,
+                                              uint32_t *edx_output ) {
+        // Test CPUID support once per process; concurrent first callers wait for the probe
+        std::call_once( g_cpuid_support_probe,
+                        [ ] { g_cpuid_support_flag.store( probe_cpuid_support( ) ? 1 : 0, std::memory_order_release ); } );
 
-            g_cpuid_support_flag = 1; // Mark CPUID as supported
+        if ( !g_cpuid_support_flag.load( std::memory_order_acquire ) ) {
+            return 0; // CPUID not supported
         }
 
-        // Execute CPUID instruction
-        uint32_t eax_value = *eax_function_code;
-        uint32_t ebx_value, ecx_value, edx_value;
-
-        // Inline assembly for CPUID instruction
-        __asm {
-            mov eax, eax_value
-            cpuid
-            mov ebx_value, ebx
-            mov ecx_value, ecx  
-            mov edx_value, edx
-            mov eax_value, eax
-        }
+        // Execute CPUID instruction, ECX selects the subleaf
+        uint32_t registers[ 4 ] = { *eax_function_code, 0, *ecx_output, 0 };
+        execute_cpuid_native( registers );
 
         // Store results in output parameters
-        *eax_function_code = eax_value;
-        *ebx_output        = ebx_value;
-        *ecx_output        = ecx_value;
-        *edx_output        = edx_value;
+        *eax_function_code = registers[ 0 ];
+        *ebx_output        = registers[ 1 ];
+        *ecx_output        = registers[ 2 ];
+        *edx_output        = registers[ 3 ];
 
         return 1; // Success
     }
 
     int __fastcall query_cpuid_function( common::cpuid_analysis_context_t *analysis_context, uint32_t *entry_count, uint32_t *first_output,
-                                         const uint32_t function_code, bool( __cdecl *validator )( int context, int entry_offset ) ) {
-        const int       entry_offset   = 24 * ( *entry_count ) + 40;
-        static uint32_t sub_function   = 0;
-        static int      context_offset = reinterpret_cast< int >( analysis_context );
-
-        common::cpu_info_entry_t *current_entry = &analysis_context->m_cpu_entries[ *entry_count ];
-        common::cpu_info_entry_t *next_entry    = current_entry + 2; // Points to ECX/EDX storage
-
+                                         const uint32_t function_code, const uint32_t sub_function,
+                                         bool( __cdecl *validator )( intptr_t context, intptr_t entry_offset ), const cpuid_snapshot_t *snapshot ) {
         if ( *entry_count >= 169 ) {
             return 1; // Entry count limit exceeded
         }
 
-        // Initialize CPU info entry
-        current_entry->m_eax_value     = function_code; // Store function code in EAX
-        next_entry->m_eax_value        = function_code; // Duplicate for validation
-        current_entry->m_ebx_value     = sub_function;  // Sub-function/leaf (typically 0)
-        current_entry->m_function_code = sub_function;  // Additional sub-function storage
-
-        const uint32_t incremented_sub_function = sub_function + 1;
+        const int                 entry_offset  = 24 * ( *entry_count ) + 40;
+        common::cpu_info_entry_t *current_entry = &analysis_context->m_cpu_entries[ *entry_count ];
 
-        // Execute CPUID instruction
-        if ( !execute_cpuid_instruction( &current_entry->m_ecx_value, &current_entry->m_edx_value, &current_entry->m_function_code,
-                                         &current_entry->m_sub_function ) ) {
+        // Initialize CPU info entry, EAX/ECX double as the CPUID inputs
+        current_entry->m_eax_value     = function_code;
+        current_entry->m_ecx_value     = sub_function;
+        current_entry->m_function_code = function_code;
+        current_entry->m_sub_function  = sub_function;
+
+        // Read the captured registers, execute CPUID only for leaves outside the snapshot
+        const cpuid_leaf_t *captured_leaf = snapshot ? snapshot->find( function_code, sub_function ) : nullptr;
+        if ( captured_leaf ) {
+            current_entry->m_eax_value = captured_leaf->m_eax;
+            current_entry->m_ebx_value = captured_leaf->m_ebx;
+            current_entry->m_ecx_value = captured_leaf->m_ecx;
+            current_entry->m_edx_value = captured_leaf->m_edx;
+        } else if ( !execute_cpuid_instruction( &current_entry->m_eax_value, &current_entry->m_ebx_value, &current_entry->m_ecx_value,
+                                                &current_entry->m_edx_value ) ) {
             return 2; // CPUID instruction failed
         }
 
-        // Store first output for caller (typically EBX value)
-        if ( !function_code ) { // For function 0, return max supported function
-            *first_output = next_entry->m_eax_value;
-        }
+        // EAX output, the highest leaf of the range for base leaves
+        *first_output = current_entry->m_eax_value;
 
         ++( *entry_count );
 
-        // Call validator function if provided
+        // Call validator function if provided; its verdict does not change the query result
         if ( validator ) {
-            const int validation_result = validator( context_offset + entry_offset, reinterpret_cast< int >( current_entry ) );
-            sub_function                = incremented_sub_function;
-            context_offset              = reinterpret_cast< int >( analysis_context );
-
-            if ( validation_result ) {
-                return 0;
-            }
+            validator( reinterpret_cast< intptr_t >( analysis_context ) + entry_offset, reinterpret_cast< intptr_t >( current_entry ) );
         }
 
         return 0;
     }
 
-    bool __cdecl validate_hypervisor_info( [[maybe_unused]] int context_offset, const int entry_offset ) {
-        // Extract ECX value from CPU info entry
-        // entry_offset + 8 points to ECX register value
-        const uint8_t ecx_lower_bits = *reinterpret_cast< uint8_t * >( entry_offset + 8 );
+    bool __cdecl validate_hypervisor_info( [[maybe_unused]] intptr_t context_offset, const intptr_t entry_offset ) {
+        // Extract EAX value from CPU info entry
+        // entry_offset + 8 points to EAX register value (m_eax_value), the highest hypervisor leaf
+        const uint8_t eax_lower_bits = *reinterpret_cast< uint8_t * >( entry_offset + 8 );
 
         // Check if any of the lower 4 bits are set (hypervisor features)
-        return ( ecx_lower_bits & 0xF ) != 0;
+        return ( eax_lower_bits & 0xF ) != 0;
     }
 
     int analyze_cpu_information( common::cpuid_analysis_context_t *analysis_context ) {
-        int      analysis_result      = 0;
-        uint32_t first_output         = 0;
-        int      function_range_index = 0;
-
-        // Process three main CPUID function ranges
-        while ( function_range_index < 3 ) {
-            // Get base function code for current range from lookup table
-            // Offset 28 in context + function_range_index points to base function codes
-            const uint32_t base_function_code
-                = reinterpret_cast< uint32_t * >( reinterpret_cast< char * >( analysis_context ) + 28 )[ function_range_index ];
-
-            uint32_t current_function = base_function_code;
-
-            // Query functions in current range
-            do {
-                uint32_t validator_function_ptr = 0;
-
-                // Look up validator function in descriptor table
-                for ( uint32_t lookup_index = 0; lookup_index < 20; lookup_index += 2 ) {
-                    if ( current_function < g_cpuid_function_table[ lookup_index / 2 ].m_function_code ) {
-                        break; // Function not found in table
-                    }
-                    if ( current_function == g_cpuid_function_table[ lookup_index / 2 ].m_function_code ) {
-                        validator_function_ptr = reinterpret_cast< uint32_t >( g_cpuid_function_table[ lookup_index / 2 ].m_validator );
-                        break;
-                    }
-                }
+        VAC_TRACE_FUNCTION( );
 
-                // Query CPUID function with found validator
-                const int query_result
-                    = query_cpuid_function( analysis_context, &analysis_context->m_entry_count, &first_output, current_function,
-                                            reinterpret_cast< bool( __cdecl * )( int, int ) >( validator_function_ptr ) );
-
-                // Process query result
-                if ( query_result ) {
-                    const int result_code = query_result - 1;
-                    if ( result_code ) {
-                        if ( result_code == 1 ) {
-                            analysis_result = 30; // Hypervisor/virtualization detected
-                        } else {
-                            analysis_result = -1; // Unexpected error
-                        }
-                    } else {
-                        analysis_result = 234; // Critical CPU features detected
-                    }
-                    goto ANALYSIS_COMPLETE;
-                }
+        int      analysis_result = 0;
+        uint32_t first_output    = 0;
 
-                ++current_function;
+        // One snapshot for the whole analysis, even if it is refreshed meanwhile
+        const std::shared_ptr< const cpuid_snapshot_t > snapshot = current_cpuid_snapshot( );
 
-            } while ( current_function <= base_function_code ); // Continue in range
+        if ( !snapshot->supported( ) ) {
+            analysis_context->m_analysis_result = 30; // CPUID unavailable, as when a query fails
+            return analysis_context->m_analysis_result;
+        }
 
-            ++function_range_index; // Move to next function range
+        // Every leaf and subleaf of the standard, hypervisor and extended ranges, in (leaf, subleaf) order
+        for ( const cpuid_leaf_t &leaf : snapshot->leaves( ) ) {
+            const int query_result = query_cpuid_function( analysis_context, &analysis_context->m_entry_count, &first_output, leaf.m_leaf,
+                                                           leaf.m_subleaf, find_cpuid_validator( leaf.m_leaf ), snapshot.get( ) );
+
+            // Process query result
+            if ( query_result ) {
+                if ( query_result == 1 ) {
+                    analysis_result = 234; // Entry table full
+                } else if ( query_result == 2 ) {
+                    analysis_result = 30; // CPUID failed
+                } else {
+                    analysis_result = -1; // Unexpected error
+                }
+                break;
+            }
         }
 
-    ANALYSIS_COMPLETE:
         // Store analysis result in context - exact VAC memory location
         analysis_context->m_analysis_result = analysis_result;
         return analysis_result;
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "../../common/types.hpp"
+#include "cpuid_snapshot.hpp"
+
 #include <cstdint>
 
 namespace vac::modules::cpuid_analyzer {
@@ -8,20 +10,25 @@ namespace vac::modules::cpuid_analyzer {
      * @brief Execute CPUID instruction and retrieve CPU information
      *
      * This function performs the low-level CPUID instruction execution with CPU feature detection.
-     * It first checks if the CPU supports CPUID by testing the CPUID flag in EFLAGS register.
+     * On 32-bit x86 it first checks if the CPU supports CPUID by testing the CPUID flag in
+     * EFLAGS register; every x86-64 CPU has CPUID, so the probe is skipped there.
+     *
+     * The backend is picked at compile time:
+     * - MSVC x86: inline assembly, EFLAGS bit 21 toggled with __readeflags/__writeeflags
+     * - MSVC x64: __cpuidex from <intrin.h>
+     * - GCC/Clang: __cpuid_count from <cpuid.h> (__get_cpuid_max does the EFLAGS probe on i386)
      *
-     * The function uses inline assembly to:
-     * 1. Test EFLAGS bit 21 (CPUID support flag) by toggling it
-     * 2. Execute CPUID instruction with the provided function code
-     * 3. Return all four register values (EAX, EBX, ECX, EDX)
+     * All of them execute CPUID with the provided function code and subleaf and return all
+     * four register values (EAX, EBX, ECX, EDX).
      *
      * @param eax_function_code Pointer to EAX input (CPUID function code), receives EAX output
      * @param ebx_output Pointer to receive EBX register output
-     * @param ecx_output Pointer to receive ECX register output
+     * @param ecx_output Pointer to ECX input (CPUID sub-function), receives ECX register output
      * @param edx_output Pointer to receive EDX register output
      * @return 1 if CPUID is supported and executed successfully, 0 if CPU doesn't support CPUID
      *
-     * @note Uses global flag dword_100067D0 to cache CPUID support detection
+     * @note Caches the support probe in g_cpuid_support_flag (VAC dword_100067D0); the probe
+     *       runs once under std::call_once, so the function is safe to call from any thread
      */
     int __fastcall execute_cpuid_instruction( uint32_t *eax_function_code, uint32_t *ebx_output, uint32_t *ecx_output,
                                               uint32_t *edx_output );
@@ -29,45 +36,50 @@ namespace vac::modules::cpuid_analyzer {
     /**
      * @brief Query specific CPUID function and store results
      *
-     * This function queries a specific CPUID function code and stores the results in the analysis context.
+     * This function queries a specific CPUID leaf/subleaf and stores the results in the analysis context.
      * It handles the CPUID execution, result validation, and entry management.
      *
      * The function:
-     * 1. Calculates the storage offset for the new CPU info entry (24 bytes each)
-     * 2. Checks if the entry count limit (169 entries) has been reached
-     * 3. Initializes the CPU info entry with function codes and sub-function
-     * 4. Executes CPUID instruction to get register values
-     * 5. Stores results in the cpu_entries array
-     * 6. Calls optional validation function if provided
-     * 7. Increments entry count on successful execution
+     * 1. Checks if the entry count limit (169 entries) has been reached
+     * 2. Initializes the next 24-byte CPU info entry with the function code and sub-function
+     * 3. Reads the register values from the CPUID snapshot, executing CPUID only for
+     *    leaves the snapshot does not hold
+     * 4. Calls optional validation function if provided
+     * 5. Increments entry count on successful execution
+     *
+     * Keeps no state between calls, the subleaf is passed explicitly.
      *
      * @param analysis_context Pointer to CPUID analysis context structure
      * @param entry_count Pointer to current entry count, will be incremented
-     * @param first_output Pointer to receive first CPUID output (typically EBX)
+     * @param first_output Pointer to receive the EAX output (highest leaf for range base leaves)
      * @param function_code CPUID function code to query (EAX input)
+     * @param sub_function CPUID sub-function to query (ECX input)
      * @param validator Optional validation function pointer, can be nullptr
+     * @param snapshot Captured leaves to read from, nullptr to always execute CPUID
      * @return 0 on success
      * @return 1 if entry count limit exceeded (>= 169 entries)
      * @return 2 if CPUID instruction failed (CPU doesn't support CPUID)
      */
     int __fastcall query_cpuid_function( common::cpuid_analysis_context_t *analysis_context, uint32_t *entry_count, uint32_t *first_output,
-                                         uint32_t function_code, bool( __cdecl *validator )( int context, int entry_offset ) );
+                                         uint32_t function_code, uint32_t sub_function,
+                                         bool( __cdecl *validator )( intptr_t context, intptr_t entry_offset ), const cpuid_snapshot_t *snapshot = nullptr );
 
     /**
      * @brief Hypervisor detection validator
      *
      * This function validates CPUID results for hypervisor detection purposes.
-     * It checks the ECX register from CPUID function 0x40000000 (hypervisor info).
+     * It checks the EAX register from CPUID function 0x40000000 (hypervisor info),
+     * the highest hypervisor leaf, stored at +8 of the entry.
      *
      * The hypervisor presence is detected by checking if any of the lower 4 bits
-     * in the ECX register are set, which indicates hypervisor-specific features.
+     * in the EAX register are set, which indicates hypervisor-specific features.
      *
      * @param context_offset Offset to analysis context (unused in validation)
      * @param entry_offset Offset to the CPU info entry being validated
-     * @return true if hypervisor features detected (ECX & 0xF != 0)
+     * @return true if hypervisor features detected (EAX & 0xF != 0)
      * @return false if no hypervisor features detected
      */
-    bool __cdecl validate_hypervisor_info( int context_offset, int entry_offset );
+    bool __cdecl validate_hypervisor_info( intptr_t context_offset, intptr_t entry_offset );
 
     /**
      * @brief Perform comprehensive CPUID analysis
@@ -75,28 +87,30 @@ namespace vac::modules::cpuid_analyzer {
      * This is the main CPUID analysis function that queries multiple CPU information categories.
      * It systematically checks different CPUID function ranges and validates the results.
      *
-     * The function performs analysis in these stages:
-     * 1. BASIC CPU INFO: Queries standard CPUID functions (0x0 - 0x1F range typically)
-     * 2. HYPERVISOR INFO: Queries hypervisor CPUID functions (0x40000000 range)
-     * 3. EXTENDED CPU INFO: Queries extended CPUID functions (0x80000000 range)
+     * The function walks every leaf of the process-wide CPUID snapshot (current_cpuid_snapshot()):
+     * 1. BASIC CPU INFO: standard leaves 0x0 up to the maximum reported by leaf 0x0
+     * 2. HYPERVISOR INFO: hypervisor leaves from 0x40000000
+     * 3. EXTENDED CPU INFO: extended leaves from 0x80000000
      *
-     * For each function range, it:
-     * - Looks up the function code in the descriptor table (dword_10006570)
-     * - Finds the associated validator function (off_10006574)
+     * Subleaves are enumerated per g_cpuid_leaf_rules (cache parameters, structured
+     * extended features, topology, XSAVE components). For each leaf/subleaf it:
+     * - Looks up the validator in the sorted g_cpuid_function_table by binary search
      * - Queries the CPUID function and validates results
-     * - Sets appropriate result codes based on validation outcomes
+     * - Sets appropriate result codes based on query outcomes
+     *
+     * Repeated analyses do not execute CPUID again; refresh_cpuid_snapshot() re-captures.
      *
      * Result codes:
      * - 0: Successful analysis with no issues detected
-     * - 30: Specific detection result (hypervisor/virtualization detected)
-     * - 234: Critical detection result (specific CPU features detected)
+     * - 30: CPUID could not be executed
+     * - 234: Entry table full (169 entries)
      * - -1: Analysis error or unexpected validation result
      *
      * @param analysis_context Pointer to CPUID analysis context structure
      * @return Analysis result code indicating findings
      *
-     * @note The function uses a lookup table at dword_10006570 for function codes
-     *       and off_10006574 for corresponding validator function pointers
+     * @note g_cpuid_function_table mirrors dword_10006570 (function codes) and
+     *       off_10006574 (validator function pointers)
      */
     int analyze_cpu_information( common::cpuid_analysis_context_t *analysis_context );
 } // namespace vac::modules::cpuid_analyzer
\ No newline at end of file
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstdint>
+
+#if defined( _MSC_VER )
+#include <intrin.h>
+#elif defined( __GNUC__ )
+#include <cpuid.h>
+#include <x86intrin.h>
+#endif
+
+/**
+ * @brief Compile-time selected CPUID and TSC primitives
+ *
+ * - MSVC x86: inline assembly, EFLAGS bit 21 probe with __readeflags/__writeeflags
+ * - MSVC x64: __cpuidex from <intrin.h>
+ * - GCC/Clang: __cpuid_count from <cpuid.h>, __get_cpuid_max does the EFLAGS probe on i386
+ *
+ * Everything is inline so callers that time CPUID measure the instruction alone.
+ */
+namespace vac::modules::cpuid_analyzer {
+    /**
+     * @brief Check that the CPU executes CPUID
+     *
+     * Only 32-bit x86 needs the EFLAGS bit 21 probe; every x86-64 CPU has CPUID.
+     */
+    inline bool probe_cpuid_support( ) {
+#if defined( _M_IX86 ) && defined( _MSC_VER )
+        const uint32_t eflags_test_bit = 0x200000; // CPUID flag (bit 21)
+
+        const uint32_t saved_eflags    = __readeflags( );
+        const uint32_t modified_eflags = __readeflags( );
+        __writeeflags( modified_eflags ^ eflags_test_bit );
+        const uint32_t tested_eflags = __readeflags( );
+
+        __writeeflags( saved_eflags );
+
+        // CPUID is supported if the flag could be toggled
+        return ( ( modified_eflags ^ tested_eflags ) & eflags_test_bit ) != 0;
+#elif defined( __i386__ )
+        return __get_cpuid_max( 0, nullptr ) != 0;
+#else
+        return true; // x86-64 always has CPUID
+#endif
+    }
+
+    /**
+     * @brief Execute CPUID, registers[ 0 ] / [ 2 ] hold the leaf / subleaf on entry
+     */
+    inline void execute_cpuid_native( uint32_t ( &registers )[ 4 ] ) {
+#if defined( _M_IX86 ) && defined( _MSC_VER )
+        uint32_t eax_value = registers[ 0 ];
+        uint32_t ecx_value = registers[ 2 ];
+        uint32_t ebx_value, edx_value;
+
+        // Inline assembly for CPUID instruction
+        __asm {
+            mov eax, eax_value
+            mov ecx, ecx_value
+            cpuid
+            mov ebx_value, ebx
+            mov ecx_value, ecx
+            mov edx_value, edx
+            mov eax_value, eax
+        }
+
+        registers[ 0 ] = eax_value;
+        registers[ 1 ] = ebx_value;
+        registers[ 2 ] = ecx_value;
+        registers[ 3 ] = edx_value;
+#elif defined( _MSC_VER )
+        int cpu_info[ 4 ];
+        __cpuidex( cpu_info, static_cast< int >( registers[ 0 ] ), static_cast< int >( registers[ 2 ] ) );
+
+        for ( int index = 0; index < 4; ++index )
+            registers[ index ] = static_cast< uint32_t >( cpu_info[ index ] );
+#else
+        __cpuid_count( registers[ 0 ], registers[ 2 ], registers[ 0 ], registers[ 1 ], registers[ 2 ], registers[ 3 ] );
+#endif
+    }
+
+    /**
+     * @brief Read the TSC once every earlier instruction has completed and before any later one starts
+     */
+    inline uint64_t read_tsc_serialized_begin( ) {
+        _mm_lfence( );
+        const uint64_t timestamp = __rdtsc( );
+        _mm_lfence( );
+        return timestamp;
+    }
+
+    /**
+     * @brief Read the TSC after the timed instructions have completed
+     * @param has_rdtscp Use RDTSCP (CPUID 0x80000001 EDX bit 27), which waits for earlier instructions itself
+     */
+    inline uint64_t read_tsc_serialized_end( const bool has_rdtscp ) {
+        uint64_t timestamp;
+
+        if ( has_rdtscp ) {
+            unsigned int processor_id;
+            timestamp = __rdtscp( &processor_id );
+        } else {
+            _mm_lfence( );
+            timestamp = __rdtsc( );
+        }
+
+        _mm_lfence( );
+        return timestamp;
+    }
+} // namespace vac::modules::cpuid_analyzer
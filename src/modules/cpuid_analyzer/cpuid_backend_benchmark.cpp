@@ -0,0 +1,108 @@
+#include "cpuid_backend_benchmark.hpp"
+#include "cpuid_analyzer.hpp"
+#include "cpuid_backend.hpp"
+#include "../../utils/vac_clock_utils.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace vac::modules::cpuid_analyzer {
+    namespace {
+        /**
+         * @brief Leaf/subleaf pair timed by the benchmark
+         */
+        struct benchmark_leaf_t {
+            uint32_t m_function_code;     ///< EAX input
+            uint32_t m_sub_function;      ///< ECX input
+            uint32_t m_per_core_register; ///< Register holding the APIC ID, differs between cores and is not compared; 4 = none
+        };
+
+        constexpr benchmark_leaf_t g_benchmark_leaves[] = {
+            { 0x00000000, 0, 4 }, { 0x00000001, 0, 1 }, { 0x00000004, 0, 4 }, { 0x00000007, 0, 4 }, { 0x0000000B, 0, 3 },
+            { 0x40000000, 0, 4 }, { 0x80000000, 0, 4 }, { 0x80000001, 0, 4 }, { 0x80000007, 0, 4 },
+        };
+
+        uint32_t highest_leaf( const uint32_t range_base ) {
+            uint32_t registers[ 4 ] = { range_base, 0, 0, 0 };
+            execute_cpuid_native( registers );
+            return registers[ 0 ];
+        }
+
+        /**
+         * @brief Whether the CPU reports a leaf; the hypervisor range answers on any x86 CPU
+         */
+        bool leaf_reported( const uint32_t function_code, const uint32_t max_basic_leaf, const uint32_t max_extended_leaf ) {
+            if ( function_code >= 0x80000000 )
+                return function_code <= max_extended_leaf;
+
+            if ( function_code >= 0x40000000 )
+                return true;
+
+            return function_code <= max_basic_leaf;
+        }
+    } // namespace
+
+    int run_cpuid_backend_benchmark( const cpuid_backend_benchmark_config_t &config, cpuid_backend_benchmark_report_t *report ) {
+        *report = { };
+
+        if ( !probe_cpuid_support( ) )
+            return 2;
+
+        const utils::clock_source_t &clock  = utils::precise_clock( );
+        const uint32_t               rounds = std::max< uint32_t >( config.m_rounds, 1 );
+        const uint32_t               calls  = std::max< uint32_t >( config.m_calls, 1 );
+
+        const uint32_t max_basic_leaf    = highest_leaf( 0 );
+        const uint32_t max_extended_leaf = highest_leaf( 0x80000000 );
+
+        for ( const benchmark_leaf_t &leaf : g_benchmark_leaves ) {
+            if ( !leaf_reported( leaf.m_function_code, max_basic_leaf, max_extended_leaf ) )
+                continue;
+
+            uint64_t best_native_ns    = std::numeric_limits< uint64_t >::max( );
+            uint64_t best_interface_ns = std::numeric_limits< uint64_t >::max( );
+            uint32_t native_registers[ 4 ];
+            uint32_t interface_registers[ 4 ];
+
+            for ( uint32_t round = 0; round < rounds; ++round ) {
+                uint64_t started_at = clock.now_ns( );
+
+                for ( uint32_t call = 0; call < calls; ++call ) {
+                    native_registers[ 0 ] = leaf.m_function_code;
+                    native_registers[ 2 ] = leaf.m_sub_function;
+                    execute_cpuid_native( native_registers );
+                }
+
+                best_native_ns = std::min( best_native_ns, clock.now_ns( ) - started_at );
+                started_at     = clock.now_ns( );
+
+                for ( uint32_t call = 0; call < calls; ++call ) {
+                    interface_registers[ 0 ] = leaf.m_function_code;
+                    interface_registers[ 2 ] = leaf.m_sub_function;
+
+                    if ( !execute_cpuid_instruction( &interface_registers[ 0 ], &interface_registers[ 1 ], &interface_registers[ 2 ],
+                                                     &interface_registers[ 3 ] ) )
+                        return 2;
+                }
+
+                best_interface_ns = std::min( best_interface_ns, clock.now_ns( ) - started_at );
+            }
+
+            for ( uint32_t register_index = 0; register_index < 4; ++register_index ) {
+                if ( register_index != leaf.m_per_core_register && native_registers[ register_index ] != interface_registers[ register_index ] ) {
+                    ++report->m_mismatches;
+                    break;
+                }
+            }
+
+            cpuid_backend_leaf_cost_t cost;
+            cost.m_function_code = leaf.m_function_code;
+            cost.m_sub_function  = leaf.m_sub_function;
+            cost.m_native_ns     = static_cast< double >( best_native_ns ) / calls;
+            cost.m_interface_ns  = static_cast< double >( best_interface_ns ) / calls;
+            report->m_leaves.push_back( cost );
+        }
+
+        return report->m_mismatches ? 1 : 0;
+    }
+} // namespace vac::modules::cpuid_analyzer
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace vac::modules::cpuid_analyzer {
+    /**
+     * @brief Parameters of run_cpuid_backend_benchmark()
+     */
+    struct cpuid_backend_benchmark_config_t {
+        uint32_t m_rounds = 5;    ///< Timed rounds per leaf and path, the fastest is reported
+        uint32_t m_calls  = 2000; ///< CPUID executions per round
+    };
+
+    /**
+     * @brief Call cost of one leaf/subleaf
+     */
+    struct cpuid_backend_leaf_cost_t {
+        uint32_t m_function_code = { }; ///< EAX input
+        uint32_t m_sub_function  = { }; ///< ECX input
+        double   m_native_ns     = { }; ///< Inlined execute_cpuid_native(), nanoseconds per call
+        double   m_interface_ns  = { }; ///< execute_cpuid_instruction(), nanoseconds per call
+    };
+
+    /**
+     * @brief Results of run_cpuid_backend_benchmark()
+     */
+    struct cpuid_backend_benchmark_report_t {
+        std::vector< cpuid_backend_leaf_cost_t > m_leaves;           ///< One entry per leaf the CPU reports
+        uint32_t                                 m_mismatches = { }; ///< Leaves where both paths returned different registers
+    };
+
+    /**
+     * @brief Time the CPUID backend per leaf, through the analyzer's interface and inlined
+     *
+     * Covers the basic, hypervisor and extended leaves the analysis reads most (0, 1, 4, 7,
+     * 0xB, 0x40000000, 0x80000000, 0x80000001, 0x80000007), skipping those above the
+     * highest leaf the CPU reports. The difference between the two paths is the call
+     * overhead of execute_cpuid_instruction() (support check and register marshalling);
+     * under a hypervisor both are dominated by the VM exit.
+     *
+     * @param config Run length
+     * @param report Receives one cost per leaf, cleared first
+     * @return 0 on success, 1 if the two paths disagreed on a leaf, 2 if CPUID is not supported
+     */
+    int run_cpuid_backend_benchmark( const cpuid_backend_benchmark_config_t &config, cpuid_backend_benchmark_report_t *report );
+} // namespace vac::modules::cpuid_analyzer
@@ -0,0 +1,218 @@
+#include "cpuid_core_sweep.hpp"
+
+#include "../../common/platform.hpp"
+#include "../../utils/vac_instrumentation.hpp"
+
+#if defined( __linux__ )
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <set>
+#include <thread>
+#include <tuple>
+
+namespace vac::modules::cpuid_analyzer {
+    namespace {
+        struct logical_processor_t {
+            uint16_t m_group  = { }; ///< Processor group
+            uint16_t m_number = { }; ///< Number within the group
+        };
+
+        std::vector< logical_processor_t > list_logical_processors( ) {
+            std::vector< logical_processor_t > processors;
+
+#if defined( _WIN32 )
+            // Active processors are numbered from 0 within each group
+            const WORD group_count = GetActiveProcessorGroupCount( );
+            for ( WORD group = 0; group < group_count; ++group ) {
+                const DWORD processor_count = GetActiveProcessorCount( group );
+                for ( DWORD number = 0; number < processor_count; ++number )
+                    processors.push_back( { group, static_cast< uint16_t >( number ) } );
+            }
+#elif defined( __linux__ )
+            // Only the CPUs this process may run on, pinning elsewhere would fail
+            cpu_set_t allowed;
+            CPU_ZERO( &allowed );
+            if ( sched_getaffinity( 0, sizeof( allowed ), &allowed ) )
+                return processors;
+
+            for ( int cpu = 0; cpu < CPU_SETSIZE; ++cpu ) {
+                if ( CPU_ISSET( cpu, &allowed ) )
+                    processors.push_back( { 0, static_cast< uint16_t >( cpu ) } );
+            }
+#endif
+
+            return processors;
+        }
+
+        bool pin_current_thread( const logical_processor_t &processor ) {
+#if defined( _WIN32 )
+            GROUP_AFFINITY affinity = { };
+            affinity.Group          = processor.m_group;
+            affinity.Mask           = static_cast< KAFFINITY >( 1 ) << processor.m_number;
+            return SetThreadGroupAffinity( GetCurrentThread( ), &affinity, nullptr ) != 0;
+#elif defined( __linux__ )
+            cpu_set_t affinity;
+            CPU_ZERO( &affinity );
+            CPU_SET( processor.m_number, &affinity );
+            return !pthread_setaffinity_np( pthread_self( ), sizeof( affinity ), &affinity );
+#else
+            static_cast< void >( processor );
+            return false;
+#endif
+        }
+
+        void read_core_topology( cpuid_core_view_t *core ) {
+            const cpuid_snapshot_t &snapshot = *core->m_snapshot;
+
+            // Prefer V2 extended topology (0x1F), then extended topology (0xB), then legacy leaf 1
+            const cpuid_leaf_t *topology = snapshot.find( 0x1F );
+            if ( !topology || !topology->m_ebx )
+                topology = snapshot.find( 0x0B );
+
+            uint32_t package_shift = 0;
+
+            if ( topology && topology->m_ebx ) {
+                core->m_x2apic_id = topology->m_edx;
+
+                // The last valid level's shift is the one below the package
+                for ( uint32_t subleaf = 0; const cpuid_leaf_t *level = snapshot.find( topology->m_leaf, subleaf ); ++subleaf ) {
+                    if ( !( ( level->m_ecx >> 8 ) & 0xFF ) )
+                        break;
+
+                    package_shift = level->m_eax & 0x1F;
+                }
+            } else if ( const cpuid_leaf_t *features = snapshot.find( 0x01 ) ) {
+                const uint32_t logical_per_package = ( features->m_ebx >> 16 ) & 0xFF;
+
+                core->m_x2apic_id = features->m_ebx >> 24;
+                package_shift     = std::bit_width( logical_per_package ? logical_per_package - 1 : 0u );
+            }
+
+            core->m_package_id = package_shift < 32 ? core->m_x2apic_id >> package_shift : 0;
+
+            // Leaf 0x1A is only meaningful on hybrid parts (leaf 7 EDX bit 15)
+            const cpuid_leaf_t *extended_features = snapshot.find( 0x07 );
+            const cpuid_leaf_t *hybrid            = snapshot.find( 0x1A );
+
+            if ( extended_features && ( extended_features->m_edx >> 15 & 1 ) && hybrid ) {
+                core->m_core_type    = static_cast< uint8_t >( hybrid->m_eax >> 24 );
+                core->m_native_model = hybrid->m_eax & 0xFFFFFF;
+            }
+        }
+
+        /**
+         * @brief Registers with the fields that identify the reporting processor cleared
+         */
+        std::tuple< uint32_t, uint32_t, uint32_t, uint32_t > comparable_registers( const cpuid_leaf_t &leaf ) {
+            cpuid_leaf_t masked = leaf;
+
+            switch ( leaf.m_leaf ) {
+            case 0x01:
+                masked.m_ebx &= 0x00FFFFFF; // Initial APIC ID
+                break;
+            case 0x0B:
+            case 0x1F:
+                masked.m_edx = 0; // x2APIC ID
+                break;
+            case 0x1A:
+                masked.m_eax = 0; // Core type, reported separately
+                break;
+            case 0x8000001E:
+                masked.m_eax = masked.m_ebx = masked.m_ecx = 0; // Extended APIC, compute unit and node IDs
+                break;
+            }
+
+            return { masked.m_eax, masked.m_ebx, masked.m_ecx, masked.m_edx };
+        }
+
+        void summarise_sweep( cpuid_core_sweep_t *sweep ) {
+            cpuid_topology_summary_t                   &summary = sweep->m_summary;
+            std::set< uint32_t >                        packages;
+            std::set< std::pair< uint32_t, uint32_t > > differing;
+
+            const cpuid_snapshot_t &reference = *sweep->m_cores.front( ).m_snapshot;
+
+            for ( const cpuid_core_view_t &core : sweep->m_cores ) {
+                packages.insert( core.m_package_id );
+                summary.m_performance_count += core.m_core_type == g_cpuid_core_type_core;
+                summary.m_efficiency_count  += core.m_core_type == g_cpuid_core_type_atom;
+
+                // Leaves missing on either side count as differing too
+                const cpuid_snapshot_t &snapshot = *core.m_snapshot;
+                for ( const cpuid_leaf_t &leaf : snapshot.leaves( ) ) {
+                    const cpuid_leaf_t *reference_leaf = reference.find( leaf.m_leaf, leaf.m_subleaf );
+                    if ( !reference_leaf || comparable_registers( *reference_leaf ) != comparable_registers( leaf ) )
+                        differing.emplace( leaf.m_leaf, leaf.m_subleaf );
+                }
+
+                for ( const cpuid_leaf_t &leaf : reference.leaves( ) ) {
+                    if ( !snapshot.find( leaf.m_leaf, leaf.m_subleaf ) )
+                        differing.emplace( leaf.m_leaf, leaf.m_subleaf );
+                }
+            }
+
+            summary.m_logical_count = static_cast< uint32_t >( sweep->m_cores.size( ) );
+            summary.m_package_count = static_cast< uint32_t >( packages.size( ) );
+            summary.m_hybrid        = summary.m_performance_count && summary.m_efficiency_count;
+
+            for ( const auto &[ leaf, subleaf ] : differing )
+                summary.m_differing_leaves.push_back( { leaf, subleaf } );
+        }
+    } // namespace
+
+    int sweep_cpuid_per_core( cpuid_core_sweep_t *sweep ) {
+        VAC_TRACE_FUNCTION( );
+
+        *sweep = { };
+
+        const std::vector< logical_processor_t > processors = list_logical_processors( );
+        if ( processors.empty( ) )
+            return 1;
+
+        sweep->m_cores.resize( processors.size( ) );
+
+        std::atomic< bool >        pin_failed = { false };
+        std::vector< std::thread > workers;
+        workers.reserve( processors.size( ) );
+
+        // One worker per processor, all sweeping at once; each only writes its own view
+        for ( size_t index = 0; index < processors.size( ); ++index ) {
+            workers.emplace_back( [ &, index ] {
+                if ( !pin_current_thread( processors[ index ] ) ) {
+                    pin_failed.store( true, std::memory_order_relaxed );
+                    return;
+                }
+
+                cpuid_core_view_t &core = sweep->m_cores[ index ];
+                core.m_group            = processors[ index ].m_group;
+                core.m_number           = processors[ index ].m_number;
+                core.m_snapshot         = cpuid_snapshot_t::capture( );
+            } );
+        }
+
+        for ( std::thread &worker : workers )
+            worker.join( );
+
+        if ( pin_failed.load( std::memory_order_relaxed ) ) {
+            sweep->m_cores.clear( );
+            return 2;
+        }
+
+        for ( cpuid_core_view_t &core : sweep->m_cores ) {
+            if ( !core.m_snapshot->supported( ) ) {
+                sweep->m_cores.clear( );
+                return 3;
+            }
+
+            read_core_topology( &core );
+        }
+
+        summarise_sweep( sweep );
+        return 0;
+    }
+} // namespace vac::modules::cpuid_analyzer
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "cpuid_snapshot.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace vac::modules::cpuid_analyzer {
+    constexpr uint8_t g_cpuid_core_type_unknown = 0x00; ///< Not a hybrid part, or leaf 0x1A not reported
+    constexpr uint8_t g_cpuid_core_type_atom    = 0x20; ///< Leaf 0x1A EAX[31:24]: efficiency core
+    constexpr uint8_t g_cpuid_core_type_core    = 0x40; ///< Leaf 0x1A EAX[31:24]: performance core
+
+    /**
+     * @brief CPUID view of one logical processor
+     */
+    struct cpuid_core_view_t {
+        uint16_t m_group        = { }; ///< Processor group (always 0 on Linux)
+        uint16_t m_number       = { }; ///< Processor number within the group (CPU number on Linux)
+        uint32_t m_x2apic_id    = { }; ///< Leaf 0x1F/0xB EDX, or the initial APIC ID from leaf 1 EBX[31:24]
+        uint32_t m_package_id   = { }; ///< m_x2apic_id above the package-level shift
+        uint8_t  m_core_type    = { }; ///< g_cpuid_core_type_*
+        uint32_t m_native_model = { }; ///< Leaf 0x1A EAX[23:0]
+
+        std::shared_ptr< const cpuid_snapshot_t > m_snapshot; ///< Every leaf/subleaf as seen from this processor
+    };
+
+    /**
+     * @brief (leaf, subleaf) pair
+     */
+    struct cpuid_leaf_key_t {
+        uint32_t m_leaf    = { }; ///< EAX input
+        uint32_t m_subleaf = { }; ///< ECX input
+    };
+
+    /**
+     * @brief Machine-wide summary of a per-core sweep
+     */
+    struct cpuid_topology_summary_t {
+        uint32_t m_logical_count     = { }; ///< Logical processors swept
+        uint32_t m_package_count     = { }; ///< Distinct package IDs (sockets)
+        uint32_t m_performance_count = { }; ///< Logical processors reporting g_cpuid_core_type_core
+        uint32_t m_efficiency_count  = { }; ///< Logical processors reporting g_cpuid_core_type_atom
+        bool     m_hybrid            = { }; ///< Both core types present
+
+        std::vector< cpuid_leaf_key_t > m_differing_leaves; ///< Leaves whose registers differ between processors, per-processor ID fields masked
+    };
+
+    /**
+     * @brief Result of sweep_cpuid_per_core()
+     */
+    struct cpuid_core_sweep_t {
+        std::vector< cpuid_core_view_t > m_cores;   ///< One view per logical processor, in group/number order
+        cpuid_topology_summary_t         m_summary; ///< Merged view
+    };
+
+    /**
+     * @brief Capture a CPUID snapshot on every logical processor at once
+     *
+     * Starts one thread per logical processor the process may run on, pins it there
+     * (SetThreadGroupAffinity on Windows, pthread_setaffinity_np on Linux) and lets it
+     * capture its own cpuid_snapshot_t. The snapshots are then merged into per-core
+     * views (APIC ID, package, P/E core type from leaf 0x1A) and a summary.
+     *
+     * @param sweep Receives the views, cleared first
+     * @return 0 on success
+     * @return 1 if no processor could be listed
+     * @return 2 if a worker could not be pinned to its processor
+     * @return 3 if CPUID is not supported
+     */
+    int sweep_cpuid_per_core( cpuid_core_sweep_t *sweep );
+} // namespace vac::modules::cpuid_analyzer
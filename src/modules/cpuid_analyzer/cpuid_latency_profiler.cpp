@@ -0,0 +1,161 @@
+#include "cpuid_latency_profiler.hpp"
+#include "cpuid_backend.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
+
+namespace vac::modules::cpuid_analyzer {
+    size_t cycle_histogram_t::bucket_index( const uint64_t value ) {
+        if ( value < g_exact_limit )
+            return static_cast< size_t >( value );
+
+        const uint32_t exponent = static_cast< uint32_t >( std::bit_width( value ) ) - 1;
+        if ( exponent > g_highest_exponent )
+            return g_bucket_count - 1;
+
+        const uint64_t sub_bucket = ( value >> ( exponent - g_sub_bucket_bits ) ) & ( ( 1u << g_sub_bucket_bits ) - 1 );
+        return g_exact_limit + ( exponent - 6 ) * ( 1u << g_sub_bucket_bits ) + static_cast< size_t >( sub_bucket );
+    }
+
+    uint64_t cycle_histogram_t::bucket_lower_bound( const size_t index ) {
+        if ( index < g_exact_limit )
+            return index;
+
+        const uint32_t exponent   = static_cast< uint32_t >( ( index - g_exact_limit ) >> g_sub_bucket_bits ) + 6;
+        const uint64_t sub_bucket = ( index - g_exact_limit ) & ( ( 1u << g_sub_bucket_bits ) - 1 );
+        return ( uint64_t{ 1 } << exponent ) | ( sub_bucket << ( exponent - g_sub_bucket_bits ) );
+    }
+
+    void cycle_histogram_t::record( const uint64_t value ) {
+        ++m_counts[ bucket_index( value ) ];
+        ++m_total;
+    }
+
+    uint64_t cycle_histogram_t::value_at_percentile( const double percentile ) const {
+        if ( !m_total )
+            return 0;
+
+        const double   clamped = std::clamp( percentile, 0.0, 100.0 );
+        const uint64_t rank    = std::max< uint64_t >( static_cast< uint64_t >( std::ceil( clamped / 100.0 * static_cast< double >( m_total ) ) ), 1 );
+
+        uint64_t seen = 0;
+        for ( size_t index = 0; index < g_bucket_count; ++index ) {
+            seen += m_counts[ index ];
+            if ( seen >= rank )
+                return bucket_lower_bound( index );
+        }
+
+        return bucket_lower_bound( g_bucket_count - 1 );
+    }
+
+    namespace {
+        /**
+         * @brief Running mean / variance (Welford), exact regardless of the histogram resolution
+         */
+        struct welford_accumulator_t {
+            uint64_t m_count = { }; ///< Samples seen
+            double   m_mean  = { }; ///< Running mean
+            double   m_m2    = { }; ///< Sum of squared distances from the mean
+
+            void add( const double value ) {
+                ++m_count;
+                const double delta  = value - m_mean;
+                m_mean             += delta / static_cast< double >( m_count );
+                m_m2               += delta * ( value - m_mean );
+            }
+
+            double variance( ) const { return m_count > 1 ? m_m2 / static_cast< double >( m_count - 1 ) : 0.0; }
+        };
+
+        bool has_rdtscp( ) {
+            uint32_t registers[ 4 ] = { 0x80000000, 0, 0, 0 };
+            execute_cpuid_native( registers );
+            if ( registers[ 0 ] < 0x80000001 )
+                return false;
+
+            uint32_t features[ 4 ] = { 0x80000001, 0, 0, 0 };
+            execute_cpuid_native( features );
+            return ( features[ 3 ] >> 27 ) & 1;
+        }
+
+        uint64_t measure_timer_overhead( const uint32_t sample_count, const bool use_rdtscp ) {
+            cycle_histogram_t histogram;
+
+            for ( uint32_t sample = 0; sample < sample_count; ++sample ) {
+                const uint64_t start = read_tsc_serialized_begin( );
+                const uint64_t end   = read_tsc_serialized_end( use_rdtscp );
+                histogram.record( end - start );
+            }
+
+            return histogram.value_at_percentile( 50.0 );
+        }
+
+        cpuid_latency_t profile_leaf( const uint32_t function_code, const uint32_t sub_function, const uint32_t sample_count,
+                                      const uint64_t timer_overhead, const bool use_rdtscp ) {
+            cpuid_latency_t       latency = { };
+            cycle_histogram_t     histogram;
+            welford_accumulator_t moments;
+
+            latency.m_function_code = function_code;
+            latency.m_sub_function  = sub_function;
+            latency.m_min           = std::numeric_limits< uint64_t >::max( );
+
+            // Warm the caches and, under a hypervisor, the exit path
+            for ( uint32_t warmup = 0; warmup < g_cpuid_profile_warmup_samples; ++warmup ) {
+                uint32_t registers[ 4 ] = { function_code, 0, sub_function, 0 };
+                execute_cpuid_native( registers );
+            }
+
+            for ( uint32_t sample = 0; sample < sample_count; ++sample ) {
+                uint32_t registers[ 4 ] = { function_code, 0, sub_function, 0 };
+
+                const uint64_t start = read_tsc_serialized_begin( );
+                execute_cpuid_native( registers );
+                const uint64_t end = read_tsc_serialized_end( use_rdtscp );
+
+                const uint64_t elapsed = end - start;
+                const uint64_t cycles  = elapsed > timer_overhead ? elapsed - timer_overhead : 0;
+
+                histogram.record( cycles );
+                moments.add( static_cast< double >( cycles ) );
+                latency.m_min = std::min( latency.m_min, cycles );
+                latency.m_max = std::max( latency.m_max, cycles );
+            }
+
+            // Bucket lower bounds can sit just below the fastest sample, keep percentiles within the observed range
+            latency.m_samples  = sample_count;
+            latency.m_median   = std::clamp( histogram.value_at_percentile( 50.0 ), latency.m_min, latency.m_max );
+            latency.m_p99      = std::clamp( histogram.value_at_percentile( 99.0 ), latency.m_min, latency.m_max );
+            latency.m_mean     = moments.m_mean;
+            latency.m_variance = moments.variance( );
+            return latency;
+        }
+    } // namespace
+
+    int profile_cpu_information( const common::cpuid_analysis_context_t *analysis_context, uint32_t sample_count,
+                                 cpuid_latency_report_t *report ) {
+        *report = { };
+
+        if ( !probe_cpuid_support( ) )
+            return 2;
+
+        if ( !sample_count )
+            sample_count = g_cpuid_profile_default_samples;
+
+        report->m_used_rdtscp    = has_rdtscp( );
+        report->m_timer_overhead = measure_timer_overhead( sample_count, report->m_used_rdtscp );
+
+        const uint32_t entry_count = std::min< uint32_t >( analysis_context->m_entry_count, 169 );
+        report->m_leaves.reserve( entry_count );
+
+        for ( uint32_t entry_index = 0; entry_index < entry_count; ++entry_index ) {
+            const common::cpu_info_entry_t &entry = analysis_context->m_cpu_entries[ entry_index ];
+            report->m_leaves.push_back(
+                profile_leaf( entry.m_function_code, entry.m_sub_function, sample_count, report->m_timer_overhead, report->m_used_rdtscp ) );
+        }
+
+        return 0;
+    }
+} // namespace vac::modules::cpuid_analyzer
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "../../common/types.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace vac::modules::cpuid_analyzer {
+    constexpr uint32_t g_cpuid_profile_default_samples = 1000; ///< Samples per leaf when the caller passes 0
+    constexpr uint32_t g_cpuid_profile_warmup_samples  = 8;    ///< Untimed executions before sampling a leaf
+
+    /**
+     * @brief Log-linear cycle histogram with a fixed bucket layout (HDR style)
+     *
+     * Values below 64 get one bucket each. Above that, every power of two is split into
+     * 32 linear sub-buckets, so any recorded value is known to within 1/32 (~3%) of
+     * itself. Values of 2^48 cycles and more land in the last bucket.
+     */
+    class cycle_histogram_t {
+    public:
+        static constexpr uint32_t g_exact_limit      = 64;                              ///< Values below this are exact
+        static constexpr uint32_t g_sub_bucket_bits  = 5;                               ///< log2 of sub-buckets per power of two
+        static constexpr uint32_t g_highest_exponent = 47;                              ///< Highest tracked power of two
+        static constexpr size_t   g_bucket_count     = g_exact_limit + ( g_highest_exponent - 5 ) * ( 1u << g_sub_bucket_bits );
+
+        void record( uint64_t value );
+
+        /**
+         * @brief Value at a percentile
+         * @param percentile 0..100
+         * @return Lower bound of the bucket holding the percentile, 0 if nothing was recorded
+         */
+        uint64_t value_at_percentile( double percentile ) const;
+
+        uint64_t total( ) const { return m_total; }
+
+        static size_t   bucket_index( uint64_t value );
+        static uint64_t bucket_lower_bound( size_t index );
+
+    private:
+        std::array< uint32_t, g_bucket_count > m_counts = { }; ///< Samples per bucket
+        uint64_t                               m_total  = { }; ///< Samples recorded
+    };
+
+    /**
+     * @brief Latency profile of one leaf/subleaf, in TSC cycles
+     */
+    struct cpuid_latency_t {
+        uint32_t m_function_code = { }; ///< EAX input
+        uint32_t m_sub_function  = { }; ///< ECX input
+        uint32_t m_samples       = { }; ///< Timed executions
+        uint64_t m_min           = { }; ///< Fastest sample
+        uint64_t m_median        = { }; ///< 50th percentile, histogram resolution
+        uint64_t m_p99           = { }; ///< 99th percentile, histogram resolution
+        uint64_t m_max           = { }; ///< Slowest sample
+        double   m_mean          = { }; ///< Exact mean
+        double   m_variance      = { }; ///< Exact sample variance (Welford)
+    };
+
+    /**
+     * @brief Result of profile_cpu_information()
+     */
+    struct cpuid_latency_report_t {
+        std::vector< cpuid_latency_t > m_leaves;                ///< m_leaves[ i ] profiles analysis_context->m_cpu_entries[ i ]
+        uint64_t                       m_timer_overhead = { }; ///< Median cycles of an empty timed region, already subtracted
+        bool                           m_used_rdtscp    = { }; ///< Regions closed with RDTSCP, otherwise LFENCE + RDTSC
+    };
+
+    /**
+     * @brief Time every leaf an analysis recorded
+     *
+     * For each cpu_info_entry_t in the context, executes CPUID with the same function code
+     * and sub-function sample_count times between serialized TSC reads (LFENCE/RDTSC to
+     * open, RDTSCP or LFENCE/RDTSC to close), after a short untimed warm-up. The median
+     * cost of an empty timed region is subtracted from every sample. Samples feed a
+     * cycle_histogram_t for the median and p99 and a Welford accumulator for the exact
+     * mean and variance. Larger sample counts give steadier percentiles at a linear cost
+     * in profiling time; under a hypervisor every sample is a VM exit.
+     *
+     * @param analysis_context Context filled by analyze_cpu_information()
+     * @param sample_count Samples per leaf, 0 for g_cpuid_profile_default_samples
+     * @param report Receives one profile per entry, cleared first
+     * @return 0 on success
+     * @return 2 if CPUID is not supported
+     */
+    int profile_cpu_information( const common::cpuid_analysis_context_t *analysis_context, uint32_t sample_count,
+                                 cpuid_latency_report_t *report );
+} // namespace vac::modules::cpuid_analyzer
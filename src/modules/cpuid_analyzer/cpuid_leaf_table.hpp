@@ -0,0 +1,91 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+namespace vac::modules::cpuid_analyzer {
+    constexpr uint32_t g_cpuid_standard_base   = 0x00000000; ///< Standard leaf range
+    constexpr uint32_t g_cpuid_hypervisor_base = 0x40000000; ///< Hypervisor leaf range
+    constexpr uint32_t g_cpuid_extended_base   = 0x80000000; ///< Extended leaf range
+    constexpr uint32_t g_cpuid_range_limit     = 0x100;      ///< Most leaves enumerated per range, guards bogus maxima
+    constexpr uint32_t g_cpuid_subleaf_limit   = 64;         ///< Most subleaves enumerated per leaf
+
+    /**
+     * @brief Leaf ranges enumerated in order, each bounded by the EAX of its base leaf
+     */
+    constexpr uint32_t g_cpuid_range_bases[] = { g_cpuid_standard_base, g_cpuid_hypervisor_base, g_cpuid_extended_base };
+
+    /**
+     * @brief How the subleaves of a leaf are enumerated
+     */
+    enum class cpuid_subleaf_rule_t : uint8_t {
+        single,           ///< Subleaf 0 only
+        until_type_zero,  ///< Cache parameters (4, 0x8000001D): stop at the first subleaf with EAX[4:0] == 0
+        max_in_eax,       ///< Subleaf 0 EAX holds the highest subleaf (7, 0x14, 0x17, 0x18)
+        until_level_zero, ///< Topology (0xB, 0x1F): stop at the first subleaf with ECX[15:8] == 0
+        xsave_components  ///< XSAVE (0xD): subleaves 0 and 1, then every component set in XCR0 | IA32_XSS
+    };
+
+    /**
+     * @brief Subleaf rule of one leaf
+     */
+    struct cpuid_leaf_rule_t {
+        uint32_t             m_leaf = { }; ///< EAX input
+        cpuid_subleaf_rule_t m_rule = { }; ///< Subleaf enumeration rule
+    };
+
+    /**
+     * @brief Leaves with subleaves, sorted by leaf; every other leaf is cpuid_subleaf_rule_t::single
+     */
+    constexpr cpuid_leaf_rule_t g_cpuid_leaf_rules[] = {
+        {       0x04,  cpuid_subleaf_rule_t::until_type_zero },
+        {       0x07,       cpuid_subleaf_rule_t::max_in_eax },
+        {       0x0B, cpuid_subleaf_rule_t::until_level_zero },
+        {       0x0D, cpuid_subleaf_rule_t::xsave_components },
+        {       0x14,       cpuid_subleaf_rule_t::max_in_eax },
+        {       0x17,       cpuid_subleaf_rule_t::max_in_eax },
+        {       0x18,       cpuid_subleaf_rule_t::max_in_eax },
+        {       0x1F, cpuid_subleaf_rule_t::until_level_zero },
+        { 0x8000001D,  cpuid_subleaf_rule_t::until_type_zero },
+    };
+
+    /**
+     * @brief Check that a table is strictly increasing in its key
+     */
+    template < typename entry_t, size_t entry_count, typename key_fn_t >
+    constexpr bool is_sorted_table( const entry_t ( &table )[ entry_count ], key_fn_t key ) {
+        for ( size_t index = 1; index < entry_count; ++index ) {
+            if ( !( key( table[ index - 1 ] ) < key( table[ index ] ) ) )
+                return false;
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief Binary search a sorted table by key
+     * @return Matching entry, nullptr if the key is not in the table
+     */
+    template < typename entry_t, size_t entry_count, typename key_fn_t >
+    constexpr const entry_t *find_sorted_entry( const entry_t ( &table )[ entry_count ], const uint32_t wanted, key_fn_t key ) {
+        const entry_t *entry = std::lower_bound( table, table + entry_count, wanted,
+                                                 [ & ]( const entry_t &candidate, const uint32_t value ) { return key( candidate ) < value; } );
+
+        return entry != table + entry_count && key( *entry ) == wanted ? entry : nullptr;
+    }
+
+    constexpr uint32_t cpuid_rule_key( const cpuid_leaf_rule_t &rule ) { return rule.m_leaf; }
+
+    static_assert( is_sorted_table( g_cpuid_leaf_rules, cpuid_rule_key ), "g_cpuid_leaf_rules must be sorted by leaf" );
+
+    /**
+     * @brief Subleaf rule of a leaf
+     */
+    constexpr cpuid_subleaf_rule_t cpuid_subleaf_rule( const uint32_t leaf ) {
+        const cpuid_leaf_rule_t *rule = find_sorted_entry( g_cpuid_leaf_rules, leaf, cpuid_rule_key );
+        return rule ? rule->m_rule : cpuid_subleaf_rule_t::single;
+    }
+
+    static_assert( cpuid_subleaf_rule( 0x0D ) == cpuid_subleaf_rule_t::xsave_components && cpuid_subleaf_rule( 0x0C ) == cpuid_subleaf_rule_t::single );
+} // namespace vac::modules::cpuid_analyzer
@@ -0,0 +1,146 @@
+#include "cpuid_snapshot.hpp"
+#include "cpuid_analyzer.hpp"
+#include "../../utils/vac_instrumentation.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <mutex>
+
+namespace vac::modules::cpuid_analyzer {
+    namespace {
+        std::mutex                                g_cpuid_snapshot_mutex; ///< Guards g_cpuid_snapshot
+        std::shared_ptr< const cpuid_snapshot_t > g_cpuid_snapshot;       ///< Published snapshot, null until first use
+
+        const cpuid_leaf_t *capture_leaf( const uint32_t leaf, const uint32_t subleaf, std::vector< cpuid_leaf_t > *leaves ) {
+            cpuid_leaf_t captured = { };
+            captured.m_leaf       = leaf;
+            captured.m_subleaf    = subleaf;
+            captured.m_eax        = leaf;
+            captured.m_ecx        = subleaf;
+
+            if ( !execute_cpuid_instruction( &captured.m_eax, &captured.m_ebx, &captured.m_ecx, &captured.m_edx ) )
+                return nullptr;
+
+            leaves->push_back( captured );
+            return &leaves->back( );
+        }
+
+        bool capture_subleaves( const uint32_t leaf, std::vector< cpuid_leaf_t > *leaves ) {
+            const cpuid_leaf_t *first = capture_leaf( leaf, 0, leaves );
+            if ( !first )
+                return false;
+
+            switch ( cpuid_subleaf_rule( leaf ) ) {
+            case cpuid_subleaf_rule_t::single:
+                return true;
+
+            case cpuid_subleaf_rule_t::max_in_eax: {
+                // Read before capturing more, the next push_back may move the vector
+                const uint32_t max_subleaf = std::min( first->m_eax, g_cpuid_subleaf_limit - 1 );
+                for ( uint32_t subleaf = 1; subleaf <= max_subleaf; ++subleaf ) {
+                    if ( !capture_leaf( leaf, subleaf, leaves ) )
+                        return false;
+                }
+                return true;
+            }
+
+            case cpuid_subleaf_rule_t::until_type_zero:
+            case cpuid_subleaf_rule_t::until_level_zero: {
+                // The terminating subleaf is kept, it is what the CPU reports for the end of the list
+                const bool by_level = cpuid_subleaf_rule( leaf ) == cpuid_subleaf_rule_t::until_level_zero;
+                for ( uint32_t subleaf = 1; subleaf < g_cpuid_subleaf_limit; ++subleaf ) {
+                    const cpuid_leaf_t &previous = leaves->back( );
+                    if ( by_level ? !( ( previous.m_ecx >> 8 ) & 0xFF ) : !( previous.m_eax & 0x1F ) )
+                        break;
+
+                    if ( !capture_leaf( leaf, subleaf, leaves ) )
+                        return false;
+                }
+                return true;
+            }
+
+            case cpuid_subleaf_rule_t::xsave_components: {
+                const cpuid_leaf_t *second = capture_leaf( leaf, 1, leaves );
+                if ( !second )
+                    return false;
+
+                // Subleaf 0 EDX:EAX covers XCR0 components, subleaf 1 EDX:ECX the IA32_XSS ones
+                first                     = second - 1;
+                const uint64_t components = ( static_cast< uint64_t >( first->m_edx ) << 32 | first->m_eax )
+                                          | ( static_cast< uint64_t >( second->m_edx ) << 32 | second->m_ecx );
+
+                for ( uint32_t subleaf = 2; subleaf < g_cpuid_subleaf_limit; ++subleaf ) {
+                    if ( ( components >> subleaf & 1 ) && !capture_leaf( leaf, subleaf, leaves ) )
+                        return false;
+                }
+                return true;
+            }
+            }
+
+            return true;
+        }
+
+        bool capture_range( const uint32_t base_leaf, std::vector< cpuid_leaf_t > *leaves ) {
+            const size_t base_index = leaves->size( );
+            if ( !capture_subleaves( base_leaf, leaves ) )
+                return false;
+
+            // The base leaf reports the highest leaf of its range; anything outside the
+            // range (e.g. no hypervisor present) leaves only the base leaf captured
+            const uint32_t max_leaf = ( *leaves )[ base_index ].m_eax;
+            if ( max_leaf <= base_leaf || max_leaf - base_leaf >= g_cpuid_range_limit )
+                return true;
+
+            for ( uint32_t leaf = base_leaf + 1; leaf <= max_leaf; ++leaf ) {
+                if ( !capture_subleaves( leaf, leaves ) )
+                    return false;
+            }
+
+            return true;
+        }
+    } // namespace
+
+    std::shared_ptr< const cpuid_snapshot_t > cpuid_snapshot_t::capture( ) {
+        VAC_TRACE_SCOPE( "cpuid_snapshot_t::capture" );
+
+        auto snapshot = std::make_shared< cpuid_snapshot_t >( );
+
+        snapshot->m_supported = std::all_of( std::begin( g_cpuid_range_bases ), std::end( g_cpuid_range_bases ),
+                                             [ & ]( const uint32_t base_leaf ) { return capture_range( base_leaf, &snapshot->m_leaves ); } );
+
+        if ( !snapshot->m_supported )
+            snapshot->m_leaves.clear( );
+
+        return snapshot;
+    }
+
+    const cpuid_leaf_t *cpuid_snapshot_t::find( const uint32_t leaf, const uint32_t subleaf ) const {
+        const auto entry = std::lower_bound( m_leaves.begin( ), m_leaves.end( ), cpuid_leaf_t{ leaf, subleaf },
+                                             []( const cpuid_leaf_t &left, const cpuid_leaf_t &right ) {
+                                                 return left.m_leaf != right.m_leaf ? left.m_leaf < right.m_leaf : left.m_subleaf < right.m_subleaf;
+                                             } );
+
+        if ( entry == m_leaves.end( ) || entry->m_leaf != leaf || entry->m_subleaf != subleaf )
+            return nullptr;
+
+        return &*entry;
+    }
+
+    std::shared_ptr< const cpuid_snapshot_t > current_cpuid_snapshot( ) {
+        std::lock_guard< std::mutex > snapshot_lock( g_cpuid_snapshot_mutex );
+
+        if ( !g_cpuid_snapshot )
+            g_cpuid_snapshot = cpuid_snapshot_t::capture( );
+
+        return g_cpuid_snapshot;
+    }
+
+    std::shared_ptr< const cpuid_snapshot_t > refresh_cpuid_snapshot( ) {
+        // Sweep outside the lock so readers are never held up by a capture
+        std::shared_ptr< const cpuid_snapshot_t > snapshot = cpuid_snapshot_t::capture( );
+
+        std::lock_guard< std::mutex > snapshot_lock( g_cpuid_snapshot_mutex );
+        g_cpuid_snapshot = snapshot;
+        return snapshot;
+    }
+} // namespace vac::modules::cpuid_analyzer
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "cpuid_leaf_table.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace vac::modules::cpuid_analyzer {
+    /**
+     * @brief Register values returned by one CPUID leaf/subleaf
+     */
+    struct cpuid_leaf_t {
+        uint32_t m_leaf    = { }; ///< EAX input
+        uint32_t m_subleaf = { }; ///< ECX input
+        uint32_t m_eax     = { }; ///< EAX output
+        uint32_t m_ebx     = { }; ///< EBX output
+        uint32_t m_ecx     = { }; ///< ECX output
+        uint32_t m_edx     = { }; ///< EDX output
+    };
+
+    /**
+     * @brief Immutable copy of every CPUID leaf the processor reports
+     *
+     * Captured in one sweep over g_cpuid_range_bases, each range bounded by the maximum
+     * leaf its base leaf returns, and over the subleaves g_cpuid_leaf_rules lists for
+     * each leaf. Leaves are kept sorted by (leaf, subleaf) so lookups are a binary
+     * search. Analyses read from a snapshot instead of executing CPUID, which is a
+     * VM exit under a hypervisor.
+     */
+    class cpuid_snapshot_t {
+    public:
+        /**
+         * @brief Execute CPUID over all ranges and build a new snapshot
+         * @return New snapshot, empty and unsupported if the CPU has no CPUID
+         */
+        static std::shared_ptr< const cpuid_snapshot_t > capture( );
+
+        /**
+         * @brief Look up a captured leaf
+         * @param leaf EAX input
+         * @param subleaf ECX input
+         * @return Captured registers, nullptr if the leaf was not captured
+         */
+        const cpuid_leaf_t *find( uint32_t leaf, uint32_t subleaf = 0 ) const;
+
+        const std::vector< cpuid_leaf_t > &leaves( ) const { return m_leaves; }
+        bool                               supported( ) const { return m_supported; }
+
+    private:
+        std::vector< cpuid_leaf_t > m_leaves;         ///< Sorted by (leaf, subleaf)
+        bool                        m_supported = { }; ///< false if CPUID could not be executed
+    };
+
+    /**
+     * @brief Process-wide snapshot, captured on first use
+     * @return Current snapshot; callers keep it alive for as long as they read from it
+     */
+    std::shared_ptr< const cpuid_snapshot_t > current_cpuid_snapshot( );
+
+    /**
+     * @brief Capture a new process-wide snapshot and publish it
+     *
+     * Readers holding the previous snapshot keep using it until they release it.
+     *
+     * @return The newly published snapshot
+     */
+    std::shared_ptr< const cpuid_snapshot_t > refresh_cpuid_snapshot( );
+} // namespace vac::modules::cpuid_analyzer
@@ -0,0 +1,52 @@
+#pragma once
+#include "../../common/types.hpp"
+
+#include <cstdint>
+
+/**
+ * @brief Key byte for the module's obfuscated strings, override per build with -DVAC_HANDLE_SCANNER_STRING_KEY=...
+ */
+#ifndef VAC_HANDLE_SCANNER_STRING_KEY
+#define VAC_HANDLE_SCANNER_STRING_KEY 0x5E
+#endif
+
+namespace vac::modules::handle_scanner {
+    /**
+     * @brief View over a system-wide handle snapshot
+     *
+     * Entries use the SystemHandleInformation layout regardless of where they came from,
+     * so the aggregation core never needs to know which source produced them.
+     * The memory behind m_handles is owned by the source until release() is called.
+     */
+    struct handle_snapshot_t {
+        const common::system_handle_t *m_handles      = { }; ///< First handle entry
+        uint32_t                       m_handle_count = { }; ///< Number of entries in m_handles
+        void                          *m_storage      = { }; ///< Source-private allocation backing the entries
+    };
+
+    /**
+     * @brief Producer of handle snapshots
+     *
+     * Implementations:
+     * - nt_handle_source_t: NtQuerySystemInformation(SystemHandleInformation), Windows only
+     * - proc_fd_handle_source_t: /proc/<pid>/fd walk via getdents64, Linux only
+     * - synthetic_handle_source_t: seeded generator for large reproducible snapshots
+     */
+    class handle_source_t {
+    public:
+        virtual ~handle_source_t( ) = default;
+
+        /**
+         * @brief Capture a snapshot of all handles in the system
+         * @param snapshot Receives the handle view on success
+         * @return 0 on success, NTSTATUS / errno style error code otherwise
+         */
+        virtual int acquire( handle_snapshot_t *snapshot ) = 0;
+
+        /**
+         * @brief Release storage obtained by a successful acquire()
+         * @param snapshot Snapshot previously filled by acquire()
+         */
+        virtual void release( handle_snapshot_t *snapshot ) = 0;
+    };
+} // namespace vac::modules::handle_scanner
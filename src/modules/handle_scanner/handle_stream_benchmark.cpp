@@ -0,0 +1,173 @@
+#include "handle_stream_benchmark.hpp"
+#include "handle_stream_parser.hpp"
+#include "system_handle_query.hpp"
+#include "../../utils/vac_clock_utils.hpp"
+#include "../../utils/vac_perf_counter.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace vac::modules::handle_scanner {
+    namespace {
+        constexpr size_t g_handle_info_words = g_handle_stream_max_processes * 4; ///< 32-byte slot per table entry
+
+        /**
+         * @brief Outputs of one walk
+         */
+        struct walk_output_t {
+            uint32_t m_process_id_table[ g_handle_stream_max_processes ] = { }; ///< Table after the walk
+            uint64_t m_handle_info[ g_handle_info_words ]                = { }; ///< handle_info_buffer after the walk
+            uint32_t m_unique_process_count                              = { }; ///< Lookup misses
+            uint32_t m_total_handle_count                                = { }; ///< Handles reported
+        };
+
+        /**
+         * @brief VAC's per-handle walk as shipped, a dependent read-modify-write of the slot per handle
+         */
+        void aggregate_per_handle( const handle_snapshot_t *snapshot, uint32_t *process_id_table, int max_process_count,
+                                   uint32_t *unique_process_count, uint32_t *total_handle_count, uint64_t *handle_info_buffer ) {
+            uint32_t *const handle_info_words = reinterpret_cast< uint32_t * >( handle_info_buffer );
+            int             hash_table_index  = 0;
+
+            *total_handle_count   = snapshot->m_handle_count;
+            *unique_process_count = 0;
+
+            for ( uint32_t handle_index = 0; handle_index < snapshot->m_handle_count; ++handle_index ) {
+                const common::system_handle_t &handle             = snapshot->m_handles[ handle_index ];
+                const uint32_t                 current_process_id = handle.m_process_id;
+
+                // Search for process ID in hash table, starting at the slot of the previous handle
+                int process_search_loop = 0;
+                for ( ; process_search_loop < max_process_count; ++process_search_loop ) {
+                    if ( process_id_table[ hash_table_index ] == current_process_id )
+                        break;
+
+                    if ( ++hash_table_index >= max_process_count )
+                        hash_table_index %= max_process_count;
+                }
+
+                if ( process_search_loop == max_process_count ) {
+                    // New process ID found
+                    ++( *unique_process_count );
+                    if ( max_process_count < 500 ) {
+                        process_id_table[ max_process_count ] = current_process_id;
+                        hash_table_index                      = max_process_count++;
+                    }
+                }
+
+                // Table full and PID unknown - handle is counted but not recorded
+                if ( process_id_table[ hash_table_index ] != current_process_id )
+                    continue;
+
+                const unsigned char object_type_index        = handle.m_object_type_index;
+                uint32_t            access_mask_calculation  = 0;
+                uint32_t            handle_flags_calculation = 0;
+
+                if ( object_type_index < 0x37 ) {
+                    if ( object_type_index >= 0x20 )
+                        handle_flags_calculation = 1u << ( object_type_index - 0x20 );
+                    else
+                        access_mask_calculation = 1u << object_type_index;
+                }
+
+                uint32_t *const handle_info_slot     = handle_info_words + 8 * hash_table_index;
+                const uint32_t  existing_handle_low  = handle_info_slot[ 0 ];
+                uint32_t        existing_handle_high = handle_info_slot[ 4 ];
+
+                // Top byte of the high dword is a handle counter saturating at 0xFF
+                if ( existing_handle_high < 0xFF000000 )
+                    existing_handle_high += 0x01000000;
+
+                handle_info_slot[ 0 ] = access_mask_calculation | existing_handle_low;
+                handle_info_slot[ 4 ] = handle_flags_calculation | existing_handle_high;
+            }
+        }
+
+        /**
+         * @brief Reset a walk's outputs to the table the benchmark starts from
+         */
+        void prepare_output( walk_output_t *output, const uint32_t known_process_count ) {
+            *output = { };
+
+            // Same PIDs the synthetic source hands out, in rank order
+            for ( uint32_t process_index = 0; process_index < known_process_count; ++process_index )
+                output->m_process_id_table[ process_index ] = 4 * ( process_index + 1 );
+        }
+
+        bool outputs_equal( const walk_output_t &lhs, const walk_output_t &rhs ) {
+            return lhs.m_unique_process_count == rhs.m_unique_process_count && lhs.m_total_handle_count == rhs.m_total_handle_count
+                && !memcmp( lhs.m_process_id_table, rhs.m_process_id_table, sizeof( lhs.m_process_id_table ) )
+                && !memcmp( lhs.m_handle_info, rhs.m_handle_info, sizeof( lhs.m_handle_info ) );
+        }
+    } // namespace
+
+    int run_handle_stream_benchmark( const handle_stream_benchmark_config_t &config, handle_stream_benchmark_report_t *report ) {
+        *report = { };
+
+        synthetic_handle_source_t source( config.m_snapshot );
+        handle_snapshot_t         snapshot;
+
+        const int acquire_result = source.acquire( &snapshot );
+        if ( acquire_result )
+            return acquire_result;
+
+        const utils::clock_source_t &clock = utils::precise_clock( );
+        utils::perf_counter_t        cache_misses( utils::perf_event_t::cache_misses );
+
+        const uint32_t known_process_count = std::min< uint32_t >( config.m_known_process_count, g_handle_stream_max_processes );
+        const uint32_t iterations          = std::max< uint32_t >( config.m_iterations, 1 );
+
+        walk_output_t per_handle_output;
+        walk_output_t streamed_output;
+
+        uint64_t best_per_handle_ns     = std::numeric_limits< uint64_t >::max( );
+        uint64_t best_streamed_ns       = std::numeric_limits< uint64_t >::max( );
+        uint64_t best_per_handle_misses = std::numeric_limits< uint64_t >::max( );
+        uint64_t best_streamed_misses   = std::numeric_limits< uint64_t >::max( );
+
+        for ( uint32_t iteration = 0; iteration < iterations; ++iteration ) {
+            prepare_output( &per_handle_output, known_process_count );
+            prepare_output( &streamed_output, known_process_count );
+
+            cache_misses.start( );
+            uint64_t started_at = clock.now_ns( );
+
+            aggregate_per_handle( &snapshot, per_handle_output.m_process_id_table, static_cast< int >( known_process_count ),
+                                  &per_handle_output.m_unique_process_count, &per_handle_output.m_total_handle_count,
+                                  per_handle_output.m_handle_info );
+
+            best_per_handle_ns     = std::min( best_per_handle_ns, clock.now_ns( ) - started_at );
+            best_per_handle_misses = std::min( best_per_handle_misses, cache_misses.stop( ) );
+
+            cache_misses.start( );
+            started_at = clock.now_ns( );
+
+            aggregate_handle_snapshot( &snapshot, streamed_output.m_process_id_table, static_cast< int >( known_process_count ),
+                                       &streamed_output.m_unique_process_count, &streamed_output.m_total_handle_count,
+                                       streamed_output.m_handle_info );
+
+            best_streamed_ns     = std::min( best_streamed_ns, clock.now_ns( ) - started_at );
+            best_streamed_misses = std::min( best_streamed_misses, cache_misses.stop( ) );
+
+            if ( !outputs_equal( per_handle_output, streamed_output ) )
+                ++report->m_mismatches;
+        }
+
+        source.release( &snapshot );
+
+        const double handle_count = static_cast< double >( std::max< uint32_t >( config.m_snapshot.m_handle_count, 1 ) );
+
+        report->m_handle_count       = config.m_snapshot.m_handle_count;
+        report->m_per_handle_ns      = static_cast< double >( best_per_handle_ns ) / handle_count;
+        report->m_streamed_ns        = static_cast< double >( best_streamed_ns ) / handle_count;
+        report->m_counters_available = cache_misses.available( );
+
+        if ( report->m_counters_available ) {
+            report->m_per_handle_misses_per_handle = static_cast< double >( best_per_handle_misses ) / handle_count;
+            report->m_streamed_misses_per_handle   = static_cast< double >( best_streamed_misses ) / handle_count;
+        }
+
+        return report->m_mismatches ? 1 : 0;
+    }
+} // namespace vac::modules::handle_scanner
@@ -0,0 +1,45 @@
+#pragma once
+#include "synthetic_handle_source.hpp"
+
+#include <cstdint>
+
+namespace vac::modules::handle_scanner {
+    /**
+     * @brief Parameters of run_handle_stream_benchmark()
+     */
+    struct handle_stream_benchmark_config_t {
+        synthetic_handle_options_t m_snapshot;                ///< Snapshot both walks aggregate
+        uint32_t                   m_iterations          = 5; ///< Timed runs per walk, the fastest is reported
+        uint32_t                   m_known_process_count = 0; ///< PIDs of the snapshot already in the table before the walk, at most 500
+    };
+
+    /**
+     * @brief Results of run_handle_stream_benchmark()
+     *
+     * Cache misses are last-level misses in user mode and only meaningful when
+     * m_counters_available is set; both walks run on the calling thread.
+     */
+    struct handle_stream_benchmark_report_t {
+        uint32_t m_handle_count                 = { }; ///< Handles in the snapshot
+        double   m_per_handle_ns                = { }; ///< Per-handle walk, nanoseconds per handle
+        double   m_streamed_ns                  = { }; ///< Block-streamed walk, nanoseconds per handle
+        bool     m_counters_available           = { }; ///< Hardware cache-miss counter could be opened
+        double   m_per_handle_misses_per_handle = { }; ///< Per-handle walk, cache misses per handle
+        double   m_streamed_misses_per_handle   = { }; ///< Block-streamed walk, cache misses per handle
+        uint32_t m_mismatches                   = { }; ///< Iterations where the two walks produced different outputs
+    };
+
+    /**
+     * @brief Compare aggregate_handle_snapshot() with VAC's original per-handle walk
+     *
+     * Both walks aggregate the same synthetic snapshot from an identical process_id_table
+     * into their own handle_info_buffer; every output (table, counters, slots) is compared
+     * after each iteration. Timing and cache misses are taken over the aggregation alone,
+     * the snapshot is generated before the first timed run.
+     *
+     * @param config Snapshot shape and run count
+     * @param report Receives the per-handle costs
+     * @return 0 if both walks agreed on every iteration, 1 otherwise
+     */
+    int run_handle_stream_benchmark( const handle_stream_benchmark_config_t &config, handle_stream_benchmark_report_t *report );
+} // namespace vac::modules::handle_scanner
@@ -0,0 +1,164 @@
+#include "handle_stream_parser.hpp"
+#include "../../utils/vac_instrumentation.hpp"
+
+#include <algorithm>
+#include <vector>
+
+#if defined( _M_IX86 ) || defined( _M_X64 ) || defined( __i386__ ) || defined( __x86_64__ )
+#include <xmmintrin.h>
+#define VAC_PREFETCH_WRITE( address ) _mm_prefetch( reinterpret_cast< const char * >( address ), _MM_HINT_T0 )
+#else
+#define VAC_PREFETCH_WRITE( address ) __builtin_prefetch( address, 1 )
+#endif
+
+namespace vac::modules::handle_scanner {
+    namespace {
+        constexpr uint32_t g_skipped_handle = 0xFFFFFFFF;
+
+        /**
+         * @brief PID lookup state carried from one block to the next
+         */
+        struct resolve_state_t {
+            uint32_t *m_process_id_table     = { }; ///< Caller's PID table
+            int       m_process_count        = { }; ///< Valid entries in the table
+            int       m_hash_table_index     = { }; ///< Slot of the previous handle, first probe for the next one
+            uint32_t *m_unique_process_count = { }; ///< Lookup miss counter
+        };
+
+        /**
+         * @brief Resolve one block of handles into packed (slot << 8 | object type) words
+         *
+         * Reads the snapshot strictly sequentially and prefetches the summary line of
+         * every slot change, so the later apply pass hits cache.
+         */
+        void resolve_block( resolve_state_t *state, const common::system_handle_t *handles, const size_t handle_count,
+                            uint32_t *packed_handles, process_handle_summary_t *summaries ) {
+            uint32_t *const process_id_table = state->m_process_id_table;
+            int             process_count    = state->m_process_count;
+            int             hash_table_index = state->m_hash_table_index;
+            int             prefetched_slot  = -1;
+
+            for ( size_t handle_index = 0; handle_index < handle_count; ++handle_index ) {
+                const uint32_t current_process_id = handles[ handle_index ].m_process_id;
+
+                // Search for process ID in hash table, starting at the slot of the previous handle
+                int process_search_loop = 0;
+                for ( ; process_search_loop < process_count; ++process_search_loop ) {
+                    if ( process_id_table[ hash_table_index ] == current_process_id )
+                        break;
+
+                    if ( ++hash_table_index >= process_count )
+                        hash_table_index %= process_count;
+                }
+
+                if ( process_search_loop == process_count ) {
+                    // New process ID found
+                    ++( *state->m_unique_process_count );
+                    if ( process_count < g_handle_stream_max_processes ) {
+                        process_id_table[ process_count ] = current_process_id;
+                        hash_table_index                  = process_count++;
+                    }
+                }
+
+                // Table full and PID unknown - handle is counted but not recorded
+                if ( process_id_table[ hash_table_index ] != current_process_id ) {
+                    packed_handles[ handle_index ] = g_skipped_handle;
+                    continue;
+                }
+
+                if ( hash_table_index != prefetched_slot ) {
+                    VAC_PREFETCH_WRITE( &summaries[ hash_table_index ] );
+                    prefetched_slot = hash_table_index;
+                }
+
+                packed_handles[ handle_index ]
+                    = ( static_cast< uint32_t >( hash_table_index ) << 8 ) | handles[ handle_index ].m_object_type_index;
+            }
+
+            state->m_process_count    = process_count;
+            state->m_hash_table_index = hash_table_index;
+        }
+
+        /**
+         * @brief Apply a resolved block to the per-process summaries
+         */
+        void apply_block( const uint32_t *packed_handles, const size_t handle_count, process_handle_summary_t *summaries ) {
+            for ( size_t handle_index = 0; handle_index < handle_count; ++handle_index ) {
+                const uint32_t packed_handle = packed_handles[ handle_index ];
+                if ( packed_handle == g_skipped_handle )
+                    continue;
+
+                const uint32_t            object_type_index = packed_handle & 0xFF;
+                process_handle_summary_t &summary           = summaries[ packed_handle >> 8 ];
+
+                ++summary.m_handle_count;
+                summary.m_type_mask |= object_type_index < 0x37 ? 1ULL << object_type_index : 0;
+            }
+        }
+    } // namespace
+
+    int stream_handle_snapshot( const handle_snapshot_t *snapshot, uint32_t *process_id_table, const int max_process_count,
+                                uint32_t *unique_process_count, process_handle_summary_t *summaries ) {
+        VAC_TRACE_FUNCTION( );
+
+        constexpr size_t block_handle_count = g_handle_stream_block_bytes / sizeof( common::system_handle_t );
+
+        const common::system_handle_t *handles      = snapshot->m_handles;
+        const size_t                   handle_count = snapshot->m_handle_count;
+
+        resolve_state_t state;
+        state.m_process_id_table     = process_id_table;
+        state.m_process_count        = max_process_count;
+        state.m_unique_process_count = unique_process_count;
+
+        *unique_process_count = 0;
+
+        if ( handle_count ) {
+            // Double-buffered packed slots: block N+1 is resolved (and its lines prefetched) before block N is applied
+            std::vector< uint32_t > packed_blocks[ 2 ];
+            packed_blocks[ 0 ].resize( std::min( block_handle_count, handle_count ) );
+            packed_blocks[ 1 ].resize( packed_blocks[ 0 ].size( ) );
+
+            size_t current_length = std::min( block_handle_count, handle_count );
+            resolve_block( &state, handles, current_length, packed_blocks[ 0 ].data( ), summaries );
+
+            for ( size_t block_start = 0, block_index = 0; block_start < handle_count; ++block_index ) {
+                const size_t next_start  = block_start + current_length;
+                const size_t next_length = next_start < handle_count ? std::min( block_handle_count, handle_count - next_start ) : 0;
+
+                if ( next_length )
+                    resolve_block( &state, handles + next_start, next_length, packed_blocks[ ( block_index + 1 ) & 1 ].data( ), summaries );
+
+                apply_block( packed_blocks[ block_index & 1 ].data( ), current_length, summaries );
+
+                block_start    = next_start;
+                current_length = next_length;
+            }
+        }
+
+        for ( int process_index = 0; process_index < state.m_process_count; ++process_index )
+            summaries[ process_index ].m_process_id = process_id_table[ process_index ];
+
+        return state.m_process_count;
+    }
+
+    void fold_handle_summaries( const process_handle_summary_t *summaries, const int process_count, uint64_t *handle_info_buffer ) {
+        uint32_t *const handle_info_words = reinterpret_cast< uint32_t * >( handle_info_buffer );
+
+        for ( int process_index = 0; process_index < process_count; ++process_index ) {
+            const process_handle_summary_t &summary = summaries[ process_index ];
+            if ( !summary.m_handle_count )
+                continue;
+
+            uint32_t *const handle_info_slot = handle_info_words + 8 * process_index;
+
+            // Top byte of the high dword is a handle counter saturating at 0xFF
+            const uint32_t existing_handle_high = handle_info_slot[ 4 ];
+            const uint32_t handle_counter       = std::min< uint32_t >( ( existing_handle_high >> 24 ) + summary.m_handle_count, 0xFF );
+
+            handle_info_slot[ 0 ] |= static_cast< uint32_t >( summary.m_type_mask );
+            handle_info_slot[ 4 ]  = ( handle_counter << 24 ) | ( existing_handle_high & 0x00FFFFFF )
+                                  | static_cast< uint32_t >( summary.m_type_mask >> 32 );
+        }
+    }
+} // namespace vac::modules::handle_scanner
@@ -0,0 +1,66 @@
+#pragma once
+#include "handle_source.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace vac::modules::handle_scanner {
+    /**
+     * @brief Snapshot bytes parsed per block
+     *
+     * Sized so a block plus its packed slot array and the per-process summaries
+     * stay resident in a 256 KB L2 while the block is resolved and then applied.
+     */
+    constexpr size_t g_handle_stream_block_bytes = 128 * 1024;
+
+    /**
+     * @brief Maximum number of processes tracked by the aggregation (process_id_table capacity)
+     */
+    constexpr int g_handle_stream_max_processes = 500;
+
+    /**
+     * @brief Per-process handle aggregate, one cache line each
+     *
+     * Replaces the read-modify-write of the legacy 32-byte handle_info_buffer slot
+     * per handle; results are folded into the legacy layout once at the end.
+     */
+    struct alignas( 64 ) process_handle_summary_t {
+        uint32_t m_process_id    = { }; ///< +0: Owning process ID
+        uint32_t m_handle_count  = { }; ///< +4: Handles attributed to this process (not saturated)
+        uint64_t m_type_mask     = { }; ///< +8: Bit per object type index seen (types 0x00-0x36)
+        uint8_t  m_padding[ 48 ] = { }; ///< +16: Pad to a full cache line
+    };
+
+    static_assert( sizeof( process_handle_summary_t ) == 64, "process_handle_summary_t must occupy exactly one cache line" );
+
+    /**
+     * @brief Stream a handle snapshot into per-process summaries
+     *
+     * The snapshot is processed in g_handle_stream_block_bytes blocks. Each block is
+     * first resolved sequentially (PID lookup with the same rolling-probe semantics as
+     * the original walk) into a compact slot/type array while the summary lines of
+     * that block are prefetched; the previous block is applied meanwhile, so its
+     * destination lines are already in cache when they are written.
+     *
+     * @param snapshot Handle entries to parse
+     * @param process_id_table Hash table for process ID lookups (max 500 entries)
+     * @param max_process_count Number of valid entries in process_id_table
+     * @param unique_process_count Output: number of PID lookups that missed the table
+     * @param summaries Output: max( max_process_count, g_handle_stream_max_processes ) zeroed summaries, indexed like process_id_table
+     * @return Number of entries in process_id_table after the walk
+     */
+    int stream_handle_snapshot( const handle_snapshot_t *snapshot, uint32_t *process_id_table, int max_process_count,
+                                uint32_t *unique_process_count, process_handle_summary_t *summaries );
+
+    /**
+     * @brief Fold per-process summaries into the legacy 32-byte handle_info_buffer slots
+     *
+     * Equivalent to applying every handle individually: type bits are OR'd in and the
+     * top byte of dword 4 is advanced by the handle count, saturating at 0xFF.
+     *
+     * @param summaries Summaries produced by stream_handle_snapshot()
+     * @param process_count Number of summaries to fold
+     * @param handle_info_buffer Legacy per-process slots to update
+     */
+    void fold_handle_summaries( const process_handle_summary_t *summaries, int process_count, uint64_t *handle_info_buffer );
+} // namespace vac::modules::handle_scanner
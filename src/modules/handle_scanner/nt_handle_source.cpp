@@ -0,0 +1,73 @@
+#include "nt_handle_source.hpp"
+
+#if defined( _WIN32 )
+#include "../../utils/vac_instrumentation.hpp"
+#include "../../utils/vac_obfuscated_string.hpp"
+
+#include <windows.h>
+
+namespace vac::modules::handle_scanner {
+    int nt_handle_source_t::acquire( handle_snapshot_t *snapshot ) {
+        VAC_TRACE_SCOPE( "nt_handle_source_t::acquire" );
+
+        // Get NtQuerySystemInformation function pointer, names decoded once per process
+        const HMODULE ntdll = GetModuleHandleA( VAC_OBFUSCATED_STRING( "ntdll.dll", VAC_HANDLE_SCANNER_STRING_KEY ) ); // dword_10007C6C
+        NTSTATUS( __stdcall * nt_query_system_information )( int, int, int, uint32_t )
+            = reinterpret_cast< NTSTATUS( __stdcall * )( int, int, int, uint32_t ) >(
+                GetProcAddress( ntdll, VAC_OBFUSCATED_STRING( "NtQuerySystemInformation", VAC_HANDLE_SCANNER_STRING_KEY ) ) );
+
+        if ( nt_query_system_information ) {
+            uint32_t *system_handle_buffer = nullptr;
+            int       buffer_size          = 0;
+
+            // Progressive buffer allocation loop
+            while ( true ) {
+                buffer_size += 0x100000;
+
+                // Free previous buffer if exists
+                if ( system_handle_buffer )
+                    VirtualFree( system_handle_buffer, 0, MEM_RELEASE );
+
+                // Allocate new buffer using VirtualAlloc
+                system_handle_buffer
+                    = static_cast< uint32_t * >( VirtualAlloc( nullptr, buffer_size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE ) );
+
+                if ( !system_handle_buffer )
+                    break;
+
+                // Query system handle information
+                VAC_COUNT_SYSCALL( );
+                const int query_result = nt_query_system_information( 16, // SystemHandleInformation
+                                                                      reinterpret_cast< int >( system_handle_buffer ), buffer_size, 0 );
+
+                if ( query_result == 0xC0000004 ) // STATUS_INFO_LENGTH_MISMATCH
+                    continue;
+
+                if ( query_result ) {
+                    // Query failed with different error
+                    VirtualFree( system_handle_buffer, 0, MEM_RELEASE );
+                    return query_result;
+                }
+
+                // Success - hand the buffer over to the caller until release()
+                const auto *handle_information = reinterpret_cast< const common::system_handle_information_t * >( system_handle_buffer );
+
+                snapshot->m_handles      = handle_information->m_handles;
+                snapshot->m_handle_count = handle_information->m_handle_count;
+                snapshot->m_storage      = system_handle_buffer;
+                return 0;
+            }
+        }
+
+        // Return GetLastError() if we reach here
+        return GetLastError( );
+    }
+
+    void nt_handle_source_t::release( handle_snapshot_t *snapshot ) {
+        if ( snapshot->m_storage )
+            VirtualFree( snapshot->m_storage, 0, MEM_RELEASE );
+
+        *snapshot = { };
+    }
+} // namespace vac::modules::handle_scanner
+#endif
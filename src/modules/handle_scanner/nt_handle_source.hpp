@@ -0,0 +1,30 @@
+#pragma once
+#include "handle_source.hpp"
+
+#if defined( _WIN32 )
+namespace vac::modules::handle_scanner {
+    /**
+     * @brief Handle source backed by NtQuerySystemInformation(SystemHandleInformation)
+     *
+     * This is the exact reverse of VAC's handle enumeration query.
+     * Resolves the API through a name obfuscated with VAC_HANDLE_SCANNER_STRING_KEY
+     * (VAC uses XOR 0x5E) and grows the
+     * VirtualAlloc buffer in 1 MB steps until STATUS_INFO_LENGTH_MISMATCH stops.
+     */
+    class nt_handle_source_t final : public handle_source_t {
+    public:
+        /**
+         * @brief Query the system handle table
+         * @param snapshot Receives a view into the VirtualAlloc'd query buffer
+         * @return 0 on success, NTSTATUS of the failed query, or GetLastError() value
+         */
+        int acquire( handle_snapshot_t *snapshot ) override;
+
+        /**
+         * @brief Free the query buffer with VirtualFree
+         * @param snapshot Snapshot previously filled by acquire()
+         */
+        void release( handle_snapshot_t *snapshot ) override;
+    };
+} // namespace vac::modules::handle_scanner
+#endif
@@ -0,0 +1,158 @@
+#include "proc_fd_handle_source.hpp"
+
+#if defined( __linux__ )
+#include "../../utils/vac_dirent_utils.hpp"
+#include "../../utils/vac_instrumentation.hpp"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace vac::modules::handle_scanner {
+    namespace {
+        /**
+         * @brief Parse a purely numeric directory entry name
+         * @return true if name consisted only of decimal digits
+         */
+        bool parse_decimal_name( const char *name, uint32_t *value ) {
+            if ( !*name )
+                return false;
+
+            uint32_t result = 0;
+            for ( ; *name; ++name ) {
+                if ( static_cast< unsigned char >( *name - '0' ) > 9u )
+                    return false;
+                result = result * 10 + static_cast< uint32_t >( *name - '0' );
+            }
+
+            *value = result;
+            return true;
+        }
+
+        bool starts_with( const char *text, const size_t length, const char *prefix ) {
+            const size_t prefix_length = strlen( prefix );
+            return length >= prefix_length && memcmp( text, prefix, prefix_length ) == 0;
+        }
+    } // namespace
+
+    proc_fd_handle_source_t::proc_fd_handle_source_t( const bool resolve_types ) : m_resolve_types( resolve_types ) {
+        m_dirent_buffer.resize( utils::g_dirent_buffer_size );
+    }
+
+    proc_fd_object_type_t proc_fd_handle_source_t::classify_link( const char *link_target, const size_t length ) {
+        if ( !length )
+            return proc_fd_object_type_t::unknown;
+
+        if ( link_target[ 0 ] == '/' )
+            return starts_with( link_target, length, "/dev/" ) ? proc_fd_object_type_t::device : proc_fd_object_type_t::file;
+
+        if ( starts_with( link_target, length, "socket:" ) )
+            return proc_fd_object_type_t::socket;
+
+        if ( starts_with( link_target, length, "pipe:" ) )
+            return proc_fd_object_type_t::pipe;
+
+        if ( starts_with( link_target, length, "anon_inode:" ) ) {
+            if ( starts_with( link_target, length, "anon_inode:[eventfd]" ) )
+                return proc_fd_object_type_t::event;
+            if ( starts_with( link_target, length, "anon_inode:[timerfd]" ) )
+                return proc_fd_object_type_t::timer;
+            if ( starts_with( link_target, length, "anon_inode:[signalfd]" ) )
+                return proc_fd_object_type_t::signal;
+            if ( starts_with( link_target, length, "anon_inode:[eventpoll]" ) || starts_with( link_target, length, "anon_inode:[io_uring]" ) )
+                return proc_fd_object_type_t::io_completion;
+            return proc_fd_object_type_t::anon_inode;
+        }
+
+        return proc_fd_object_type_t::unknown;
+    }
+
+    void proc_fd_handle_source_t::collect_process( const int proc_fd, const uint32_t process_id ) {
+        char fd_directory_path[ 32 ];
+        snprintf( fd_directory_path, sizeof( fd_directory_path ), "%u/fd", process_id );
+
+        VAC_COUNT_SYSCALL( );
+        const int fd_directory = openat( proc_fd, fd_directory_path, O_RDONLY | O_DIRECTORY | O_CLOEXEC );
+        if ( fd_directory < 0 )
+            return; // Exited or access denied
+
+        // Descriptor names are collected first so the shared dirent buffer is not reused while resolving links
+        std::vector< uint32_t > descriptors;
+        utils::for_each_directory_entry( fd_directory, m_dirent_buffer, [ & ]( const char *name ) {
+            uint32_t descriptor = 0;
+            if ( parse_decimal_name( name, &descriptor ) )
+                descriptors.push_back( descriptor );
+            return false;
+        } );
+
+        for ( const uint32_t descriptor : descriptors ) {
+            proc_fd_object_type_t object_type = proc_fd_object_type_t::file;
+
+            if ( m_resolve_types ) {
+                char descriptor_name[ 16 ];
+                char link_target[ 64 ];
+                snprintf( descriptor_name, sizeof( descriptor_name ), "%u", descriptor );
+
+                // Only the prefix matters for classification, so a truncated link is fine
+                VAC_COUNT_SYSCALL( );
+                const ssize_t link_length = readlinkat( fd_directory, descriptor_name, link_target, sizeof( link_target ) );
+                object_type = link_length > 0 ? classify_link( link_target, static_cast< size_t >( link_length ) )
+                                              : proc_fd_object_type_t::unknown;
+            }
+
+            common::system_handle_t handle;
+            handle.m_process_id        = process_id;
+            handle.m_object_type_index = static_cast< UCHAR >( object_type );
+            handle.m_handle_value      = static_cast< USHORT >( descriptor );
+            m_handles.push_back( handle );
+        }
+
+        VAC_COUNT_SYSCALL( );
+        close( fd_directory );
+    }
+
+    int proc_fd_handle_source_t::acquire( handle_snapshot_t *snapshot ) {
+        VAC_TRACE_SCOPE( "proc_fd_handle_source_t::acquire" );
+
+        m_handles.clear( );
+
+        VAC_COUNT_SYSCALL( );
+        const int proc_fd = open( "/proc", O_RDONLY | O_DIRECTORY | O_CLOEXEC );
+        if ( proc_fd < 0 )
+            return errno;
+
+        // Collect PIDs first, then walk each process (the dirent buffer is shared)
+        std::vector< uint32_t > process_ids;
+        const int               enum_result = utils::for_each_directory_entry( proc_fd, m_dirent_buffer, [ & ]( const char *name ) {
+            uint32_t process_id = 0;
+            if ( parse_decimal_name( name, &process_id ) )
+                process_ids.push_back( process_id );
+            return false;
+        } );
+
+        if ( enum_result ) {
+            VAC_COUNT_SYSCALL( );
+            close( proc_fd );
+            return enum_result;
+        }
+
+        for ( const uint32_t process_id : process_ids )
+            collect_process( proc_fd, process_id );
+
+        VAC_COUNT_SYSCALL( );
+        close( proc_fd );
+
+        snapshot->m_handles      = m_handles.data( );
+        snapshot->m_handle_count = static_cast< uint32_t >( m_handles.size( ) );
+        snapshot->m_storage      = nullptr;
+        return 0;
+    }
+
+    void proc_fd_handle_source_t::release( handle_snapshot_t *snapshot ) {
+        m_handles.clear( );
+        *snapshot = { };
+    }
+} // namespace vac::modules::handle_scanner
+#endif
@@ -0,0 +1,73 @@
+#pragma once
+#include "handle_source.hpp"
+
+#if defined( __linux__ )
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace vac::modules::handle_scanner {
+    /**
+     * @brief Object type indices assigned to Linux file descriptors
+     *
+     * Stand-ins for the Windows object type indices reported by SystemHandleInformation.
+     * Values are spread over both halves of the 0x37-bit type mask so the low and high
+     * words of the per-process aggregate are both exercised.
+     */
+    enum class proc_fd_object_type_t : uint8_t {
+        event         = 0x10, ///< anon_inode:[eventfd]
+        timer         = 0x13, ///< anon_inode:[timerfd]
+        signal        = 0x15, ///< anon_inode:[signalfd]
+        file          = 0x25, ///< Regular file or directory path
+        device        = 0x26, ///< Path under /dev/
+        pipe          = 0x28, ///< pipe:[inode]
+        socket        = 0x29, ///< socket:[inode]
+        io_completion = 0x2B, ///< anon_inode:[eventpoll] / [io_uring]
+        anon_inode    = 0x30, ///< Any other anon_inode:[...]
+        unknown       = 0x36  ///< Unreadable or unrecognised link
+    };
+
+    /**
+     * @brief Handle source that walks /proc/<pid>/fd for every process
+     *
+     * Directories are read with raw getdents64 into a reusable buffer, and every
+     * descriptor link is resolved with readlinkat() to pick its object type.
+     * Processes whose fd directory cannot be opened (EACCES, exited) are skipped.
+     */
+    class proc_fd_handle_source_t final : public handle_source_t {
+    public:
+        /**
+         * @param resolve_types Resolve each descriptor with readlinkat(); when false every fd is reported as file
+         */
+        explicit proc_fd_handle_source_t( bool resolve_types = true );
+
+        /**
+         * @brief Walk /proc and collect one entry per open descriptor
+         * @param snapshot Receives a view into the source-owned entry array
+         * @return 0 on success, errno if /proc itself cannot be read
+         */
+        int acquire( handle_snapshot_t *snapshot ) override;
+
+        /**
+         * @brief Drop the entries of the last snapshot
+         * @param snapshot Snapshot previously filled by acquire()
+         */
+        void release( handle_snapshot_t *snapshot ) override;
+
+        /**
+         * @brief Map a /proc/<pid>/fd link target to an object type index
+         * @param link_target Link text returned by readlink (not null terminated)
+         * @param length Length of link_target in bytes
+         * @return Object type index stand-in
+         */
+        static proc_fd_object_type_t classify_link( const char *link_target, size_t length );
+
+    private:
+        void collect_process( int proc_fd, uint32_t process_id );
+
+        bool                                   m_resolve_types = { };
+        std::vector< common::system_handle_t > m_handles;
+        std::vector< char >                    m_dirent_buffer;
+    };
+} // namespace vac::modules::handle_scanner
+#endif
@@ -0,0 +1,67 @@
+#include "synthetic_handle_source.hpp"
+#include "../../utils/vac_random_utils.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace vac::modules::handle_scanner {
+    namespace {
+        double next_unit( uint64_t *state ) {
+            return static_cast< double >( utils::next_random( state ) >> 11 ) * ( 1.0 / 9007199254740992.0 ); // [0, 1)
+        }
+    } // namespace
+
+    synthetic_handle_source_t::synthetic_handle_source_t( const synthetic_handle_options_t &options ) : m_options( options ) { }
+
+    void synthetic_handle_source_t::generate( ) {
+        uint64_t       state         = m_options.m_seed;
+        const uint32_t process_count = std::max( m_options.m_process_count, 1u );
+        const uint32_t type_limit    = std::max( m_options.m_object_type_limit, 1u );
+        const double   skew          = m_options.m_pid_skew > 0.0 ? m_options.m_pid_skew : 1.0;
+
+        m_handles.resize( m_options.m_handle_count );
+
+        for ( common::system_handle_t &handle : m_handles ) {
+            const uint32_t process_rank
+                = std::min( static_cast< uint32_t >( process_count * std::pow( next_unit( &state ), skew ) ), process_count - 1 );
+
+            handle                     = { };
+            handle.m_process_id        = 4 * ( process_rank + 1 );
+            handle.m_object_type_index = static_cast< UCHAR >( utils::next_random( &state ) % type_limit );
+            handle.m_granted_access    = static_cast< ULONG >( utils::next_random( &state ) & 0x001FFFFF );
+        }
+
+        if ( m_options.m_group_by_process ) {
+            std::stable_sort( m_handles.begin( ), m_handles.end( ),
+                              []( const common::system_handle_t &lhs, const common::system_handle_t &rhs ) {
+                                  return lhs.m_process_id < rhs.m_process_id;
+                              } );
+        }
+
+        // Handle values are per-process and start at 4 like real handle tables
+        uint32_t previous_process_id = 0;
+        USHORT   handle_value        = 0;
+        for ( common::system_handle_t &handle : m_handles ) {
+            if ( handle.m_process_id != previous_process_id ) {
+                previous_process_id = handle.m_process_id;
+                handle_value        = 0;
+            }
+            handle_value          += 4;
+            handle.m_handle_value  = handle_value;
+        }
+    }
+
+    int synthetic_handle_source_t::acquire( handle_snapshot_t *snapshot ) {
+        if ( m_handles.size( ) != m_options.m_handle_count )
+            generate( );
+
+        snapshot->m_handles      = m_handles.data( );
+        snapshot->m_handle_count = static_cast< uint32_t >( m_handles.size( ) );
+        snapshot->m_storage      = nullptr;
+        return 0;
+    }
+
+    void synthetic_handle_source_t::release( handle_snapshot_t *snapshot ) {
+        *snapshot = { };
+    }
+} // namespace vac::modules::handle_scanner
@@ -0,0 +1,51 @@
+#pragma once
+#include "handle_source.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace vac::modules::handle_scanner {
+    /**
+     * @brief Parameters of a generated handle snapshot
+     */
+    struct synthetic_handle_options_t {
+        uint64_t m_seed              = 0x5641433300000001ULL; ///< RNG seed, identical seeds give identical snapshots
+        uint32_t m_handle_count      = 1000000;               ///< Number of handle entries to generate
+        uint32_t m_process_count     = 400;                   ///< Number of distinct owning processes
+        double   m_pid_skew          = 2.0;                   ///< 1.0 = uniform, larger values concentrate handles in few processes
+        uint32_t m_object_type_limit = 0x37;                  ///< Object type indices are drawn from [0, limit)
+        bool     m_group_by_process  = true;                  ///< Emit entries sorted by PID like the kernel does
+    };
+
+    /**
+     * @brief Handle source producing a seeded, reproducible synthetic snapshot
+     *
+     * Owning processes are picked with a power-law skew: rank = floor(count * u^skew),
+     * PIDs are 4 * (rank + 1) like real Windows process IDs. The snapshot is generated
+     * once on the first acquire() and reused, so repeated acquisitions cost nothing
+     * and benchmarks measure only the aggregation.
+     */
+    class synthetic_handle_source_t final : public handle_source_t {
+    public:
+        explicit synthetic_handle_source_t( const synthetic_handle_options_t &options = { } );
+
+        /**
+         * @brief Return the generated snapshot, generating it on first use
+         * @param snapshot Receives a view into the source-owned entry array
+         * @return Always 0
+         */
+        int acquire( handle_snapshot_t *snapshot ) override;
+
+        /**
+         * @brief Detach the snapshot view; the generated entries are kept for reuse
+         * @param snapshot Snapshot previously filled by acquire()
+         */
+        void release( handle_snapshot_t *snapshot ) override;
+
+    private:
+        void generate( );
+
+        synthetic_handle_options_t             m_options;
+        std::vector< common::system_handle_t > m_handles;
+    };
+} // namespace vac::modules::handle_scanner
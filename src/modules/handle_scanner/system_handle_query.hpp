@@ -1,4 +1,6 @@
 #pragma once
+#include "handle_source.hpp"
+
 #include <cstdint>
 
 namespace vac::modules::handle_scanner {
@@ -7,6 +9,7 @@ namespace vac::modules::handle_scanner {
      *
      * This is the exact reverse of VAC's handle enumeration function.
      * Uses progressive buffer allocation and XOR obfuscation for API names.
+     * On non-Windows builds the snapshot comes from /proc/<pid>/fd instead.
      *
      * @param process_id_table Hash table for process ID lookups (max 500 entries)
      * @param max_process_count Maximum number of processes to track
@@ -19,4 +22,37 @@ namespace vac::modules::handle_scanner {
     int __fastcall query_system_handle_information( uint32_t *process_id_table, int max_process_count, int unused_param,
                                                     uint32_t *unique_process_count, uint32_t *total_handle_count,
                                                     uint64_t *handle_info_buffer );
-} // namespace vac::modules::handle_scanner
\ No newline at end of file
+
+    /**
+     * @brief Acquire a snapshot from an arbitrary handle source and aggregate it
+     *
+     * Same contract as query_system_handle_information(); outputs are only written
+     * when the source returns a snapshot successfully.
+     *
+     * @param source Handle source to acquire the snapshot from
+     * @return 0 on success, or the error returned by source->acquire()
+     */
+    int query_handle_information_from_source( handle_source_t *source, uint32_t *process_id_table, int max_process_count,
+                                              uint32_t *unique_process_count, uint32_t *total_handle_count,
+                                              uint64_t *handle_info_buffer );
+
+    /**
+     * @brief Aggregate a handle snapshot into per-process handle summaries
+     *
+     * For every handle the owning PID is located in process_id_table by linear probing
+     * starting at the slot of the previous handle; unseen PIDs are appended while the
+     * table holds fewer than 500 entries. Each process owns a 32-byte slot in
+     * handle_info_buffer:
+     * - dword 0: object types 0x00-0x1F seen (bit per type)
+     * - dword 4: object types 0x20-0x36 seen (bits 0-22) | handle count saturating at 255 (bits 24-31)
+     *
+     * @param snapshot Handle entries to aggregate
+     * @param process_id_table Hash table for process ID lookups (max 500 entries)
+     * @param max_process_count Number of valid entries in process_id_table
+     * @param unique_process_count Output: number of PID lookups that missed the table
+     * @param total_handle_count Output: number of handles in the snapshot
+     * @param handle_info_buffer Per-process 32-byte slots, indexed like process_id_table
+     */
+    void aggregate_handle_snapshot( const handle_snapshot_t *snapshot, uint32_t *process_id_table, int max_process_count,
+                                    uint32_t *unique_process_count, uint32_t *total_handle_count, uint64_t *handle_info_buffer );
+} // namespace vac::modules::handle_scanner
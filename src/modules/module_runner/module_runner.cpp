@@ -0,0 +1,177 @@
+#include "module_runner.hpp"
+#include "../../utils/vac_clock_utils.hpp"
+#include "../../utils/vac_instrumentation.hpp"
+#include "../cpuid_analyzer/cpuid_analyzer.hpp"
+#include "../handle_scanner/system_handle_query.hpp"
+#include "../pnp_device_scanner/pnp_device_scanner.hpp"
+
+#if defined( _WIN32 )
+#include "../anti_debugging/anti_debugging.hpp"
+#include "../process_informer/process_informer.hpp"
+#endif
+
+#include <algorithm>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <new>
+
+namespace vac::modules::module_runner {
+    namespace {
+        /**
+         * @brief Output buffer size of a module
+         */
+        size_t module_output_size( const scan_module_t module ) {
+            switch ( module ) {
+            case scan_module_t::anti_debugging:
+                return g_antidebug_output_size;
+            case scan_module_t::cpuid_analyzer:
+                return sizeof( common::cpuid_analysis_context_t );
+            case scan_module_t::pnp_device_scanner:
+                return sizeof( common::pnp_scan_results_t );
+            case scan_module_t::handle_scanner:
+                return sizeof( handle_scan_output_t );
+            case scan_module_t::process_informer:
+                return g_informer_output_size;
+            }
+
+            return 0;
+        }
+
+        /**
+         * @brief Whether the module has an implementation on this platform
+         */
+        bool module_available( const scan_module_t module ) {
+#if defined( _WIN32 )
+            ( void )module;
+            return true;
+#else
+            return module != scan_module_t::anti_debugging && module != scan_module_t::process_informer;
+#endif
+        }
+
+        /**
+         * @brief Call the entry point of a module on its output buffer
+         */
+        void run_module( const scan_plan_t &plan, scan_module_result_t *result ) {
+            uint8_t *output = result->m_output.data( );
+
+            result->m_output_size = static_cast< uint32_t >( result->m_output.size( ) );
+
+            switch ( result->m_module ) {
+            case scan_module_t::anti_debugging: {
+#if defined( _WIN32 )
+                result->m_result = anti_debugging::antidebug_check( plan.m_antidebug_context, reinterpret_cast< uint32_t * >( output ),
+                                                                    &result->m_output_size );
+#endif
+                break;
+            }
+
+            case scan_module_t::cpuid_analyzer: {
+                // The context is value-initialised in place, it is both input and output
+                auto *context    = new ( output ) common::cpuid_analysis_context_t( );
+                result->m_result = cpuid_analyzer::analyze_cpu_information( context );
+                break;
+            }
+
+            case scan_module_t::pnp_device_scanner: {
+                unsigned int buffer_size = result->m_output_size;
+                result->m_result         = pnp_device_scanner::enumerate_pnp_devices( nullptr, reinterpret_cast< char * >( output ), &buffer_size );
+                result->m_output_size    = buffer_size;
+                break;
+            }
+
+            case scan_module_t::handle_scanner: {
+                // The table is both input and output: the plan's known PIDs first, new ones are appended
+                auto        *handles       = new ( output ) handle_scan_output_t( );
+                const size_t process_count = std::min< size_t >( plan.m_process_id_count, g_handle_table_capacity );
+                std::copy( plan.m_process_id_table, plan.m_process_id_table + process_count, handles->m_process_id_table );
+
+                result->m_result = handle_scanner::query_system_handle_information(
+                    handles->m_process_id_table, static_cast< int >( process_count ), 0, &handles->m_unique_process_count,
+                    &handles->m_total_handle_count, handles->m_handle_info );
+                break;
+            }
+
+            case scan_module_t::process_informer: {
+#if defined( _WIN32 )
+                // The entry point takes a mutable input, keep the plan untouched
+                uint8_t input_data[ g_informer_input_size ];
+                std::copy( plan.m_informer_input, plan.m_informer_input + g_informer_input_size, input_data );
+
+                result->m_result = process_informer::read_process_information_section( input_data, reinterpret_cast< uint32_t * >( output ),
+                                                                                      &result->m_output_size );
+#endif
+                break;
+            }
+            }
+        }
+    } // namespace
+
+    uint32_t run_scan_plan( const scan_plan_t &plan, scan_report_t *report, utils::thread_pool_t *pool ) {
+        VAC_TRACE_FUNCTION( );
+
+        *report = { };
+
+        const utils::clock_source_t &clock = utils::precise_clock( );
+
+        // Buffers are sized up front so workers only touch their own result
+        std::vector< scan_module_result_t * > planned;
+        for ( size_t module_index = 0; module_index < g_scan_module_count; ++module_index ) {
+            scan_module_result_t &result = report->m_modules[ module_index ];
+            result.m_module              = static_cast< scan_module_t >( module_index );
+
+            if ( !( plan.m_module_mask & scan_module_bit( result.m_module ) ) || !module_available( result.m_module ) )
+                continue;
+
+            result.m_output.assign( module_output_size( result.m_module ), 0 );
+            planned.push_back( &result );
+        }
+
+        if ( planned.empty( ) )
+            return 0;
+
+        std::unique_ptr< utils::thread_pool_t > own_pool;
+        if ( !pool ) {
+            own_pool = std::make_unique< utils::thread_pool_t >( plan.m_worker_count ? plan.m_worker_count
+                                                                                     : static_cast< unsigned int >( planned.size( ) ) );
+            pool     = own_pool.get( );
+        }
+
+        size_t                  modules_running = planned.size( );
+        std::mutex              done_mutex;
+        std::condition_variable done_signal;
+
+        const uint64_t scan_start_ns = clock.now_ns( );
+
+        for ( scan_module_result_t *result : planned ) {
+            pool->submit( [ &, result ] {
+                const uint64_t start_ns = clock.now_ns( );
+                run_module( plan, result );
+                const uint64_t end_ns = clock.now_ns( );
+
+                result->m_ran      = true;
+                result->m_start_ns = start_ns - scan_start_ns;
+                result->m_wall_ns  = end_ns - start_ns;
+
+                std::lock_guard< std::mutex > done_lock( done_mutex );
+                if ( !--modules_running )
+                    done_signal.notify_one( );
+            } );
+        }
+
+        {
+            std::unique_lock< std::mutex > done_lock( done_mutex );
+            done_signal.wait( done_lock, [ & ] { return modules_running == 0; } );
+        }
+
+        report->m_wall_ns = clock.now_ns( ) - scan_start_ns;
+
+        for ( const scan_module_result_t *result : planned ) {
+            ++report->m_modules_run;
+            report->m_module_sum_ns += result->m_wall_ns;
+        }
+
+        return report->m_modules_run;
+    }
+} // namespace vac::modules::module_runner
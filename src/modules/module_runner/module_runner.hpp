@@ -0,0 +1,105 @@
+#pragma once
+#include "../../common/types.hpp"
+#include "../../utils/vac_thread_pool.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace vac::modules::module_runner {
+    /**
+     * @brief Independent scan modules the runner can schedule
+     */
+    enum class scan_module_t : uint32_t {
+        anti_debugging     = 0, ///< anti_debugging::antidebug_check, Windows only
+        cpuid_analyzer     = 1, ///< cpuid_analyzer::analyze_cpu_information
+        pnp_device_scanner = 2, ///< pnp_device_scanner::enumerate_pnp_devices
+        handle_scanner     = 3, ///< handle_scanner::query_system_handle_information
+        process_informer   = 4, ///< process_informer::read_process_information_section, Windows only
+    };
+
+    constexpr size_t   g_scan_module_count    = 5;
+    constexpr uint32_t g_scan_all_modules     = ( 1u << g_scan_module_count ) - 1;
+    constexpr size_t   g_informer_input_size  = 100; ///< input_data bytes, the GUID bytes sit at 96 .. 99
+    constexpr size_t   g_antidebug_output_size = 32;
+    constexpr size_t   g_informer_output_size  = 4096;
+    constexpr size_t   g_handle_table_capacity = 500; ///< process_id_table entries and 32-byte handle slots
+
+    /**
+     * @brief Bit of a module in scan_plan_t::m_module_mask
+     */
+    constexpr uint32_t scan_module_bit( const scan_module_t module ) { return 1u << static_cast< uint32_t >( module ); }
+
+    /**
+     * @brief Output layout of the handle_scanner module
+     *
+     * query_system_handle_information() reports through several buffers; the runner keeps
+     * them together so the module still hands back one output buffer.
+     */
+    struct handle_scan_output_t {
+        uint32_t m_unique_process_count                           = { }; ///< PID lookups that missed the table
+        uint32_t m_total_handle_count                             = { }; ///< Handles in the snapshot
+        uint32_t m_process_id_table[ g_handle_table_capacity ]    = { }; ///< Process IDs, indexed like m_handle_info
+        uint64_t m_handle_info[ g_handle_table_capacity * 4 ]     = { }; ///< 32-byte slot per process
+    };
+
+    /**
+     * @brief Which modules to run and their inputs
+     */
+    struct scan_plan_t {
+        uint32_t m_module_mask                                 = g_scan_all_modules; ///< scan_module_bit() of every module to run
+        void    *m_antidebug_context                           = { };                ///< context argument of antidebug_check()
+        uint8_t  m_informer_input[ g_informer_input_size ]     = { };                ///< input_data of read_process_information_section()
+        uint32_t m_process_id_table[ g_handle_table_capacity ] = { };                ///< Known process IDs seeding the handle scan's table
+        uint32_t m_process_id_count                            = 0;                  ///< Valid m_process_id_table entries, capped at g_handle_table_capacity
+        unsigned m_worker_count                                = 0;                  ///< Pool size when the runner creates one, 0 for one per planned module
+    };
+
+    /**
+     * @brief Outcome of one module
+     *
+     * m_output holds the module's output buffer as the entry point left it:
+     * - anti_debugging: the 32-byte out_buffer
+     * - cpuid_analyzer: the cpuid_analysis_context_t
+     * - pnp_device_scanner: the pnp_scan_results_t
+     * - handle_scanner: a handle_scan_output_t
+     * - process_informer: the 4096-byte output_buffer
+     */
+    struct scan_module_result_t {
+        scan_module_t          m_module      = { }; ///< Module this result belongs to
+        bool                   m_ran         = { }; ///< False when not planned or not available on this platform
+        int                    m_result      = { }; ///< Return value of the entry point
+        uint32_t               m_output_size = { }; ///< Size the entry point reported, or the buffer size if it reports none
+        std::vector< uint8_t > m_output;            ///< Output buffer of the entry point
+        uint64_t               m_start_ns    = { }; ///< Start relative to the start of the scan
+        uint64_t               m_wall_ns     = { }; ///< Wall time of the entry point
+    };
+
+    /**
+     * @brief Results of run_scan_plan()
+     */
+    struct scan_report_t {
+        scan_module_result_t m_modules[ g_scan_module_count ] = { }; ///< Indexed by scan_module_t
+        uint32_t             m_modules_run                   = { }; ///< Modules that ran
+        uint64_t             m_wall_ns                       = { }; ///< Wall time of the whole scan
+        uint64_t             m_module_sum_ns                 = { }; ///< Sum of module wall times, roughly a serial scan
+
+        const scan_module_result_t &operator[]( const scan_module_t module ) const { return m_modules[ static_cast< size_t >( module ) ]; }
+    };
+
+    /**
+     * @brief Run the planned modules concurrently and collect their outputs
+     *
+     * The modules share no state with each other, so every planned module becomes one task
+     * on a work-stealing pool and the scan takes about as long as its slowest module instead
+     * of the sum of all of them. Output buffers are owned by the report, sized for each
+     * module, and zeroed before the module runs. Modules without an implementation on this
+     * platform are left with m_ran false.
+     *
+     * @param plan Modules and inputs
+     * @param report Receives one result per module and the timings
+     * @param pool Pool to run on; if null a pool of plan.m_worker_count workers lives for this call
+     * @return Number of modules that ran
+     */
+    uint32_t run_scan_plan( const scan_plan_t &plan, scan_report_t *report, utils::thread_pool_t *pool = nullptr );
+} // namespace vac::modules::module_runner
@@ -0,0 +1,52 @@
+#include "scan_plan_benchmark.hpp"
+#include "../../utils/vac_thread_pool.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+
+namespace vac::modules::module_runner {
+    int run_scan_plan_benchmark( const scan_plan_benchmark_config_t &config, scan_plan_benchmark_report_t *report ) {
+        *report = { };
+
+        const unsigned int planned_modules = static_cast< unsigned int >( std::popcount( config.m_plan.m_module_mask & g_scan_all_modules ) );
+        const unsigned int worker_count    = config.m_plan.m_worker_count ? config.m_plan.m_worker_count : std::max( planned_modules, 1u );
+        const uint32_t     rounds          = std::max< uint32_t >( config.m_rounds, 1 );
+
+        utils::thread_pool_t serial_pool( 1 );
+        utils::thread_pool_t parallel_pool( worker_count );
+
+        scan_report_t scan;
+
+        // Warm-up: fills the module caches and starts every worker
+        run_scan_plan( config.m_plan, &scan, &serial_pool );
+        run_scan_plan( config.m_plan, &scan, &parallel_pool );
+
+        if ( !scan.m_modules_run )
+            return 1;
+
+        report->m_modules_run      = scan.m_modules_run;
+        report->m_serial_wall_ns   = std::numeric_limits< uint64_t >::max( );
+        report->m_parallel_wall_ns = std::numeric_limits< uint64_t >::max( );
+
+        for ( uint32_t round = 0; round < rounds; ++round ) {
+            run_scan_plan( config.m_plan, &scan, &serial_pool );
+            report->m_serial_wall_ns = std::min( report->m_serial_wall_ns, scan.m_wall_ns );
+
+            run_scan_plan( config.m_plan, &scan, &parallel_pool );
+            if ( scan.m_wall_ns >= report->m_parallel_wall_ns )
+                continue;
+
+            report->m_parallel_wall_ns  = scan.m_wall_ns;
+            report->m_module_sum_ns     = scan.m_module_sum_ns;
+            report->m_slowest_module_ns = 0;
+
+            for ( size_t module_index = 0; module_index < g_scan_module_count; ++module_index ) {
+                report->m_module_wall_ns[ module_index ] = scan.m_modules[ module_index ].m_wall_ns;
+                report->m_slowest_module_ns              = std::max( report->m_slowest_module_ns, scan.m_modules[ module_index ].m_wall_ns );
+            }
+        }
+
+        return 0;
+    }
+} // namespace vac::modules::module_runner
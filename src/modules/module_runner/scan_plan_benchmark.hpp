@@ -0,0 +1,43 @@
+#pragma once
+#include "module_runner.hpp"
+
+#include <cstdint>
+
+namespace vac::modules::module_runner {
+    /**
+     * @brief Parameters of run_scan_plan_benchmark()
+     */
+    struct scan_plan_benchmark_config_t {
+        scan_plan_t m_plan;       ///< Plan run every round; m_worker_count sizes the parallel pool, 0 for one per module
+        uint32_t    m_rounds = 5; ///< Timed scans per pool after one untimed warm-up scan each, the fastest is reported
+    };
+
+    /**
+     * @brief Results of run_scan_plan_benchmark()
+     */
+    struct scan_plan_benchmark_report_t {
+        uint32_t m_modules_run                           = { }; ///< Modules the plan ran on this platform
+        uint64_t m_serial_wall_ns                        = { }; ///< Fastest scan on a one-worker pool
+        uint64_t m_parallel_wall_ns                      = { }; ///< Fastest scan on the parallel pool
+        uint64_t m_module_sum_ns                         = { }; ///< Sum of module wall times of that parallel scan
+        uint64_t m_slowest_module_ns                     = { }; ///< Longest module of that parallel scan, the lower bound of its wall time
+        uint64_t m_module_wall_ns[ g_scan_module_count ] = { }; ///< Wall time per module of that parallel scan, indexed by scan_module_t
+    };
+
+    /**
+     * @brief Compare a scan run module by module with the same scan on the work-stealing pool
+     *
+     * Runs the plan through run_scan_plan() on a one-worker pool and on a pool of
+     * m_worker_count workers. Both pools are created before timing starts. The parallel
+     * scan's wall time is reported next to its m_module_sum_ns and slowest module, so the
+     * gap between wall time and the slowest module is the runner's own overhead and the
+     * gap to the module sum is what running in parallel saves. Modules keep their
+     * process-wide caches (CPUID snapshot, PnP result) between scans, so the warm-up
+     * scans leave every timed scan on the cached path.
+     *
+     * @param config Plan and run length
+     * @param report Receives the timings
+     * @return 0 on success, 1 if the plan runs no module on this platform
+     */
+    int run_scan_plan_benchmark( const scan_plan_benchmark_config_t &config, scan_plan_benchmark_report_t *report );
+} // namespace vac::modules::module_runner
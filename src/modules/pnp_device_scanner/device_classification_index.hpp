@@ -0,0 +1,147 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace vac::modules::pnp_device_scanner {
+    constexpr size_t   g_classification_table_header = 32;   ///< Header dwords before the first (device_id, tag) pair
+    constexpr uint32_t g_classification_tag_base     = 0x1E; ///< Tags are stored as ordinals relative to this value
+    constexpr uint32_t g_classification_tag_limit    = 0x2E; ///< First tag whose ordinal no longer fits in 4 bits
+
+    /**
+     * @brief Count the (device_id, tag) pairs of a classification table
+     * @param table Table in VAC layout: header, pairs, (0, 0) terminator
+     * @return Number of pairs before the terminator
+     */
+    template < size_t table_size >
+    constexpr size_t count_classification_entries( const uint32_t ( &table )[ table_size ] ) {
+        size_t entry_count = 0;
+        for ( size_t index = g_classification_table_header; index + 1 < table_size && table[ index ]; index += 2 )
+            ++entry_count;
+
+        return entry_count;
+    }
+
+    /**
+     * @brief Compile-time perfect hash from packed VID/PID to classification tag
+     *
+     * Built with hash-and-displace: keys are split into buckets by one hash, and each
+     * bucket gets a displacement that sends all of its keys to free, distinct slots
+     * under a second hash. A lookup is therefore one bucket read plus one slot read
+     * and a key compare, independent of how many devices the table holds.
+     *
+     * Instantiate with count_classification_entries() of the table and build() it
+     * into a constexpr variable; a tag outside 0x1F..0x2D fails the build.
+     */
+    template < size_t entry_count >
+    class device_classification_index_t {
+    public:
+        static constexpr size_t g_slot_count = [] {
+            size_t slot_count = 16;
+            while ( slot_count < 2 * entry_count )
+                slot_count <<= 1;
+            return slot_count;
+        }( );
+        static constexpr size_t g_bucket_count = g_slot_count / 4;
+
+        /**
+         * @brief Look up the classification tag of a device
+         * @param device_id ( VID << 16 ) | PID
+         * @return Tag from the table, 0 if the device is not listed
+         */
+        constexpr uint32_t lookup( const uint32_t device_id ) const {
+            const slot_t &slot = m_slots[ slot_hash( device_id, m_displacements[ bucket_hash( device_id ) ] ) ];
+            return slot.m_device_id == device_id ? slot.m_tag : 0;
+        }
+
+        template < size_t table_size >
+        static constexpr device_classification_index_t build( const uint32_t ( &table )[ table_size ] ) {
+            device_classification_index_t index;
+
+            // Group the entries by bucket (counting sort) so each placement only touches its own keys
+            std::array< size_t, g_bucket_count + 1 > bucket_begin  = { };
+            std::array< size_t, entry_count + 1 >    bucket_order  = { };
+            std::array< size_t, g_bucket_count >     bucket_fill   = { };
+            std::array< bool, g_slot_count >         slot_taken    = { };
+            std::array< size_t, g_slot_count >       pending_slots = { };
+
+            for ( size_t entry = 0; entry < entry_count; ++entry ) {
+                const uint32_t tag = table[ g_classification_table_header + 2 * entry + 1 ];
+                if ( tag <= g_classification_tag_base || tag >= g_classification_tag_limit )
+                    throw "classification tag does not fit the 4-bit ordinal";
+
+                ++bucket_begin[ bucket_hash( table[ g_classification_table_header + 2 * entry ] ) + 1 ];
+            }
+
+            size_t largest_bucket = 0;
+            for ( size_t bucket = 0; bucket < g_bucket_count; ++bucket ) {
+                largest_bucket             = bucket_begin[ bucket + 1 ] > largest_bucket ? bucket_begin[ bucket + 1 ] : largest_bucket;
+                bucket_begin[ bucket + 1 ] += bucket_begin[ bucket ];
+            }
+
+            for ( size_t entry = 0; entry < entry_count; ++entry ) {
+                const size_t bucket = bucket_hash( table[ g_classification_table_header + 2 * entry ] );
+                bucket_order[ bucket_begin[ bucket ] + bucket_fill[ bucket ]++ ] = entry;
+            }
+
+            // Place the crowded buckets first, they have the fewest displacements that work
+            for ( size_t bucket_size = largest_bucket; bucket_size; --bucket_size ) {
+                for ( size_t bucket = 0; bucket < g_bucket_count; ++bucket ) {
+                    if ( bucket_fill[ bucket ] != bucket_size )
+                        continue;
+
+                    for ( uint32_t displacement = 0;; ++displacement ) {
+                        if ( displacement > 0xFFFF )
+                            throw "no displacement places this bucket";
+
+                        bool placed = true;
+                        for ( size_t member = 0; member < bucket_size && placed; ++member ) {
+                            const uint32_t device_id = table[ g_classification_table_header + 2 * bucket_order[ bucket_begin[ bucket ] + member ] ];
+                            const size_t   slot      = slot_hash( device_id, static_cast< uint16_t >( displacement ) );
+
+                            placed = !slot_taken[ slot ];
+                            for ( size_t pending = 0; pending < member && placed; ++pending )
+                                placed = pending_slots[ pending ] != slot;
+
+                            pending_slots[ member ] = slot;
+                        }
+
+                        if ( !placed )
+                            continue;
+
+                        for ( size_t member = 0; member < bucket_size; ++member ) {
+                            const size_t entry                   = bucket_order[ bucket_begin[ bucket ] + member ];
+                            slot_taken[ pending_slots[ member ] ] = true;
+                            index.m_slots[ pending_slots[ member ] ]
+                                = { table[ g_classification_table_header + 2 * entry ], table[ g_classification_table_header + 2 * entry + 1 ] };
+                        }
+
+                        index.m_displacements[ bucket ] = static_cast< uint16_t >( displacement );
+                        break;
+                    }
+                }
+            }
+
+            return index;
+        }
+
+    private:
+        struct slot_t {
+            uint32_t m_device_id = { }; ///< Packed VID/PID, 0 for an empty slot
+            uint32_t m_tag       = { }; ///< Classification tag
+        };
+
+        static constexpr size_t bucket_hash( const uint32_t device_id ) {
+            return static_cast< size_t >( ( device_id * 0x9E3779B1u ) >> 16 ) & ( g_bucket_count - 1 );
+        }
+
+        static constexpr size_t slot_hash( const uint32_t device_id, const uint16_t displacement ) {
+            const uint64_t mixed = ( device_id ^ ( displacement * 0x85EBCA6Bu ) ) * 0xC2B2AE3D27D4EB4FULL;
+            return static_cast< size_t >( mixed >> 32 ) & ( g_slot_count - 1 );
+        }
+
+        std::array< uint16_t, g_bucket_count > m_displacements = { };
+        std::array< slot_t, g_slot_count >     m_slots         = { };
+    };
+} // namespace vac::modules::pnp_device_scanner
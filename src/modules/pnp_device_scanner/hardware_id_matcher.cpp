@@ -0,0 +1,180 @@
+#include "hardware_id_matcher.hpp"
+#include "pnp_string_key.hpp"
+
+#include "../../utils/vac_obfuscated_string.hpp"
+
+namespace vac::modules::pnp_device_scanner {
+    namespace {
+        // Search strings, stored encoded with per-token keys derived from VAC_PNP_STRING_KEY and only
+        // decoded while building the automaton at compile time
+        template < size_t length, hardware_id_token_t token >
+        using pnp_token_string_t
+            = utils::obfuscated_string_t< length, utils::make_literal_key( VAC_PNP_STRING_KEY, static_cast< uint32_t >( token ) ) >;
+
+        constexpr pnp_token_string_t< 5,  hardware_id_token_t::ven      > g_ven_token( "VEN_" );
+        constexpr pnp_token_string_t< 5,  hardware_id_token_t::dev      > g_dev_token( "DEV_" );
+        constexpr pnp_token_string_t< 4,  hardware_id_token_t::cc       > g_cc_token( "CC_" );
+        constexpr pnp_token_string_t< 5,  hardware_id_token_t::vid      > g_vid_token( "VID_" );
+        constexpr pnp_token_string_t< 5,  hardware_id_token_t::pid      > g_pid_token( "PID_" );
+        constexpr pnp_token_string_t< 10, hardware_id_token_t::devclass > g_devclass_token( "DevClass_" );
+        constexpr pnp_token_string_t< 8,  hardware_id_token_t::class_   > g_class_token( "\\Class_" );
+        constexpr pnp_token_string_t< 10, hardware_id_token_t::subclass > g_subclass_token( "SubClass_" );
+        constexpr pnp_token_string_t< 6,  hardware_id_token_t::prot     > g_prot_token( "Prot_" );
+
+        template < size_t length, uint8_t key >
+        constexpr uint8_t token_character_at( const utils::obfuscated_string_t< length, key > &token_string, const size_t index ) {
+            return index < token_string.size( ) ? static_cast< uint8_t >( token_string.at( index ) ) : 0;
+        }
+
+        /**
+         * @brief Decoded character of a token, 0 past its end (indexed by hardware_id_token_t)
+         */
+        constexpr uint8_t token_character( const size_t token, const size_t index ) {
+            switch ( static_cast< hardware_id_token_t >( token ) ) {
+                case hardware_id_token_t::ven:
+                    return token_character_at( g_ven_token, index );
+                case hardware_id_token_t::dev:
+                    return token_character_at( g_dev_token, index );
+                case hardware_id_token_t::cc:
+                    return token_character_at( g_cc_token, index );
+                case hardware_id_token_t::vid:
+                    return token_character_at( g_vid_token, index );
+                case hardware_id_token_t::pid:
+                    return token_character_at( g_pid_token, index );
+                case hardware_id_token_t::devclass:
+                    return token_character_at( g_devclass_token, index );
+                case hardware_id_token_t::class_:
+                    return token_character_at( g_class_token, index );
+                case hardware_id_token_t::subclass:
+                    return token_character_at( g_subclass_token, index );
+                case hardware_id_token_t::prot:
+                    return token_character_at( g_prot_token, index );
+            }
+
+            return 0;
+        }
+
+        constexpr size_t g_max_automaton_states  = 64;
+        constexpr size_t g_max_automaton_classes = 32;
+
+        /**
+         * @brief Aho-Corasick automaton flattened into a full DFA
+         *
+         * Bytes are mapped to a small alphabet first (class 0 = byte not used by any token),
+         * so every transition is a single table load and there is no failure-link walk at runtime.
+         */
+        struct hardware_id_automaton_t {
+            uint8_t  m_byte_class[ 256 ]                                               = { }; ///< Byte -> alphabet class
+            uint8_t  m_next_state[ g_max_automaton_states ][ g_max_automaton_classes ] = { }; ///< DFA transitions
+            uint16_t m_output[ g_max_automaton_states ]                                = { }; ///< Bit per token ending in this state
+            uint8_t  m_token_length[ g_hardware_id_token_count ]                       = { }; ///< Length of each token
+            size_t   m_state_count                                                     = { }; ///< States in use
+            size_t   m_class_count                                                     = { }; ///< Alphabet classes in use
+        };
+
+        constexpr hardware_id_automaton_t build_hardware_id_automaton( ) {
+            hardware_id_automaton_t automaton;
+
+            // Goto function of the trie, -1 = no edge
+            int goto_function[ g_max_automaton_states ][ g_max_automaton_classes ] = { };
+            for ( auto &state_edges : goto_function )
+                for ( int &edge : state_edges )
+                    edge = -1;
+
+            automaton.m_state_count = 1;
+            automaton.m_class_count = 1;
+
+            for ( size_t token = 0; token < g_hardware_id_token_count; ++token ) {
+                size_t state = 0;
+                size_t index = 0;
+
+                for ( ; token_character( token, index ); ++index ) {
+                    const uint8_t character = token_character( token, index );
+
+                    if ( !automaton.m_byte_class[ character ] )
+                        automaton.m_byte_class[ character ] = static_cast< uint8_t >( automaton.m_class_count++ );
+
+                    const uint8_t byte_class = automaton.m_byte_class[ character ];
+                    if ( goto_function[ state ][ byte_class ] < 0 )
+                        goto_function[ state ][ byte_class ] = static_cast< int >( automaton.m_state_count++ );
+
+                    state = static_cast< size_t >( goto_function[ state ][ byte_class ] );
+                }
+
+                automaton.m_output[ state ]       |= static_cast< uint16_t >( 1u << token );
+                automaton.m_token_length[ token ]  = static_cast< uint8_t >( index );
+            }
+
+            // Breadth-first construction of failure links, folded directly into the DFA transitions
+            size_t failure[ g_max_automaton_states ] = { };
+            size_t queue[ g_max_automaton_states ]   = { };
+            size_t queue_head                        = 0;
+            size_t queue_tail                        = 0;
+
+            for ( size_t byte_class = 0; byte_class < automaton.m_class_count; ++byte_class ) {
+                const int target = goto_function[ 0 ][ byte_class ];
+                if ( target > 0 ) {
+                    automaton.m_next_state[ 0 ][ byte_class ] = static_cast< uint8_t >( target );
+                    failure[ target ]                         = 0;
+                    queue[ queue_tail++ ]                     = static_cast< size_t >( target );
+                }
+            }
+
+            while ( queue_head < queue_tail ) {
+                const size_t state = queue[ queue_head++ ];
+                automaton.m_output[ state ] |= automaton.m_output[ failure[ state ] ];
+
+                for ( size_t byte_class = 0; byte_class < automaton.m_class_count; ++byte_class ) {
+                    const int target = goto_function[ state ][ byte_class ];
+                    if ( target < 0 ) {
+                        automaton.m_next_state[ state ][ byte_class ] = automaton.m_next_state[ failure[ state ] ][ byte_class ];
+                        continue;
+                    }
+
+                    failure[ target ]                             = automaton.m_next_state[ failure[ state ] ][ byte_class ];
+                    automaton.m_next_state[ state ][ byte_class ] = static_cast< uint8_t >( target );
+                    queue[ queue_tail++ ]                         = static_cast< size_t >( target );
+                }
+            }
+
+            return automaton;
+        }
+
+        constexpr hardware_id_automaton_t g_hardware_id_automaton = build_hardware_id_automaton( );
+
+        static_assert( g_hardware_id_automaton.m_state_count <= g_max_automaton_states, "Token automaton exceeds state table" );
+        static_assert( g_hardware_id_automaton.m_class_count <= g_max_automaton_classes, "Token automaton exceeds alphabet table" );
+        static_assert( g_hardware_id_automaton.m_token_length[ static_cast< size_t >( hardware_id_token_t::cc ) ] == 3,
+                       "CC_ token must decode to three characters" );
+    } // namespace
+
+    size_t get_hardware_id_token_length( const hardware_id_token_t token ) {
+        return g_hardware_id_automaton.m_token_length[ static_cast< size_t >( token ) ];
+    }
+
+    void scan_hardware_id_tokens( const char *data, const size_t length, hardware_id_tokens_t *tokens ) {
+        const hardware_id_automaton_t &automaton = g_hardware_id_automaton;
+        uint8_t                        state     = 0;
+
+        for ( size_t index = 0; index < length; ++index ) {
+            state = automaton.m_next_state[ state ][ automaton.m_byte_class[ static_cast< uint8_t >( data[ index ] ) ] ];
+
+            uint32_t matched_tokens = automaton.m_output[ state ];
+            if ( !matched_tokens )
+                continue;
+
+            for ( uint32_t token = 0; matched_tokens; ++token, matched_tokens >>= 1 ) {
+                if ( !( matched_tokens & 1 ) )
+                    continue;
+
+                const char *token_start = data + index + 1 - automaton.m_token_length[ token ];
+
+                if ( !tokens->m_first[ token ] )
+                    tokens->m_first[ token ] = token_start;
+
+                if ( token == static_cast< uint32_t >( hardware_id_token_t::cc ) && tokens->m_cc_count < g_max_cc_positions )
+                    tokens->m_cc_positions[ tokens->m_cc_count++ ] = token_start;
+            }
+        }
+    }
+} // namespace vac::modules::pnp_device_scanner
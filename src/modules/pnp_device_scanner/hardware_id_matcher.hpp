@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace vac::modules::pnp_device_scanner {
+    /**
+     * @brief Tokens searched for in device descriptions and hardware IDs
+     */
+    enum class hardware_id_token_t : uint8_t {
+        ven      = 0, ///< "VEN_"      - PCI vendor ID
+        dev      = 1, ///< "DEV_"      - PCI device ID
+        cc       = 2, ///< "CC_"       - PCI class code
+        vid      = 3, ///< "VID_"      - USB/HID vendor ID
+        pid      = 4, ///< "PID_"      - USB/HID product ID
+        devclass = 5, ///< "DevClass_" - USB device class
+        class_   = 6, ///< "\Class_"   - USB interface class
+        subclass = 7, ///< "SubClass_" - USB interface subclass
+        prot     = 8  ///< "Prot_"     - USB interface protocol
+    };
+
+    constexpr size_t g_hardware_id_token_count = 9;
+
+    /**
+     * @brief Maximum CC_ occurrences remembered for the class code retry loop
+     *
+     * The retry only moves on when a CC_ field fails to parse, so anything beyond
+     * this many malformed class codes in one device is ignored.
+     */
+    constexpr size_t g_max_cc_positions = 16;
+
+    /**
+     * @brief Token positions found by scan_hardware_id_tokens()
+     *
+     * Positions point at the first character of the token, exactly like strstr().
+     */
+    struct hardware_id_tokens_t {
+        const char *m_first[ g_hardware_id_token_count ] = { }; ///< Leftmost occurrence of each token, nullptr if absent
+        const char *m_cc_positions[ g_max_cc_positions ] = { }; ///< Every CC_ occurrence in order (up to g_max_cc_positions)
+        uint32_t    m_cc_count                           = { }; ///< Number of entries in m_cc_positions
+
+        const char *first( const hardware_id_token_t token ) const { return m_first[ static_cast< size_t >( token ) ]; }
+    };
+
+    /**
+     * @brief Get the length of a token in characters
+     * @param token Token identifier
+     * @return Token length (e.g. 4 for "VEN_")
+     */
+    size_t get_hardware_id_token_length( hardware_id_token_t token );
+
+    /**
+     * @brief Find every token in a buffer with a single pass
+     *
+     * Runs a compile-time built Aho-Corasick automaton (full DFA over a reduced
+     * byte alphabet) across the buffer. Matches are accumulated into tokens, so a
+     * device can be scanned piecewise; the automaton restarts at the beginning of
+     * each call, and bytes outside the token alphabet (including NUL and newline)
+     * reset it, so tokens never span separators.
+     *
+     * @param data Bytes to scan
+     * @param length Number of bytes to scan
+     * @param tokens Match accumulator, zero-initialise before the first call for a device
+     */
+    void scan_hardware_id_tokens( const char *data, size_t length, hardware_id_tokens_t *tokens );
+} // namespace vac::modules::pnp_device_scanner
@@ -0,0 +1,278 @@
+#include "hardware_id_matcher_benchmark.hpp"
+#include "hardware_id_matcher.hpp"
+#include "pnp_device_scanner.hpp"
+#include "../../utils/vac_clock_utils.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <vector>
+
+namespace vac::modules::pnp_device_scanner {
+    namespace {
+        /**
+         * @brief Device of the corpus, hardware IDs are a multi-sz like SPDRP_HARDWAREID returns
+         */
+        struct corpus_device_t {
+            const char *m_description;
+            const char *m_hardware_ids;
+        };
+
+        // Description and hardware IDs as Device Manager reports them on desktop machines
+        constexpr corpus_device_t g_hardware_id_corpus[] = {
+            // PCI
+            { "Intel(R) Ethernet Connection (7) I219-V",
+              "PCI\\VEN_8086&DEV_15BC&SUBSYS_7A721462&REV_10\0PCI\\VEN_8086&DEV_15BC&SUBSYS_7A721462\0PCI\\VEN_8086&DEV_15BC&CC_020000\0"
+              "PCI\\VEN_8086&DEV_15BC&CC_0200\0" },
+            { "NVIDIA GeForce RTX 3080",
+              "PCI\\VEN_10DE&DEV_2206&SUBSYS_38801462&REV_A1\0PCI\\VEN_10DE&DEV_2206&SUBSYS_38801462\0PCI\\VEN_10DE&DEV_2206&CC_030000\0"
+              "PCI\\VEN_10DE&DEV_2206&CC_0300\0" },
+            { "High Definition Audio Controller",
+              "PCI\\VEN_10DE&DEV_1AEF&SUBSYS_38801462&REV_A1\0PCI\\VEN_10DE&DEV_1AEF&SUBSYS_38801462\0PCI\\VEN_10DE&DEV_1AEF&CC_040300\0"
+              "PCI\\VEN_10DE&DEV_1AEF&CC_0403\0" },
+            { "Samsung SSD 970 EVO Plus 1TB",
+              "PCI\\VEN_144D&DEV_A808&SUBSYS_A801144D&REV_00\0PCI\\VEN_144D&DEV_A808&SUBSYS_A801144D\0PCI\\VEN_144D&DEV_A808&CC_010802\0"
+              "PCI\\VEN_144D&DEV_A808&CC_0108\0" },
+            { "AMD GPP Bridge",
+              "PCI\\VEN_1022&DEV_1483&SUBSYS_14531022&REV_00\0PCI\\VEN_1022&DEV_1483&SUBSYS_14531022\0PCI\\VEN_1022&DEV_1483&CC_060400\0"
+              "PCI\\VEN_1022&DEV_1483&CC_0604\0" },
+            { "Intel(R) USB 3.1 eXtensible Host Controller - 1.10 (Microsoft)",
+              "PCI\\VEN_8086&DEV_A36D&SUBSYS_7B451462&REV_10\0PCI\\VEN_8086&DEV_A36D&SUBSYS_7B451462\0PCI\\VEN_8086&DEV_A36D&CC_0C0330\0"
+              "PCI\\VEN_8086&DEV_A36D&CC_0C03\0" },
+            { "Realtek High Definition Audio",
+              "HDAUDIO\\FUNC_01&VEN_10EC&DEV_1220&SUBSYS_1462CC34&REV_1001\0HDAUDIO\\FUNC_01&VEN_10EC&DEV_1220&SUBSYS_1462CC34\0" },
+
+            // USB, a composite device and its interfaces
+            { "USB Composite Device", "USB\\VID_046D&PID_C52B&REV_1211\0USB\\VID_046D&PID_C52B\0" },
+            { "USB Input Device", "USB\\VID_046D&PID_C52B&REV_1211&MI_00\0USB\\VID_046D&PID_C52B&MI_00\0" },
+            { "USB Input Device", "USB\\VID_046D&PID_C52B&REV_1211&MI_01\0USB\\VID_046D&PID_C52B&MI_01\0" },
+            { "Logitech USB Input Device", "USB\\VID_046D&PID_C52B&REV_1211&MI_02\0USB\\VID_046D&PID_C52B&MI_02\0" },
+            { "Generic USB Hub", "USB\\VID_05E3&PID_0610&REV_9226\0USB\\VID_05E3&PID_0610\0" },
+            { "USB Root Hub (USB 3.0)", "USB\\ROOT_HUB30&VID8086&PIDA36D&REV0010\0USB\\ROOT_HUB30&VID8086&PIDA36D\0USB\\ROOT_HUB30\0" },
+            { "Intel(R) Wireless Bluetooth(R)", "USB\\VID_8087&PID_0029&REV_0001\0USB\\VID_8087&PID_0029\0" },
+            { "Logitech HD Pro Webcam C920", "USB\\VID_046D&PID_082D&REV_0011&MI_00\0USB\\VID_046D&PID_082D&MI_00\0" },
+            { "Xbox 360 Controller for Windows", "USB\\VID_045E&PID_028E&REV_0114\0USB\\VID_045E&PID_028E\0" },
+            { "Razer DeathAdder Elite",
+              "USB\\VID_1532&PID_005C&REV_0200&MI_00\0USB\\VID_1532&PID_005C&MI_00\0USB\\Class_03&SubClass_01&Prot_02\0" },
+            { "USB Mass Storage Device", "USB\\VID_0781&PID_5583&REV_0100\0USB\\VID_0781&PID_5583\0USB\\DevClass_00&SubClass_00&Prot_00\0" },
+
+            // HID collections
+            { "HID Keyboard Device",
+              "HID\\VID_046D&PID_C52B&REV_1211&MI_00\0HID\\VID_046D&PID_C52B&MI_00\0HID\\VID_046D&UP:0001_U:0006\0HID_DEVICE_SYSTEM_KEYBOARD\0"
+              "HID_DEVICE_UP:0001_U:0006\0HID_DEVICE\0" },
+            { "HID-compliant mouse",
+              "HID\\VID_046D&PID_C52B&REV_1211&MI_01&Col01\0HID\\VID_046D&PID_C52B&MI_01&Col01\0HID\\VID_046D&UP:0001_U:0002\0"
+              "HID_DEVICE_SYSTEM_MOUSE\0HID_DEVICE_UP:0001_U:0002\0HID_DEVICE\0" },
+            { "HID-compliant consumer control device",
+              "HID\\VID_046D&PID_C52B&REV_1211&MI_01&Col02\0HID\\VID_046D&PID_C52B&MI_01&Col02\0HID\\VID_046D&UP:000C_U:0001\0"
+              "HID_DEVICE_SYSTEM_CONSUMER\0HID_DEVICE_UP:000C_U:0001\0HID_DEVICE\0" },
+            { "HID-compliant game controller",
+              "HID\\VID_054C&PID_09CC&REV_0100\0HID\\VID_054C&PID_09CC\0HID\\VID_054C&UP:0001_U:0005\0HID_DEVICE_SYSTEM_GAME\0"
+              "HID_DEVICE_UP:0001_U:0005\0HID_DEVICE\0" },
+
+            // ACPI and software devices, mostly without usable IDs
+            { "Microsoft ACPI-Compliant Control Method Battery", "ACPI\\VEN_PNP&DEV_0C0A\0ACPI\\PNP0C0A\0*PNP0C0A\0" },
+            { "ACPI Power Button", "ACPI\\VEN_PNP&DEV_0C0C\0ACPI\\PNP0C0C\0*PNP0C0C\0" },
+            { "Motherboard resources", "ACPI\\VEN_PNP&DEV_0C02\0ACPI\\PNP0C02\0*PNP0C02\0" },
+            { "Generic software device", "SWD\\GenericRaw\0SWD\\Generic\0" },
+            { "Microsoft Basic Display Driver", "ROOT\\BasicDisplay\0" },
+            { "", "ROOT\\LEGACY_BEEP\0" },
+        };
+
+        constexpr size_t g_corpus_device_count = std::size( g_hardware_id_corpus );
+
+        /**
+         * @brief VAC's token search as shipped: strstr() over the joined buffer, VID/PID tokens only on fallback
+         */
+        bool extract_device_identity_strstr( const char *device_buffer, common::pnp_device_entry_t *device ) {
+            unsigned int vendor_id_result  = 0;
+            unsigned int product_id_result = 0;
+            unsigned int class_code_result = 0;
+            unsigned int device_type_flag;
+
+            const char *string_search_pos = strstr( device_buffer, "VEN_" );
+            const char *dev_search_pos    = strstr( device_buffer, "DEV_" );
+            const char *cc_search_pos     = strstr( device_buffer, "CC_" );
+
+            if ( cc_search_pos ) {
+                while ( parse_hex_string( reinterpret_cast< intptr_t >( cc_search_pos + 3 ), 6u, &class_code_result ) ) {
+                    cc_search_pos = strstr( cc_search_pos + 3, "CC_" );
+                    if ( !cc_search_pos )
+                        break;
+                }
+                if ( cc_search_pos )
+                    class_code_result = class_code_result >> 8; // Extract class code
+            }
+
+            if ( !string_search_pos || !dev_search_pos
+                 || parse_hex_string( reinterpret_cast< intptr_t >( string_search_pos + 4 ), 4u, &vendor_id_result )
+                 || parse_hex_string( reinterpret_cast< intptr_t >( dev_search_pos + 4 ), 4u, &product_id_result ) ) {
+                // Fallback method: try VID/PID and various class code formats
+                const char *vid_search_pos      = strstr( device_buffer, "VID_" );
+                const char *pid_search_pos      = strstr( device_buffer, "PID_" );
+                const char *devclass_search_pos = strstr( device_buffer, "DevClass_" );
+                const char *class_search_pos    = strstr( device_buffer, "\\Class_" );
+                const char *subclass_search_pos = strstr( device_buffer, "SubClass_" );
+                const char *prot_search_pos     = strstr( device_buffer, "Prot_" );
+
+                // VAC searches \Class_ but never reads it
+                static_cast< void >( class_search_pos );
+
+                if ( !vid_search_pos || !pid_search_pos )
+                    return false;
+
+                product_id_result            = 0;
+                vendor_id_result             = 0;
+                unsigned int temp_class_code = 0;
+                unsigned int temp_vendor_id  = 0;
+
+                if ( parse_hex_string( reinterpret_cast< intptr_t >( vid_search_pos + 4 ), 4u, &vendor_id_result )
+                     || parse_hex_string( reinterpret_cast< intptr_t >( pid_search_pos + 4 ), 4u, &product_id_result ) )
+                    return false;
+
+                if ( devclass_search_pos )
+                    parse_hex_string( reinterpret_cast< intptr_t >( devclass_search_pos + 9 ), 2u, &class_code_result );
+                if ( subclass_search_pos )
+                    parse_hex_string( reinterpret_cast< intptr_t >( subclass_search_pos + 9 ), 2u, &temp_vendor_id );
+                if ( prot_search_pos )
+                    parse_hex_string( reinterpret_cast< intptr_t >( prot_search_pos + 5 ), 2u, &temp_class_code );
+
+                class_code_result
+                    = static_cast< unsigned char >( temp_vendor_id )
+                    | ( ( ( static_cast< unsigned char >( class_code_result ) | ( static_cast< unsigned char >( temp_class_code ) << 8 ) )
+                          << 8 ) );
+                device_type_flag = 2; // Fallback method
+            } else {
+                device_type_flag = 1; // Primary method
+            }
+
+            device->m_type_and_class = device_type_flag | ( class_code_result << 8 );
+            device->m_vendor_id      = static_cast< uint16_t >( vendor_id_result );
+            device->m_product_id     = static_cast< uint16_t >( product_id_result );
+            return true;
+        }
+
+        /**
+         * @brief Parse outcome of one device, compared between the two paths
+         */
+        struct parsed_identity_t {
+            bool                       m_has_identity = { }; ///< A VEN/DEV or VID/PID pair was parsed
+            common::pnp_device_entry_t m_device       = { }; ///< Parsed entry
+        };
+
+        bool identities_equal( const parsed_identity_t &lhs, const parsed_identity_t &rhs ) {
+            if ( lhs.m_has_identity != rhs.m_has_identity )
+                return false;
+
+            return !lhs.m_has_identity
+                || ( lhs.m_device.m_type_and_class == rhs.m_device.m_type_and_class && lhs.m_device.m_vendor_id == rhs.m_device.m_vendor_id
+                     && lhs.m_device.m_product_id == rhs.m_device.m_product_id );
+        }
+
+        /**
+         * @brief Fill the raw properties of a corpus device like a device source would
+         */
+        void build_properties( const corpus_device_t &corpus_device, pnp_device_properties_t *properties ) {
+            *properties = { };
+
+            const size_t description_size = std::min( strlen( corpus_device.m_description ) + 1, g_pnp_property_buffer_size );
+            memcpy( properties->m_description, corpus_device.m_description, description_size );
+            properties->m_description_size = static_cast< uint32_t >( description_size );
+
+            // Multi-sz: strings up to and including the empty one that ends the list
+            size_t hardware_ids_size = 0;
+            while ( corpus_device.m_hardware_ids[ hardware_ids_size ] )
+                hardware_ids_size += strlen( corpus_device.m_hardware_ids + hardware_ids_size ) + 1;
+
+            hardware_ids_size = std::min( hardware_ids_size + 1, g_pnp_property_buffer_size );
+            memcpy( properties->m_hardware_ids, corpus_device.m_hardware_ids, hardware_ids_size );
+            properties->m_hardware_ids_size = static_cast< uint32_t >( hardware_ids_size );
+        }
+
+        /**
+         * @brief VAC's joined buffer: description, then the hardware IDs separated by newlines
+         */
+        void build_joined_buffer( const pnp_device_properties_t &properties, std::vector< char > *device_buffer ) {
+            device_buffer->assign( properties.m_description, properties.m_description + strlen( properties.m_description ) );
+
+            const char *hardware_id = properties.m_hardware_ids;
+            while ( *hardware_id ) {
+                const size_t hardware_id_length = strlen( hardware_id );
+
+                device_buffer->insert( device_buffer->end( ), hardware_id, hardware_id + hardware_id_length );
+                device_buffer->push_back( '\n' );
+                hardware_id += hardware_id_length + 1;
+            }
+
+            device_buffer->push_back( 0 );
+        }
+    } // namespace
+
+    int run_hardware_id_matcher_benchmark( const hardware_id_matcher_benchmark_config_t &config,
+                                           hardware_id_matcher_benchmark_report_t        *report ) {
+        *report = { };
+
+        std::vector< pnp_device_properties_t > properties( g_corpus_device_count );
+        std::vector< std::vector< char > >     device_buffers( g_corpus_device_count );
+        uint64_t                               corpus_bytes = 0;
+
+        for ( size_t device_index = 0; device_index < g_corpus_device_count; ++device_index ) {
+            build_properties( g_hardware_id_corpus[ device_index ], &properties[ device_index ] );
+            build_joined_buffer( properties[ device_index ], &device_buffers[ device_index ] );
+            corpus_bytes += properties[ device_index ].m_description_size + properties[ device_index ].m_hardware_ids_size;
+        }
+
+        const utils::clock_source_t &clock  = utils::precise_clock( );
+        const uint32_t               rounds = std::max< uint32_t >( config.m_rounds, 1 );
+        const uint32_t               passes = std::max< uint32_t >( config.m_passes, 1 );
+
+        std::vector< parsed_identity_t > strstr_identities( g_corpus_device_count );
+        std::vector< parsed_identity_t > automaton_identities( g_corpus_device_count );
+
+        uint64_t best_strstr_ns    = std::numeric_limits< uint64_t >::max( );
+        uint64_t best_automaton_ns = std::numeric_limits< uint64_t >::max( );
+
+        for ( uint32_t round = 0; round < rounds; ++round ) {
+            uint64_t started_at = clock.now_ns( );
+
+            for ( uint32_t pass = 0; pass < passes; ++pass ) {
+                for ( size_t device_index = 0; device_index < g_corpus_device_count; ++device_index ) {
+                    parsed_identity_t &identity = strstr_identities[ device_index ];
+                    identity.m_has_identity     = extract_device_identity_strstr( device_buffers[ device_index ].data( ), &identity.m_device );
+                }
+            }
+
+            best_strstr_ns = std::min( best_strstr_ns, clock.now_ns( ) - started_at );
+            started_at     = clock.now_ns( );
+
+            for ( uint32_t pass = 0; pass < passes; ++pass ) {
+                for ( size_t device_index = 0; device_index < g_corpus_device_count; ++device_index ) {
+                    const pnp_device_properties_t &device_properties = properties[ device_index ];
+                    parsed_identity_t             &identity          = automaton_identities[ device_index ];
+                    hardware_id_tokens_t           tokens;
+
+                    scan_hardware_id_tokens( device_properties.m_description, device_properties.m_description_size, &tokens );
+                    scan_hardware_id_tokens( device_properties.m_hardware_ids, device_properties.m_hardware_ids_size, &tokens );
+                    identity.m_has_identity = extract_device_identity( &tokens, &identity.m_device );
+                }
+            }
+
+            best_automaton_ns = std::min( best_automaton_ns, clock.now_ns( ) - started_at );
+
+            for ( size_t device_index = 0; device_index < g_corpus_device_count; ++device_index ) {
+                if ( !identities_equal( strstr_identities[ device_index ], automaton_identities[ device_index ] ) )
+                    ++report->m_mismatches;
+            }
+        }
+
+        const double device_runs = static_cast< double >( passes ) * g_corpus_device_count;
+
+        report->m_devices          = static_cast< uint32_t >( g_corpus_device_count );
+        report->m_bytes_per_device = static_cast< uint32_t >( corpus_bytes / g_corpus_device_count );
+        report->m_strstr_ns        = static_cast< double >( best_strstr_ns ) / device_runs;
+        report->m_automaton_ns     = static_cast< double >( best_automaton_ns ) / device_runs;
+
+        return report->m_mismatches ? 1 : 0;
+    }
+} // namespace vac::modules::pnp_device_scanner
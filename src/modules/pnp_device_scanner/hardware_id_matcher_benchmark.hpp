@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+
+namespace vac::modules::pnp_device_scanner {
+    /**
+     * @brief Parameters of run_hardware_id_matcher_benchmark()
+     */
+    struct hardware_id_matcher_benchmark_config_t {
+        uint32_t m_rounds = 5;    ///< Timed rounds per matcher, the fastest is reported
+        uint32_t m_passes = 2000; ///< Passes over the corpus per round
+    };
+
+    /**
+     * @brief Results of run_hardware_id_matcher_benchmark()
+     */
+    struct hardware_id_matcher_benchmark_report_t {
+        uint32_t m_devices          = { }; ///< Devices in the corpus
+        uint32_t m_bytes_per_device = { }; ///< Mean description plus hardware ID bytes per device
+        double   m_strstr_ns        = { }; ///< VAC's strstr() chain, nanoseconds per device
+        double   m_automaton_ns     = { }; ///< scan_hardware_id_tokens() plus extract_device_identity(), nanoseconds per device
+        uint32_t m_mismatches       = { }; ///< Devices where the two paths parsed a different identity
+    };
+
+    /**
+     * @brief Compare the single-pass token matcher with VAC's strstr() chain
+     *
+     * The corpus holds description and hardware ID strings of real PCI, HDAUDIO, USB
+     * (including composite interfaces), HID and ACPI devices. The strstr() path runs over
+     * VAC's joined buffer (description followed by newline separated hardware IDs) with
+     * the original search order and CC_ retry; the automaton path scans the description
+     * and the multi-sz in place, as parse_device_properties() does. Both parse the IDs with
+     * parse_hex_string(), and every parsed identity is compared after each round.
+     *
+     * @param config Run length
+     * @param report Receives the per-device costs
+     * @return 0 if both paths agreed on every device, 1 otherwise
+     */
+    int run_hardware_id_matcher_benchmark( const hardware_id_matcher_benchmark_config_t &config,
+                                           hardware_id_matcher_benchmark_report_t        *report );
+} // namespace vac::modules::pnp_device_scanner
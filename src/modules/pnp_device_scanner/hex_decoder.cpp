@@ -0,0 +1,50 @@
+#include "hex_decoder.hpp"
+
+#include <array>
+
+namespace vac::modules::pnp_device_scanner {
+    namespace {
+        constexpr uint8_t g_hex_null_character    = 0x10; ///< Table marker: terminator reached (return code 2)
+        constexpr uint8_t g_hex_invalid_character = 0x20; ///< Table marker: not a hex digit (return code 3)
+
+        constexpr std::array< uint8_t, 256 > build_hex_digit_table( ) {
+            std::array< uint8_t, 256 > table = { };
+
+            for ( auto &entry : table )
+                entry = g_hex_invalid_character;
+
+            table[ 0 ] = g_hex_null_character;
+
+            for ( uint8_t digit = 0; digit < 10; ++digit )
+                table[ '0' + digit ] = digit;
+
+            for ( uint8_t digit = 0; digit < 6; ++digit ) {
+                table[ 'a' + digit ] = static_cast< uint8_t >( 10 + digit );
+                table[ 'A' + digit ] = static_cast< uint8_t >( 10 + digit );
+            }
+
+            return table;
+        }
+
+        constexpr std::array< uint8_t, 256 > g_hex_digit_table = build_hex_digit_table( );
+    } // namespace
+
+    int decode_hex_field( const char *text, const unsigned int length, uint32_t *result ) {
+        uint32_t current_value = 0;
+
+        for ( unsigned int char_index = 0; char_index < length; ++char_index ) {
+            const uint8_t hex_digit = g_hex_digit_table[ static_cast< uint8_t >( text[ char_index ] ) ];
+
+            if ( hex_digit & ( g_hex_null_character | g_hex_invalid_character ) )
+                return hex_digit == g_hex_null_character ? 2 : 3;
+
+            if ( length <= 8 )
+                current_value = ( current_value << 4 ) | hex_digit;
+            else
+                current_value += static_cast< uint32_t >( hex_digit ) << ( ( 4 * ( length - char_index ) - 4 ) & 31 );
+        }
+
+        *result = current_value;
+        return 0;
+    }
+} // namespace vac::modules::pnp_device_scanner
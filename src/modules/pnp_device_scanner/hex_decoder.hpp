@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstdint>
+
+namespace vac::modules::pnp_device_scanner {
+    /**
+     * @brief Decode a fixed-width hexadecimal field
+     *
+     * Same contract as VAC's parse_hex_string: characters are validated left to right,
+     * the first offending character decides the error and result is left untouched on
+     * failure. Upper and lower case digits are accepted.
+     *
+     * Each byte goes through a 256-entry table that maps it to a nibble, a terminator
+     * marker or an invalid marker. For widths above 8 digits the per-digit shift wraps
+     * modulo 32 like the x86 shift in the original parser, so results stay bit-identical
+     * for every length.
+     *
+     * @param text Characters to decode
+     * @param length Number of hex digits expected
+     * @param result Receives the decoded value on success
+     * @return 0 on success
+     * @return 2 if a null character is encountered
+     * @return 3 if an invalid hex character is found
+     */
+    int decode_hex_field( const char *text, unsigned int length, uint32_t *result );
+} // namespace vac::modules::pnp_device_scanner
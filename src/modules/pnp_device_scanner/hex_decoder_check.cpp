@@ -0,0 +1,105 @@
+#include "hex_decoder_check.hpp"
+#include "hex_decoder.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <memory>
+
+namespace vac::modules::pnp_device_scanner {
+    namespace {
+        constexpr uint32_t g_untouched_result = 0xA5A5A5A5; ///< Result preset, must survive a failed decode
+
+        constexpr char g_check_alphabet[] = { '0', '9', 'a', 'f', 'A', 'F', 'g', 'G', '/', ':', '@', '`', ' ', '\x80', '\xFF' };
+
+        /**
+         * @brief VAC's parse_hex_string as shipped, the reference decode_hex_field() must match
+         *
+         * Only the per-digit shift is masked to 31 and done unsigned, which is what the x86
+         * shift instruction did for widths above 8.
+         */
+        int parse_hex_string_original( const char *hex_string, const unsigned int length, uint32_t *result ) {
+            uint32_t current_value = 0;
+
+            for ( unsigned int char_index = 0; char_index < length; ++char_index ) {
+                const char current_char = hex_string[ char_index ];
+                if ( !current_char )
+                    return 2; // Null character encountered
+
+                // Convert to lowercase
+                char processed_char = current_char + 32;
+                if ( static_cast< unsigned int >( current_char - 65 ) > 0x19 )
+                    processed_char = current_char;
+
+                unsigned char hex_digit;
+                if ( static_cast< unsigned char >( processed_char - 48 ) > 9u ) {
+                    if ( static_cast< unsigned char >( processed_char - 97 ) > 5u )
+                        return 3; // Invalid hex character
+
+                    hex_digit = static_cast< unsigned char >( processed_char - 87 ); // a-f -> 10-15
+                } else {
+                    hex_digit = static_cast< unsigned char >( processed_char - 48 ); // 0-9 -> 0-9
+                }
+
+                current_value += static_cast< uint32_t >( hex_digit ) << ( ( 4 * ( length - char_index ) - 4 ) & 31 );
+            }
+
+            *result = current_value;
+            return 0;
+        }
+
+        /**
+         * @brief Decode one string at every width and count disagreements
+         */
+        void check_string( const char *text, const size_t text_length, const uint32_t max_field_width, hex_decoder_check_report_t *report ) {
+            for ( uint32_t width = 0; width <= max_field_width; ++width ) {
+                uint32_t expected_result = g_untouched_result;
+                uint32_t decoded_result  = g_untouched_result;
+
+                const int expected_code = parse_hex_string_original( text, width, &expected_result );
+                const int decoded_code  = decode_hex_field( text, width, &decoded_result );
+
+                ++report->m_inputs;
+
+                if ( decoded_code == expected_code && decoded_result == expected_result )
+                    continue;
+
+                if ( !report->m_mismatches++ ) {
+                    memcpy( report->m_first_mismatch, text, text_length );
+                    report->m_first_mismatch_width = width;
+                }
+            }
+        }
+    } // namespace
+
+    int run_hex_decoder_check( const hex_decoder_check_config_t &config, hex_decoder_check_report_t *report ) {
+        *report = { };
+
+        const uint32_t exhaustive_bytes = std::min< uint32_t >( config.m_exhaustive_bytes, 3 );
+        const uint32_t alphabet_length  = std::min< uint32_t >( config.m_alphabet_length, g_hex_check_max_text - 1 );
+
+        for ( uint32_t text_length = 0; text_length <= std::max( exhaustive_bytes, alphabet_length ); ++text_length ) {
+            // Sized to the string and its terminator, nothing readable follows
+            const std::unique_ptr< char[] > text( new char[ text_length + 1 ] );
+            text[ text_length ] = 0;
+
+            const bool     exhaustive   = text_length <= exhaustive_bytes;
+            const uint64_t symbol_count = exhaustive ? 256 : std::size( g_check_alphabet );
+            uint64_t       combinations = 1;
+            for ( uint32_t char_index = 0; char_index < text_length; ++char_index )
+                combinations *= symbol_count;
+
+            for ( uint64_t combination = 0; combination < combinations; ++combination ) {
+                uint64_t digits = combination;
+                for ( uint32_t char_index = 0; char_index < text_length; ++char_index, digits /= symbol_count ) {
+                    const uint64_t symbol = digits % symbol_count;
+                    text[ char_index ]    = exhaustive ? static_cast< char >( symbol ) : g_check_alphabet[ symbol ];
+                }
+
+                check_string( text.get( ), text_length, config.m_max_field_width, report );
+            }
+        }
+
+        return report->m_mismatches ? 1 : 0;
+    }
+} // namespace vac::modules::pnp_device_scanner
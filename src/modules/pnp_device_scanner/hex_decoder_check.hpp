@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace vac::modules::pnp_device_scanner {
+    constexpr size_t g_hex_check_max_text = 16; ///< Longest input the check builds, terminator included
+
+    /**
+     * @brief Parameters of run_hex_decoder_check()
+     */
+    struct hex_decoder_check_config_t {
+        uint32_t m_exhaustive_bytes = 3;  ///< Every byte string up to this length is checked, at most 3 (256^n strings each)
+        uint32_t m_alphabet_length  = 6;  ///< Longer strings up to this length are built from a small alphabet
+        uint32_t m_max_field_width  = 10; ///< Widths 0..this are decoded for every string, above 8 takes the wrapping path
+    };
+
+    /**
+     * @brief Results of run_hex_decoder_check()
+     */
+    struct hex_decoder_check_report_t {
+        uint64_t m_inputs                                 = { }; ///< (string, width) pairs compared
+        uint64_t m_mismatches                             = { }; ///< Pairs where decode_hex_field() disagreed with the original parser
+        char     m_first_mismatch[ g_hex_check_max_text ] = { }; ///< String of the first mismatch, null terminated
+        uint32_t m_first_mismatch_width                   = { }; ///< Field width of the first mismatch
+    };
+
+    /**
+     * @brief Compare decode_hex_field() with VAC's original parse_hex_string
+     *
+     * Every byte string up to m_exhaustive_bytes long, then every string up to m_alphabet_length
+     * over an alphabet of digits, letters around the a-f / A-F ranges, separators and high
+     * bytes, is decoded at every field width up to m_max_field_width. Return code and result
+     * must match, including a result left untouched on failure. Each string sits at the end of
+     * its own allocation, right before its terminator, so a decoder reading past the terminator
+     * is caught by AddressSanitizer builds.
+     *
+     * @param config Input space
+     * @param report Receives the counts and the first mismatch
+     * @return 0 if every input matched, 1 otherwise
+     */
+    int run_hex_decoder_check( const hex_decoder_check_config_t &config, hex_decoder_check_report_t *report );
+} // namespace vac::modules::pnp_device_scanner
@@ -0,0 +1,192 @@
+#include "pnp_change_monitor.hpp"
+#include "../../utils/vac_clock_utils.hpp"
+#include "../../utils/vac_instrumentation.hpp"
+
+#if defined( _WIN32 )
+#include <windows.h>
+
+#include <cfgmgr32.h>
+#elif defined( __linux__ )
+#include <cerrno>
+#include <cstring>
+#include <linux/netlink.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace vac::modules::pnp_device_scanner {
+#if defined( _WIN32 )
+    namespace {
+        DWORD CALLBACK on_device_change( [[maybe_unused]] HCMNOTIFICATION notification, PVOID context,
+                                         [[maybe_unused]] CM_NOTIFY_ACTION action, [[maybe_unused]] PCM_NOTIFY_EVENT_DATA event_data,
+                                         [[maybe_unused]] DWORD event_data_size ) {
+            // Any instance event invalidates the cached scan, no need to look at the action
+            static_cast< std::atomic< uint64_t > * >( context )->fetch_add( 1, std::memory_order_release );
+            return ERROR_SUCCESS;
+        }
+    } // namespace
+#elif defined( __linux__ )
+    namespace {
+        constexpr const char *g_watched_bus_directories[] = { "/bus/pci/devices", "/bus/usb/devices" };
+        constexpr const char *g_live_sysfs_root           = "/sys";
+        constexpr uint32_t    g_kernel_uevent_group       = 1;    ///< Multicast group of kernel uevents, udev rebroadcasts on 2
+        constexpr size_t      g_uevent_buffer_size        = 4096; ///< Larger than the kernel's UEVENT_BUFFER_SIZE, messages are never truncated
+
+        /**
+         * @brief Open a non-blocking socket receiving the kernel's uevents
+         * @return Socket descriptor, -1 if netlink is unavailable (e.g. seccomp or no permission)
+         */
+        int open_uevent_socket( ) {
+            VAC_COUNT_SYSCALL( );
+            const int uevent_socket = socket( AF_NETLINK, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, NETLINK_KOBJECT_UEVENT );
+            if ( uevent_socket < 0 )
+                return -1;
+
+            sockaddr_nl address = { };
+            address.nl_family   = AF_NETLINK;
+            address.nl_groups   = g_kernel_uevent_group;
+
+            VAC_COUNT_SYSCALL( );
+            if ( bind( uevent_socket, reinterpret_cast< const sockaddr * >( &address ), sizeof( address ) ) ) {
+                close( uevent_socket );
+                return -1;
+            }
+
+            return uevent_socket;
+        }
+
+        /**
+         * @brief Read every queued uevent
+         * @return Number of device add/remove events, overflowed queues count as one
+         */
+        uint64_t drain_uevents( const int uevent_socket ) {
+            char     message[ g_uevent_buffer_size ];
+            uint64_t changes = 0;
+
+            for ( ;; ) {
+                VAC_COUNT_SYSCALL( );
+                const ssize_t received = recv( uevent_socket, message, sizeof( message ) - 1, 0 );
+                if ( received < 0 ) {
+                    if ( errno == EINTR )
+                        continue;
+
+                    // ENOBUFS: events were dropped, assume one of them was a change
+                    if ( errno == ENOBUFS )
+                        ++changes;
+
+                    return changes;
+                }
+
+                // Header is "<action>@<devpath>"; bind, change, move etc. don't add or remove a device
+                message[ received ] = '\0';
+                if ( !strncmp( message, "add@", 4 ) || !strncmp( message, "remove@", 7 ) )
+                    ++changes;
+            }
+        }
+
+        uint64_t fold_directory_mtime( const uint64_t token, const std::string &path ) {
+            struct stat directory_stat = { };
+            VAC_COUNT_SYSCALL( );
+            if ( stat( path.c_str( ), &directory_stat ) )
+                return token * 0x100000001B3ULL; // Missing bus, still deterministic
+
+            const uint64_t mtime_ns
+                = static_cast< uint64_t >( directory_stat.st_mtim.tv_sec ) * 1000000000ULL + static_cast< uint64_t >( directory_stat.st_mtim.tv_nsec );
+
+            return ( token ^ mtime_ns ^ directory_stat.st_ino ) * 0x100000001B3ULL;
+        }
+    } // namespace
+#endif
+
+    pnp_change_monitor_t::pnp_change_monitor_t( const char *sysfs_root ) : m_sysfs_root( sysfs_root ) { }
+
+    pnp_change_monitor_t::~pnp_change_monitor_t( ) { stop( ); }
+
+    bool pnp_change_monitor_t::start( ) {
+        if ( m_running )
+            return true;
+
+#if defined( _WIN32 )
+        CM_NOTIFY_FILTER filter = { };
+        filter.cbSize           = sizeof( CM_NOTIFY_FILTER );
+        filter.Flags            = CM_NOTIFY_FILTER_FLAG_ALL_DEVICE_INSTANCES;
+        filter.FilterType       = CM_NOTIFY_FILTER_TYPE_DEVICEINSTANCE;
+
+        m_generation.store( 1, std::memory_order_relaxed );
+
+        HCMNOTIFICATION notification = nullptr;
+        VAC_COUNT_SYSCALL( );
+        if ( CM_Register_Notification( &filter, &m_generation, on_device_change, &notification ) != CR_SUCCESS ) {
+            m_generation.store( g_pnp_generation_unknown, std::memory_order_relaxed );
+            return false;
+        }
+
+        m_notification = notification;
+#elif defined( __linux__ )
+        struct stat root_stat = { };
+        VAC_COUNT_SYSCALL( );
+        if ( stat( m_sysfs_root.c_str( ), &root_stat ) )
+            return false;
+
+        // uevents describe the running system, a fixture root only has its mtimes
+        if ( m_sysfs_root == g_live_sysfs_root )
+            m_uevent_socket = open_uevent_socket( );
+
+        m_generation.store( 1, std::memory_order_relaxed );
+#else
+        return false;
+#endif
+
+        m_running = true;
+        return true;
+    }
+
+    void pnp_change_monitor_t::stop( ) {
+        if ( !m_running )
+            return;
+
+#if defined( _WIN32 )
+        // Blocks until in-flight callbacks are done, so m_generation stays valid for them
+        VAC_COUNT_SYSCALL( );
+        CM_Unregister_Notification( static_cast< HCMNOTIFICATION >( m_notification ) );
+        m_notification = nullptr;
+#elif defined( __linux__ )
+        if ( m_uevent_socket >= 0 ) {
+            close( m_uevent_socket );
+            m_uevent_socket = -1;
+        }
+#endif
+
+        m_generation.store( g_pnp_generation_unknown, std::memory_order_relaxed );
+        m_running = false;
+    }
+
+    uint64_t pnp_change_monitor_t::generation( ) const {
+        if ( !m_running )
+            return g_pnp_generation_unknown;
+
+#if defined( _WIN32 )
+        return m_generation.load( std::memory_order_acquire );
+#elif defined( __linux__ )
+        if ( m_uevent_socket >= 0 ) {
+            const uint64_t changes = drain_uevents( m_uevent_socket );
+            if ( changes )
+                return m_generation.fetch_add( changes, std::memory_order_acq_rel ) + changes;
+
+            return m_generation.load( std::memory_order_acquire );
+        }
+
+        // Directory mtimes can miss a hotplug, so the token also rolls over with the replay window
+        uint64_t token = 0xCBF29CE484222325ULL;
+        for ( const char *bus_directory : g_watched_bus_directories )
+            token = fold_directory_mtime( token, m_sysfs_root + bus_directory );
+
+        token = ( token ^ ( utils::platform_clock( ).now_ms( ) / g_pnp_generation_max_replay_ms ) ) * 0x100000001B3ULL;
+
+        return token == g_pnp_generation_unknown ? 1 : token;
+#else
+        return g_pnp_generation_unknown;
+#endif
+    }
+} // namespace vac::modules::pnp_device_scanner
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace vac::modules::pnp_device_scanner {
+    constexpr uint64_t g_pnp_generation_unknown       = 0;    ///< Returned while no change source is available
+    constexpr uint64_t g_pnp_generation_max_replay_ms = 5000; ///< Longest a generation is kept without an event source (Linux mtime fallback)
+
+    /**
+     * @brief Cheap "did the device tree change" probe for incremental PnP scans
+     *
+     * Windows: CM_Register_Notification for all device instances; every enumerate,
+     * start or remove event bumps the generation counter from the notification thread.
+     *
+     * Linux: for the live "/sys", a NETLINK_KOBJECT_UEVENT socket drained on every
+     * generation() call; each kernel add or remove event bumps the generation. Other roots,
+     * or a socket that cannot be opened, fall back to the mtimes of <sysfs_root>/bus/pci/devices
+     * and <sysfs_root>/bus/usb/devices, which sysfs does not reliably update on hotplug, so
+     * that token also changes every g_pnp_generation_max_replay_ms.
+     *
+     * Equal generation values mean no change was observed in between; the value itself
+     * has no meaning and never equals g_pnp_generation_unknown once started.
+     */
+    class pnp_change_monitor_t {
+    public:
+        /**
+         * @param sysfs_root Root of the sysfs tree to watch (Linux only)
+         */
+        explicit pnp_change_monitor_t( const char *sysfs_root = "/sys" );
+        ~pnp_change_monitor_t( );
+
+        pnp_change_monitor_t( const pnp_change_monitor_t & )             = delete;
+        pnp_change_monitor_t &operator=( const pnp_change_monitor_t & ) = delete;
+
+        /**
+         * @brief Start watching for device changes
+         * @return true if change notifications are available
+         */
+        bool start( );
+
+        /**
+         * @brief Stop watching, generation() reports g_pnp_generation_unknown afterwards
+         */
+        void stop( );
+
+        /**
+         * @brief Current change generation
+         * @return Change token, g_pnp_generation_unknown if the monitor is not running
+         */
+        uint64_t generation( ) const;
+
+    private:
+        mutable std::atomic< uint64_t > m_generation    = { g_pnp_generation_unknown }; ///< Bumped by the notification callback (Windows) or per drained uevent (Linux)
+        void                           *m_notification  = { };                          ///< HCMNOTIFICATION of the registration (Windows)
+        std::string                     m_sysfs_root;                                   ///< Watched sysfs root (Linux)
+        int                             m_uevent_socket = -1;                           ///< Non-blocking kernel uevent socket, -1 when using the mtime fallback (Linux)
+        bool                            m_running       = { };                          ///< start() succeeded
+    };
+} // namespace vac::modules::pnp_device_scanner
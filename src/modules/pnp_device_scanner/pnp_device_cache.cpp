@@ -0,0 +1,62 @@
+#include "pnp_device_cache.hpp"
+#include "pnp_change_monitor.hpp"
+
+namespace vac::modules::pnp_device_scanner {
+    void pnp_device_cache_t::begin_pass( ) { ++m_pass; }
+
+    const pnp_cached_device_t *pnp_device_cache_t::find( const char *instance_id ) {
+        const auto instance = m_instances.find( instance_id );
+        if ( instance == m_instances.end( ) )
+            return nullptr;
+
+        instance->second.m_last_pass = m_pass;
+        return &instance->second.m_device;
+    }
+
+    void pnp_device_cache_t::store( const char *instance_id, const pnp_cached_device_t &device ) {
+        instance_slot_t &slot = m_instances[ instance_id ];
+        slot.m_device         = device;
+        slot.m_last_pass      = m_pass;
+    }
+
+    size_t pnp_device_cache_t::end_pass( ) {
+        size_t dropped = 0;
+
+        for ( auto instance = m_instances.begin( ); instance != m_instances.end( ); ) {
+            if ( instance->second.m_last_pass != m_pass ) {
+                instance = m_instances.erase( instance );
+                ++dropped;
+            } else {
+                ++instance;
+            }
+        }
+
+        return dropped;
+    }
+
+    bool pnp_device_cache_t::replay( const uint64_t generation, pnp_result_store_t *results ) const {
+        if ( generation == g_pnp_generation_unknown || generation != m_result_generation )
+            return false;
+
+        // The entries are still in place unless the store was rewritten since remember()
+        if ( results != m_result_store || results->revision( ) != m_result_revision )
+            return false;
+
+        results->m_error_code = m_result_error;
+        results->m_scan_flags = m_result_flags;
+        return true;
+    }
+
+    void pnp_device_cache_t::remember( const uint64_t generation, const pnp_result_store_t &results ) {
+        m_result_generation = generation;
+        m_result_store      = &results;
+        m_result_revision   = results.revision( );
+        m_result_error      = results.m_error_code;
+        m_result_flags      = results.m_scan_flags;
+    }
+
+    void pnp_device_cache_t::invalidate( ) {
+        m_result_generation = g_pnp_generation_unknown;
+        m_result_store      = nullptr;
+    }
+} // namespace vac::modules::pnp_device_scanner
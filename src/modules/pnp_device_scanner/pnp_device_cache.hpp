@@ -0,0 +1,97 @@
+#pragma once
+
+#include "../../common/types.hpp"
+#include "pnp_result_store.hpp"
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+namespace vac::modules::pnp_device_scanner {
+    /**
+     * @brief Parse outcome remembered for one device instance
+     */
+    struct pnp_cached_device_t {
+        common::pnp_device_entry_t m_device       = { }; ///< Parsed (type, class, VID, PID), valid if m_has_identity
+        uint32_t                   m_scan_flags   = { }; ///< Scan flags raised while reading this instance's properties
+        bool                       m_has_identity = { }; ///< false if the instance had no usable VEN/DEV or VID/PID
+    };
+
+    /**
+     * @brief Persistent PnP scan state shared by successive enumerate_pnp_devices() calls
+     *
+     * Two levels:
+     * - Per device instance ID: the parsed identity, so a rescan only reads the registry
+     *   properties of instances it has not seen before. Instances missing from a full
+     *   pass are dropped at end_pass().
+     * - Whole result: the store holding the last complete scan result, tagged with the
+     *   change generation it was built under. While the generation does not move and the
+     *   store still holds that result it is handed back as-is; no copy is kept here.
+     *
+     * Not thread safe; the scanner serialises access.
+     */
+    class pnp_device_cache_t {
+    public:
+        /**
+         * @brief Start a full pass over the device list
+         */
+        void begin_pass( );
+
+        /**
+         * @brief Look up an instance and mark it as present in the current pass
+         * @param instance_id Device instance ID
+         * @return Cached parse outcome, nullptr if the instance is new
+         */
+        const pnp_cached_device_t *find( const char *instance_id );
+
+        /**
+         * @brief Remember the parse outcome of an instance seen in the current pass
+         * @param instance_id Device instance ID
+         * @param device Parse outcome
+         */
+        void store( const char *instance_id, const pnp_cached_device_t &device );
+
+        /**
+         * @brief Finish a full pass and forget instances that were not seen in it
+         * @return Number of instances dropped
+         */
+        size_t end_pass( );
+
+        /**
+         * @brief Check that a store still holds the remembered result and it was built under the same generation
+         * @param generation Current change generation
+         * @param results Store passed to remember(), its status fields are restored
+         * @return true if results holds the remembered result
+         */
+        bool replay( uint64_t generation, pnp_result_store_t *results ) const;
+
+        /**
+         * @brief Remember which store holds a complete scan result
+         * @param generation Change generation sampled before the scan started
+         * @param results Finished scan result, must outlive the cache or be invalidated first
+         */
+        void remember( uint64_t generation, const pnp_result_store_t &results );
+
+        /**
+         * @brief Forget the remembered result, instance entries are kept
+         */
+        void invalidate( );
+
+        size_t instance_count( ) const { return m_instances.size( ); }
+
+    private:
+        struct instance_slot_t {
+            pnp_cached_device_t m_device    = { }; ///< Parse outcome
+            uint64_t            m_last_pass = { }; ///< Pass in which the instance was last seen
+        };
+
+        std::unordered_map< std::string, instance_slot_t > m_instances;
+
+        uint64_t                  m_pass              = { }; ///< Current pass number
+        uint64_t                  m_result_generation = { }; ///< Generation of the remembered result, 0 if none
+        const pnp_result_store_t *m_result_store      = { }; ///< Store holding the remembered result
+        uint64_t                  m_result_revision   = { }; ///< Store revision when the result was remembered
+        uint32_t                  m_result_error      = { }; ///< Remembered m_error_code
+        uint32_t                  m_result_flags      = { }; ///< Remembered m_scan_flags
+    };
+} // namespace vac::modules::pnp_device_scanner
@@ -1,12 +1,30 @@
 #include "pnp_device_scanner.hpp"
+#include "device_classification_index.hpp"
+#include "hardware_id_matcher.hpp"
+#include "hex_decoder.hpp"
+#include "pnp_device_set.hpp"
+#include "pnp_result_store.hpp"
 
 #include "../../common/types.hpp"
+#include "../../utils/vac_instrumentation.hpp"
 #include "../../utils/vac_string_utils.hpp"
+#include "../../utils/vac_thread_pool.hpp"
+
+#if defined( _WIN32 )
+#include "setupapi_device_source.hpp"
+#elif defined( __linux__ )
+#include "sysfs_device_source.hpp"
+#endif
 
 #include <algorithm>
-#include <cstring>
-#include <setupapi.h>
-#include <windows.h>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
 
 namespace vac::common {
     struct pnp_device_entry_t;
@@ -14,17 +32,6 @@ namespace vac::common {
 } // namespace vac::common
 
 namespace vac::modules::pnp_device_scanner {
-    // Obfuscated search strings
-    constexpr char g_obfuscated_ven_string[ 5 ]       = "h{pa";               // XOR 0x3E -> "VEN_"
-    constexpr char g_obfuscated_dev_string[ 5 ]       = "z{ha";               // XOR 0x3E -> "DEV_"
-    constexpr char g_obfuscated_vid_string[ 5 ]       = "hwza";               // XOR 0x3E -> "VID_"
-    constexpr char g_obfuscated_pid_string[ 5 ]       = "nwza";               // XOR 0x3E -> "PID_"
-    constexpr char g_obfuscated_cc_string[ 3 ]        = { 0x61, 0x61, 0x61 }; // XOR 0x3E -> "CC_"
-    constexpr char g_obfuscated_devclass_string[ 10 ] = "z[H}R_MMa";          // XOR 0x3E -> "DevClass_"
-    constexpr char g_obfuscated_class_string[ 8 ]     = "b}R_MMa";            // XOR 0x3E -> "\\Class_"
-    constexpr char g_obfuscated_subclass_string[ 10 ] = "mK\\}R_MMa";         // XOR 0x3E -> "SubClass_"
-    constexpr char g_obfuscated_prot_string[ 6 ]      = "nLQJa";              // XOR 0x3E -> "Prot_"
-
     // Hardware device classification lookup table - exact VAC data at dword_10001080
     constexpr uint32_t g_hardware_device_lookup_table[] = {
         // Table header: device count (10) followed by padding
@@ -48,291 +55,332 @@ namespace vac::modules::pnp_device_scanner {
         0, 0
     };
 
-    int __fastcall parse_hex_string( const int hex_string, const unsigned int length, uint32_t *result ) {
-        int current_value = 0;
+    // Perfect-hash index over the table above, built at compile time
+    constexpr auto g_device_classification_index
+        = device_classification_index_t< count_classification_entries( g_hardware_device_lookup_table ) >::build(
+            g_hardware_device_lookup_table );
 
-        if ( length ) {
-            unsigned char temp_index = 0;
-            unsigned char hex_digit;
+    int __fastcall parse_hex_string( const intptr_t hex_string, const unsigned int length, uint32_t *result ) {
+        return decode_hex_field( reinterpret_cast< const char * >( hex_string ), length, result );
+    }
 
-            int char_index = 0;
-            while ( true ) {
-                const char current_char = *reinterpret_cast< char * >( char_index + hex_string );
-                if ( !current_char ) {
-                    return 2; // Null character encountered
-                }
+    bool extract_device_identity( const hardware_id_tokens_t *tokens, common::pnp_device_entry_t *device ) {
+        unsigned int vendor_id_result  = 0;
+        unsigned int product_id_result = 0;
+        unsigned int class_code_result = 0;
+        unsigned int device_type_flag;
 
-                // Convert to lowercase
-                char processed_char = current_char + 32;
-                if ( static_cast< unsigned int >( current_char - 65 ) > 0x19 ) {
-                    processed_char = *reinterpret_cast< char * >( char_index + hex_string );
-                }
+        const char *string_search_pos = tokens->first( hardware_id_token_t::ven );
+        const char *dev_search_pos    = tokens->first( hardware_id_token_t::dev );
 
-                // Parse hex digit
-                if ( static_cast< unsigned char >( processed_char - 48 ) > 9u ) {
-                    if ( static_cast< unsigned char >( processed_char - 97 ) > 5u ) {
-                        return 3; // Invalid hex character
-                    }
-                    hex_digit = processed_char - 87; // a-f -> 10-15
-                } else {
-                    hex_digit = processed_char - 48; // 0-9 -> 0-9
-                }
+        // Use the first CC_ occurrence that parses as a class code
+        for ( uint32_t cc_index = 0; cc_index < tokens->m_cc_count; ++cc_index ) {
+            if ( !parse_hex_string( reinterpret_cast< intptr_t >( tokens->m_cc_positions[ cc_index ] + 3 ), 6u, &class_code_result ) ) {
+                class_code_result = class_code_result >> 8; // Extract class code
+                break;
+            }
+        }
 
-                current_value = ( hex_digit << ( 4 * ( length - char_index ) - 4 ) ) + current_value;
-                char_index    = ++temp_index;
+        // Parse hardware IDs for VEN/DEV (primary method)
+        if ( !string_search_pos || !dev_search_pos
+             || parse_hex_string( reinterpret_cast< intptr_t >( string_search_pos + 4 ), 4u, &vendor_id_result )
+             || parse_hex_string( reinterpret_cast< intptr_t >( dev_search_pos + 4 ), 4u, &product_id_result ) ) {
+            // Fallback method: try VID/PID and various class code formats
+            const char *vid_search_pos      = tokens->first( hardware_id_token_t::vid );
+            const char *pid_search_pos      = tokens->first( hardware_id_token_t::pid );
+            const char *devclass_search_pos = tokens->first( hardware_id_token_t::devclass );
+            const char *subclass_search_pos = tokens->first( hardware_id_token_t::subclass );
+            const char *prot_search_pos     = tokens->first( hardware_id_token_t::prot );
+
+            if ( !vid_search_pos || !pid_search_pos ) {
+                return false;
+            }
 
-                if ( temp_index >= length ) {
-                    goto PARSE_COMPLETE;
-                }
+            product_id_result            = 0;
+            vendor_id_result             = 0;
+            unsigned int temp_class_code = 0;
+            unsigned int temp_vendor_id  = 0;
+
+            if ( parse_hex_string( reinterpret_cast< intptr_t >( vid_search_pos + 4 ), 4u, &vendor_id_result )
+                 || parse_hex_string( reinterpret_cast< intptr_t >( pid_search_pos + 4 ), 4u, &product_id_result ) ) {
+                return false;
+            }
+
+            // Parse various class code formats
+            if ( devclass_search_pos ) {
+                parse_hex_string( reinterpret_cast< intptr_t >( devclass_search_pos + 9 ), 2u, &class_code_result );
             }
+            if ( subclass_search_pos ) {
+                parse_hex_string( reinterpret_cast< intptr_t >( subclass_search_pos + 9 ), 2u, &temp_vendor_id );
+            }
+            if ( prot_search_pos ) {
+                parse_hex_string( reinterpret_cast< intptr_t >( prot_search_pos + 5 ), 2u, &temp_class_code );
+            }
+
+            class_code_result
+                = static_cast< unsigned char >( temp_vendor_id )
+                | ( ( ( static_cast< unsigned char >( class_code_result ) | ( static_cast< unsigned char >( temp_class_code ) << 8 ) )
+                      << 8 ) );
+            device_type_flag = 2; // Fallback method
         } else {
-        PARSE_COMPLETE:
-            *result = current_value;
-            return 0; // Success
+            device_type_flag = 1; // Primary method
         }
-    }
-
-    int __cdecl enumerate_pnp_devices( [[maybe_unused]] void *context_param, char *results_buffer, unsigned int *buffer_size ) {
-        unsigned int *buffer_size_ptr = buffer_size;
-        DWORD         last_error;
-        char         *device_buffer;
-        int           required_size;
-        char         *hw_id_start;
-        unsigned int  vendor_id_result;
-        unsigned int  product_id_result;
-        unsigned int  class_code_result;
-        unsigned int  device_type_flag;
-
-        SP_DEVINFO_DATA device_info_data;
-        unsigned int    temp_vendor_id;
-        unsigned int    temp_class_code;
-
-        char ven_string[ 5 ];       // "VEN_"
-        char dev_string[ 5 ];       // "DEV_"
-        char vid_string[ 5 ];       // "VID_"
-        char pid_string[ 5 ];       // "PID_"
-        char cc_string[ 4 ];        // "CC_"
-        char devclass_string[ 10 ]; // "DevClass_"
-        char class_string[ 8 ];     // "\\Class_"
-        char subclass_string[ 10 ]; // "SubClass_"
-        char prot_string[ 6 ];      // "Prot_"
 
-        utils::zero_memory_vac( results_buffer, 0, 0x20u );
-        common::pnp_scan_results_t *scan_results = reinterpret_cast< common::pnp_scan_results_t * >( results_buffer );
-        *buffer_size_ptr                         = 32;
-        scan_results->m_error_code               = static_cast< uint32_t >( -1811958236 );
+        device->m_type_and_class = device_type_flag | ( class_code_result << 8 );
+        device->m_vendor_id      = static_cast< uint16_t >( vendor_id_result );
+        device->m_product_id     = static_cast< uint16_t >( product_id_result );
+        return true;
+    }
 
-        // Get device information set for all present devices
-        const int device_info_handle
-            = reinterpret_cast< int >( SetupDiGetClassDevsA( nullptr, nullptr, nullptr, DIGCF_PRESENT | DIGCF_ALLCLASSES ) );
-        if ( device_info_handle == -1 ) {
-            last_error = GetLastError( );
-            goto CLEANUP_AND_RETURN;
-        }
+    void tag_device_classification( common::pnp_device_entry_t *device ) {
+        const uint32_t device_id = ( static_cast< uint32_t >( device->m_vendor_id ) << 16 ) | device->m_product_id;
+        const uint32_t tag       = g_device_classification_index.lookup( device_id );
 
-        // Allocate device enumeration buffer
-        device_buffer = reinterpret_cast< char * >( HeapAlloc( GetProcessHeap( ), 0, 2048 ) );
-        if ( !device_buffer ) {
-            last_error = 14; // ERROR_OUTOFMEMORY
-            goto CLEANUP_DEVICE_INFO;
+        if ( tag ) {
+            device->m_type_and_class |= ( tag - g_classification_tag_base ) << 4;
         }
+    }
 
-        utils::zero_memory_vac( device_buffer, 0, 0x800u );
-        device_info_data.cbSize        = sizeof( SP_DEVINFO_DATA );
-        unsigned int device_enum_index = 0;
-
-        // Deobfuscate search strings
-        deobfuscate_string( g_obfuscated_ven_string, ven_string, 4 );
-        deobfuscate_string( g_obfuscated_dev_string, dev_string, 4 );
-        deobfuscate_string( g_obfuscated_vid_string, vid_string, 4 );
-        deobfuscate_string( g_obfuscated_pid_string, pid_string, 4 );
-        deobfuscate_string( g_obfuscated_cc_string, cc_string, 3 );
-        deobfuscate_string( g_obfuscated_devclass_string, devclass_string, 9 );
-        deobfuscate_string( g_obfuscated_class_string, class_string, 7 );
-        deobfuscate_string( g_obfuscated_subclass_string, subclass_string, 9 );
-        deobfuscate_string( g_obfuscated_prot_string, prot_string, 5 );
-
-        // Enumerate all devices
-        while ( true ) {
-            if ( !SetupDiEnumDeviceInfo( reinterpret_cast< HDEVINFO >( device_info_handle ), device_enum_index, &device_info_data ) ) {
-                last_error = 0; // Success - no more devices
-                goto CLEANUP_BUFFER;
-            }
-
-            *device_buffer = 0;
-
-            // Get device description
-            if ( !SetupDiGetDeviceRegistryPropertyA( reinterpret_cast< HDEVINFO >( device_info_handle ), &device_info_data,
-                                                     SPDRP_DEVICEDESC, nullptr, reinterpret_cast< PBYTE >( device_buffer ), 1024,
-                                                     reinterpret_cast< PDWORD >( &required_size ) ) ) {
-                const DWORD get_error = GetLastError( );
-                last_error      = get_error;
-                if ( get_error != 13 && get_error != 122 ) { // Not access denied or insufficient buffer
-                    if ( get_error != static_cast< DWORD >( -536870389 ) ) {
-                        goto CLEANUP_BUFFER;
+    namespace {
+        std::mutex         g_pnp_scan_mutex;   ///< Serialises scans through the default source and cache
+        pnp_device_cache_t g_pnp_device_cache; ///< Instance and result cache kept across scans
+        pnp_result_store_t g_pnp_results;      ///< Result of the last scan, chunks reused
+
+        unsigned int                           g_pnp_scan_workers = 1; ///< Worker count for property reads, 1 = serial
+        std::unique_ptr< utils::thread_pool_t > g_pnp_worker_pool;     ///< Created on the first parallel scan
+
+        constexpr size_t g_pnp_parallel_grain = 8; ///< Devices per worker grab in parallel mode
+
+        /**
+         * @brief Parse outcomes produced by one pool slot, in increasing device index order
+         */
+        struct pnp_property_shard_t {
+            std::vector< std::pair< uint32_t, pnp_cached_device_t > > m_devices;                    ///< (device index, parse outcome)
+            size_t                                                      m_error_position = SIZE_MAX; ///< Lowest failed position in the miss list
+            int                                                         m_error          = { };      ///< read_properties() result at m_error_position
+        };
+
+        /**
+         * @brief Read and parse the missing devices on a worker pool
+         *
+         * Each slot reads properties into its own buffer and appends parse outcomes to its
+         * own shard. Shards are then scattered back by device index, so the caller's
+         * in-order de-duplication sees exactly what a serial scan would. The first failure
+         * in miss-list order wins, as with read_properties_batch(); reads past an already
+         * known failure are skipped and only devices before it are scattered.
+         *
+         * @param failed_position Receives the failing position in the miss list, its size on success
+         * @return 0 on success, the failing read_properties() result otherwise
+         */
+        int read_missing_devices_parallel( pnp_device_source_t *source, utils::thread_pool_t *pool, const std::vector< uint32_t > &missing_devices,
+                                           std::vector< pnp_cached_device_t > *device_states, size_t *failed_position ) {
+            std::vector< pnp_property_shard_t > shards( pool->worker_count( ) );
+            std::atomic< size_t >               first_failure = { SIZE_MAX };
+
+            pool->parallel_for( missing_devices.size( ), g_pnp_parallel_grain, [ & ]( const size_t begin, const size_t end, const unsigned int slot ) {
+                pnp_property_shard_t   &shard      = shards[ slot ];
+                pnp_device_properties_t properties = { };
+
+                for ( size_t position = begin; position < end && position < first_failure.load( std::memory_order_relaxed ); ++position ) {
+                    properties = { };
+
+                    if ( const int read_error = source->read_properties( missing_devices[ position ], &properties ) ) {
+                        shard.m_error_position = position;
+                        shard.m_error          = read_error;
+
+                        size_t known_failure = first_failure.load( std::memory_order_relaxed );
+                        while ( position < known_failure && !first_failure.compare_exchange_weak( known_failure, position ) ) { }
+                        return;
                     }
-                    scan_results->m_scan_flags |= 1u; // Mark access error
+
+                    pnp_cached_device_t device_state = { };
+                    parse_device_properties( &properties, &device_state );
+                    shard.m_devices.emplace_back( missing_devices[ position ], device_state );
                 }
+            } );
+
+            // Merge: the lowest failing position decides the error, everything before it is scattered by index.
+            // Every position below the lowest failure was read, no slot stops short of it
+            const pnp_property_shard_t *failed_shard = nullptr;
+            for ( const pnp_property_shard_t &shard : shards ) {
+                if ( shard.m_error_position != SIZE_MAX && ( !failed_shard || shard.m_error_position < failed_shard->m_error_position ) )
+                    failed_shard = &shard;
             }
 
-            if ( !*device_buffer ) {
-                goto NEXT_DEVICE;
-            }
+            *failed_position             = failed_shard ? failed_shard->m_error_position : missing_devices.size( );
+            const uint32_t scatter_limit = failed_shard ? missing_devices[ *failed_position ] : UINT32_MAX;
 
-            // Append device class string to description
-            const int device_desc_length = strlen( device_buffer );
-            int max_append_length  = strlen( ( char * ) g_hardware_device_lookup_table );
-            max_append_length      = std::min( max_append_length, 0xFFFF );
-
-            memcpy( device_buffer + device_desc_length, g_hardware_device_lookup_table, max_append_length );
-            device_buffer[ max_append_length + device_desc_length ] = 0;
-
-            // Get hardware IDs
-            const int current_buffer_length = strlen( device_buffer );
-            hw_id_start               = &device_buffer[ current_buffer_length ];
-
-            if ( !SetupDiGetDeviceRegistryPropertyA( reinterpret_cast< HDEVINFO >( device_info_handle ), &device_info_data,
-                                                     SPDRP_HARDWAREID, nullptr, reinterpret_cast< PBYTE >( hw_id_start ),
-                                                     1024 - current_buffer_length, reinterpret_cast< PDWORD >( &required_size ) ) ) {
-                const DWORD hw_error = GetLastError( );
-                last_error     = hw_error;
-                if ( hw_error != 13 && hw_error != 122 ) {
-                    if ( hw_error != static_cast< DWORD >( -536870389 ) ) {
-                        goto CLEANUP_BUFFER;
-                    }
-                    scan_results->m_scan_flags |= 1u;
+            for ( const pnp_property_shard_t &shard : shards ) {
+                for ( const auto &[ device_index, device_state ] : shard.m_devices ) {
+                    if ( device_index < scatter_limit )
+                        ( *device_states )[ device_index ] = device_state;
                 }
             }
 
-            // Handle multi-string hardware IDs (replace null separators with newlines)
-            if ( required_size == 7 ) {
-                char *hw_id_ptr = &hw_id_start[ strlen( hw_id_start ) ];
-                while ( true ) {
-                    *hw_id_ptr = 10; // newline
-                    if ( !hw_id_ptr[ 1 ] ) {
-                        break;
-                    }
-                    hw_id_ptr = &hw_id_ptr[ strlen( hw_id_ptr ) ];
-                }
-            }
+            return failed_shard ? failed_shard->m_error : 0;
+        }
 
-            // Parse hardware IDs for VEN/DEV (primary method)
-            vendor_id_result  = 0;
-            product_id_result = 0;
-            class_code_result = 0;
+#if defined( _WIN32 )
+        setupapi_device_source_t g_pnp_device_source;
+#elif defined( __linux__ )
+        sysfs_device_source_t g_pnp_device_source;
+#endif
+    } // namespace
 
-            char *string_search_pos = strstr( device_buffer, ven_string );
-            char *dev_search_pos    = strstr( device_buffer, dev_string );
-            char *cc_search_pos     = strstr( device_buffer, cc_string );
+    void parse_device_properties( const pnp_device_properties_t *properties, pnp_cached_device_t *cached_device ) {
+        VAC_TRACE_FUNCTION( );
 
-            if ( cc_search_pos ) {
-                while ( parse_hex_string( reinterpret_cast< int >( cc_search_pos + 3 ), 6u, &class_code_result ) ) {
-                    cc_search_pos = strstr( cc_search_pos + 3, cc_string );
-                    if ( !cc_search_pos ) {
-                        break;
-                    }
-                }
-                if ( cc_search_pos ) {
-                    class_code_result = class_code_result >> 8; // Extract class code
-                }
-            }
+        hardware_id_tokens_t tokens;
 
-            if ( !string_search_pos || !dev_search_pos
-                 || parse_hex_string( reinterpret_cast< int >( string_search_pos + 4 ), 4u, &vendor_id_result )
-                 || parse_hex_string( reinterpret_cast< int >( dev_search_pos + 4 ), 4u, &product_id_result ) ) {
-                // Fallback method: try VID/PID and various class code formats
-                char *vid_search_pos      = strstr( device_buffer, vid_string );
-                char *pid_search_pos      = strstr( device_buffer, pid_string );
-                char *devclass_search_pos = strstr( device_buffer, devclass_string );
-                char *class_search_pos    = strstr( device_buffer, class_string );
-                char *subclass_search_pos = strstr( device_buffer, subclass_string );
-                char *prot_search_pos     = strstr( device_buffer, prot_string );
-
-                if ( !vid_search_pos || !pid_search_pos ) {
-                    goto NEXT_DEVICE;
-                }
+        cached_device->m_scan_flags = properties->m_scan_flags;
 
-                product_id_result            = 0;
-                vendor_id_result             = 0;
-                temp_class_code              = 0;
-                temp_vendor_id               = 0;
-                unsigned int temp_product_id = 0;
+        if ( !*properties->m_description ) {
+            return;
+        }
 
-                if ( parse_hex_string( reinterpret_cast< int >( vid_search_pos + 4 ), 4u, &vendor_id_result )
-                     || parse_hex_string( reinterpret_cast< int >( pid_search_pos + 4 ), 4u, &product_id_result ) ) {
-                    goto NEXT_DEVICE;
-                }
+        // Locate every VEN_/DEV_/CC_/VID_/PID_/class token straight in the returned property bytes.
+        // The description is scanned first so leftmost matches keep their original priority; the
+        // HARDWAREID multi-sz is walked as-is, its NUL separators reset the automaton between IDs
+        scan_hardware_id_tokens( properties->m_description, std::min< size_t >( properties->m_description_size, g_pnp_property_buffer_size ),
+                                 &tokens );
+        scan_hardware_id_tokens( properties->m_hardware_ids,
+                                 std::min< size_t >( properties->m_hardware_ids_size, g_pnp_property_buffer_size ), &tokens );
 
-                // Parse various class code formats
-                if ( devclass_search_pos ) {
-                    parse_hex_string( reinterpret_cast< int >( devclass_search_pos + 9 ), 2u, &class_code_result );
-                }
-                if ( subclass_search_pos ) {
-                    parse_hex_string( reinterpret_cast< int >( subclass_search_pos + 9 ), 2u, &temp_vendor_id );
-                }
-                if ( prot_search_pos ) {
-                    parse_hex_string( reinterpret_cast< int >( prot_search_pos + 5 ), 2u, &temp_class_code );
-                }
+        if ( !extract_device_identity( &tokens, &cached_device->m_device ) ) {
+            return;
+        }
 
-                class_code_result
-                    = static_cast< unsigned char >( temp_vendor_id )
-                    | ( ( ( static_cast< unsigned char >( class_code_result ) | ( static_cast< unsigned char >( temp_class_code ) << 8 ) )
-                          << 8 ) );
-                device_type_flag = 2; // Fallback method
-            } else {
-                device_type_flag = 1; // Primary method
-            }
+        tag_device_classification( &cached_device->m_device );
+        cached_device->m_has_identity = true;
+    }
 
-            // Check for duplicate devices
-            const unsigned int current_device_count  = scan_results->m_device_count;
-            unsigned int existing_device_index = 0;
-            if ( current_device_count ) {
-                const common::pnp_device_entry_t *existing_device = scan_results->m_devices;
-                do {
-                    if ( existing_device->m_vendor_id == vendor_id_result && existing_device->m_product_id == product_id_result
-                         && static_cast< unsigned short >( class_code_result )
-                                == static_cast< unsigned short >( existing_device->m_type_and_class >> 8 ) ) {
-                        break; // Duplicate found
-                    }
-                    ++existing_device_index;
-                    ++existing_device;
-                } while ( existing_device_index < current_device_count );
+    uint32_t enumerate_pnp_devices_from_source( pnp_device_source_t *source, pnp_device_cache_t *cache, pnp_result_store_t *results,
+                                                utils::thread_pool_t *pool ) {
+        VAC_TRACE_FUNCTION( );
+
+        // Nothing arrived or left since the last complete scan: hand back the same result
+        const uint64_t scan_generation = source->generation( );
+        if ( cache->replay( scan_generation, results ) ) {
+            return results->m_error_code;
+        }
+
+        results->clear( );
+
+        uint32_t  device_count = 0;
+        const int scan_error   = source->begin_scan( &device_count );
+        if ( scan_error ) {
+            cache->invalidate( );
+            results->m_error_code = static_cast< uint32_t >( scan_error );
+            return results->m_error_code;
+        }
+
+        // Resolve every device through the instance cache, properties are only read for the misses
+        std::vector< pnp_cached_device_t >                        device_states( device_count );
+        std::vector< uint32_t >                                   missing_devices;
+        std::vector< std::array< char, g_pnp_instance_id_size > > instance_ids( device_count );
+
+        cache->begin_pass( );
+
+        for ( uint32_t device_index = 0; device_index < device_count; ++device_index ) {
+            char *instance_id = instance_ids[ device_index ].data( );
+            if ( !source->get_instance_id( device_index, instance_id ) ) {
+                *instance_id = 0;
             }
 
-            if ( existing_device_index != current_device_count ) {
-                goto NEXT_DEVICE; // Skip duplicate
+            const pnp_cached_device_t *cached_device = *instance_id ? cache->find( instance_id ) : nullptr;
+            if ( cached_device ) {
+                device_states[ device_index ] = *cached_device;
+            } else {
+                missing_devices.push_back( device_index );
             }
+        }
 
-            // Add new device if space available
-            if ( current_device_count < 508 ) { // Max devices = (4232-32)/8 = 525, but VAC uses 508
-                common::pnp_device_entry_t *new_device = &scan_results->m_devices[ current_device_count ];
+        int    read_error      = 0;
+        size_t failed_position = missing_devices.size( );
 
-                new_device->m_type_and_class = device_type_flag | ( class_code_result << 8 );
-                new_device->m_vendor_id      = static_cast< uint16_t >( vendor_id_result );
-                new_device->m_product_id     = static_cast< uint16_t >( product_id_result );
+        if ( pool && pool->worker_count( ) > 1 && missing_devices.size( ) >= 2 * g_pnp_parallel_grain ) {
+            read_error = read_missing_devices_parallel( source, pool, missing_devices, &device_states, &failed_position );
+            source->end_scan( );
+        } else {
+            std::vector< pnp_device_properties_t > properties( missing_devices.size( ) );
+            read_error = source->read_properties_batch( missing_devices.data( ), missing_devices.size( ), properties.data( ), &failed_position );
+            source->end_scan( );
 
-                ++scan_results->m_device_count;
-                goto NEXT_DEVICE;
+            for ( size_t missing_index = 0; missing_index < failed_position; ++missing_index )
+                parse_device_properties( &properties[ missing_index ], &device_states[ missing_devices[ missing_index ] ] );
+        }
+
+        for ( size_t missing_index = 0; missing_index < failed_position; ++missing_index ) {
+            const uint32_t device_index = missing_devices[ missing_index ];
+            if ( instance_ids[ device_index ][ 0 ] ) {
+                cache->store( instance_ids[ device_index ].data( ), device_states[ device_index ] );
             }
+        }
 
-            last_error = 111; // ERROR_BUFFER_OVERFLOW
-            break;
+        // A failed read ends the scan at the failing device: everything enumerated before it is still
+        // reported with its scan flags, next to the error code. Only a complete pass may drop instances
+        const uint32_t scanned_count = read_error ? missing_devices[ failed_position ] : device_count;
+        if ( !read_error ) {
+            cache->end_pass( );
+        }
+
+        // De-duplicate in enumeration order (VID, PID and class already seen); only a full store drops devices
+        pnp_device_set_t known_devices( device_count );
+
+        for ( uint32_t device_index = 0; device_index < scanned_count; ++device_index ) {
+            const pnp_cached_device_t &device_state = device_states[ device_index ];
+            results->m_scan_flags |= device_state.m_scan_flags;
 
-        NEXT_DEVICE:
-            ++device_enum_index;
+            if ( device_state.m_has_identity && known_devices.insert( pnp_device_set_t::make_key( device_state.m_device ) )
+                 && !results->append( device_state.m_device ) ) {
+                results->m_error_code = g_pnp_legacy_overflow_error;
+            }
         }
 
-    CLEANUP_BUFFER:
-        HeapFree( GetProcessHeap( ), 0, device_buffer );
+        if ( read_error ) {
+            cache->invalidate( );
+            results->m_error_code = static_cast< uint32_t >( read_error );
+            return results->m_error_code;
+        }
 
-    CLEANUP_DEVICE_INFO:
-        SetupDiDestroyDeviceInfoList( reinterpret_cast< HDEVINFO >( device_info_handle ) );
+        cache->remember( scan_generation, *results );
+        return results->m_error_code;
+    }
+
+    void set_pnp_scan_workers( unsigned int worker_count ) {
+        if ( !worker_count )
+            worker_count = std::clamp( std::thread::hardware_concurrency( ), 1u, 8u );
+
+        std::lock_guard< std::mutex > scan_lock( g_pnp_scan_mutex );
+
+        if ( worker_count == g_pnp_scan_workers )
+            return;
+
+        g_pnp_scan_workers = worker_count;
+        g_pnp_worker_pool.reset( );
+    }
+
+    int __cdecl enumerate_pnp_devices( [[maybe_unused]] void *context_param, char *results_buffer, unsigned int *buffer_size ) {
+        VAC_TRACE_FUNCTION( );
+
+        utils::zero_memory_vac( results_buffer, 0, 0x20u );
+        common::pnp_scan_results_t *scan_results = reinterpret_cast< common::pnp_scan_results_t * >( results_buffer );
+        *buffer_size                             = 32;
+        scan_results->m_error_code               = static_cast< uint32_t >( -1811958236 );
+
+        {
+            std::lock_guard< std::mutex > scan_lock( g_pnp_scan_mutex );
+
+            if ( g_pnp_scan_workers > 1 && !g_pnp_worker_pool )
+                g_pnp_worker_pool = std::make_unique< utils::thread_pool_t >( g_pnp_scan_workers );
+
+            enumerate_pnp_devices_from_source( &g_pnp_device_source, &g_pnp_device_cache, &g_pnp_results, g_pnp_worker_pool.get( ) );
+            fill_legacy_scan_results( g_pnp_results, scan_results );
+        }
 
-    CLEANUP_AND_RETURN:
         // Store final results
-        scan_results->m_error_code = last_error;
-        *buffer_size_ptr           = ( 8 * scan_results->m_device_count + 39 ) & 0xFFFFFFF8;
+        *buffer_size = ( 8 * scan_results->m_device_count + 39 ) & 0xFFFFFFF8;
         return 0;
     }
 
-} // namespace vac::modules::pnp_device_scanner
\ No newline at end of file
+} // namespace vac::modules::pnp_device_scanner
@@ -1,5 +1,14 @@
 #pragma once
 
+#include "../../common/types.hpp"
+#include "hardware_id_matcher.hpp"
+#include "pnp_device_cache.hpp"
+#include "pnp_device_source.hpp"
+#include "pnp_result_store.hpp"
+#include "pnp_string_key.hpp"
+
+#include "../../utils/vac_thread_pool.hpp"
+
 #include <cstdint>
 
 namespace vac::modules::pnp_device_scanner {
@@ -8,15 +17,86 @@ namespace vac::modules::pnp_device_scanner {
      *
      * This function converts a hexadecimal string to an integer value.
      * It handles both uppercase and lowercase hex digits and validates input.
+     * Decoding is table driven, one lookup per character.
      *
-     * @param hex_string Pointer to hexadecimal string
+     * @param hex_string Address of hexadecimal string
      * @param length Length of hex string to parse
      * @param result Pointer to store parsed integer result
      * @return 0 on success
      * @return 2 if null character encountered
      * @return 3 if invalid hex character found
      */
-    int __fastcall parse_hex_string( int hex_string, unsigned int length, uint32_t *result );
+    int __fastcall parse_hex_string( intptr_t hex_string, unsigned int length, uint32_t *result );
+
+    /**
+     * @brief Extract vendor, product and class codes from located hardware-ID tokens
+     *
+     * Primary method: VEN_xxxx / DEV_xxxx with the first CC_xxxxxx that parses (type flag 1).
+     * Fallback method: VID_xxxx / PID_xxxx with DevClass_xx, SubClass_xx and Prot_xx (type flag 2).
+     *
+     * @param tokens Token positions found by scan_hardware_id_tokens()
+     * @param device Receives the 8-byte device entry on success
+     * @return true if a VEN/DEV or VID/PID pair was parsed, false if the device has no usable IDs
+     */
+    bool extract_device_identity( const hardware_id_tokens_t *tokens, common::pnp_device_entry_t *device );
+
+    /**
+     * @brief Tag a device with its entry in g_hardware_device_lookup_table
+     *
+     * Looks the packed VID/PID up in the compile-time classification index and stores
+     * the tag ordinal (tag - 0x1E, 1..15) in bits 4-7 of m_type_and_class. Unlisted
+     * devices are left untouched.
+     *
+     * @param device Parsed device entry
+     */
+    void tag_device_classification( common::pnp_device_entry_t *device );
+
+    /**
+     * @brief Parse the identity of one device from its raw properties
+     *
+     * Devices without a description are skipped like in VAC; otherwise the description
+     * and the hardware ID multi-sz are token-scanned in place, parsed with
+     * extract_device_identity() and tagged with tag_device_classification().
+     *
+     * @param properties Properties read by a device source
+     * @param cached_device Receives the parse outcome, zero-initialised by the caller
+     */
+    void parse_device_properties( const pnp_device_properties_t *properties, pnp_cached_device_t *cached_device );
+
+    /**
+     * @brief Scan the devices of a source into a result store
+     *
+     * Platform-independent core of enumerate_pnp_devices(): replays the cached result
+     * while source->generation() is unchanged, otherwise lists the devices, reads the
+     * properties of instances missing from the cache in one batch, and de-duplicates
+     * in enumeration order. Every unique device is kept; the 508-entry limit only
+     * applies when fill_legacy_scan_results() builds the legacy structure.
+     *
+     * With a pool, the misses are read through read_properties() and parsed on the
+     * workers into per-slot shards that are merged back by device index before the
+     * de-duplication, so the result is identical to the serial path.
+     *
+     * A failing property read keeps the devices enumerated before the failing one, and
+     * their scan flags, next to the error code; such a result is not cached for replay.
+     *
+     * @param source Device source, read_properties() must be safe for distinct indices in parallel
+     * @param cache Instance / result cache, kept across calls for the same source
+     * @param results Receives the devices, error code and scan flags
+     * @param pool Worker pool for property reads, nullptr for a serial read_properties_batch()
+     * @return 0 on success, 111 (ERROR_BUFFER_OVERFLOW) if more than g_pnp_result_max_devices unique
+     *         devices were found, or the source error that aborted the scan (also stored in results)
+     */
+    uint32_t enumerate_pnp_devices_from_source( pnp_device_source_t *source, pnp_device_cache_t *cache, pnp_result_store_t *results,
+                                                utils::thread_pool_t *pool = nullptr );
+
+    /**
+     * @brief Select serial or parallel property reads for enumerate_pnp_devices()
+     *
+     * Serial (1) is the default. The worker pool is rebuilt on the next scan.
+     *
+     * @param worker_count Property read workers, 1 for serial, 0 to pick from the CPU count (up to 8)
+     */
+    void set_pnp_scan_workers( unsigned int worker_count );
 
     /**
      * @brief Enumerate all PnP devices and extract hardware information
@@ -25,10 +105,12 @@ namespace vac::modules::pnp_device_scanner {
      * 1. Uses SetupDiGetClassDevsA to get all present devices
      * 2. Enumerates each device with SetupDiEnumDeviceInfo
      * 3. Gets device description using SetupDiGetDeviceRegistryPropertyA
-     * 4. Gets hardware IDs using SetupDiGetDeviceRegistryPropertyA
-     * 5. Parses VID/PID/Class codes from hardware ID strings
-     * 6. De-duplicates devices based on VID/PID/Class combination
-     * 7. Stores unique devices in 8-byte entries
+     * 4. Gets the HARDWAREID multi-sz into a separate half of the work buffer
+     * 5. Locates all VID/PID/Class tokens in one Aho-Corasick pass over the returned
+     *    property bytes (no copies or separator rewriting) and parses them in place
+     * 6. Tags known devices from the hardware classification table
+     * 7. De-duplicates devices based on VID/PID/Class combination
+     * 8. Stores unique devices in 8-byte entries
      *
      * The function searches for these patterns in hardware IDs:
      * - "VEN_xxxx" or "VID_xxxx" for Vendor ID
@@ -38,26 +120,23 @@ namespace vac::modules::pnp_device_scanner {
      * It handles both primary detection (using VEN_/DEV_) and fallback detection
      * (using VID_/PID_ and various class code formats).
      *
+     * Scans are incremental: parsed identities are cached per device instance ID, so
+     * only new instances have their registry properties read, and while the device
+     * change generation (CM_Register_Notification) has not moved since the last
+     * complete scan the previous result is returned without enumerating at all.
+     *
+     * Devices come from setupapi_device_source_t on Windows and from
+     * sysfs_device_source_t on Linux, see enumerate_pnp_devices_from_source().
+     *
      * @param context_param Unused parameter (present in original)
      * @param results_buffer Pointer to results structure to fill
      * @param buffer_size Pointer to buffer size (input/output)
      * @return 0 on success, error code on failure
      *
-     * @note Maximum 508 devices can be stored due to buffer size limits
-     * @note Function uses exact VAC string obfuscation with XOR 0x3E
+     * @note Maximum 508 devices fit the legacy structure; larger results are kept whole in
+     *       the scanner's pnp_result_store_t (up to g_pnp_result_max_devices) and only the
+     *       legacy view reports error 111
+     * @note Token strings are stored obfuscated with VAC_PNP_STRING_KEY (VAC uses XOR 0x3E)
      */
     int __cdecl enumerate_pnp_devices( void *context_param, char *results_buffer, unsigned int *buffer_size );
-
-    /**
-     * @brief Helper function to deobfuscate strings
-     * @param obfuscated_string Source obfuscated string
-     * @param deobfuscated_buffer Output buffer for deobfuscated string
-     * @param length String length
-     */
-    inline void deobfuscate_string( const char *obfuscated_string, char *deobfuscated_buffer, size_t length ) {
-        for ( size_t i = 0; i < length; ++i ) {
-            // todo: Make it possible to enter a different xor value, because Valve often uses different encryption keys.
-            deobfuscated_buffer[ i ] = obfuscated_string[ i ] ^ 0x3E;
-        }
-    }
-} // namespace vac::modules::pnp_device_scanner
\ No newline at end of file
+} // namespace vac::modules::pnp_device_scanner
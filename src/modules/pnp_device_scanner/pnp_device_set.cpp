@@ -0,0 +1,66 @@
+#include "pnp_device_set.hpp"
+
+namespace vac::modules::pnp_device_scanner {
+    namespace {
+        // Keys only use 48 bits, so the top bit marks a slot as occupied and key 0 stays representable
+        constexpr uint64_t g_occupied_bit = 1ULL << 63;
+
+        size_t hash_key( const uint64_t key, const size_t slot_mask ) {
+            return static_cast< size_t >( ( key * 0x9E3779B97F4A7C15ULL ) >> 32 ) & slot_mask;
+        }
+    } // namespace
+
+    pnp_device_set_t::pnp_device_set_t( const size_t expected_devices ) {
+        size_t slot_count = 16;
+        while ( slot_count < 2 * expected_devices )
+            slot_count <<= 1;
+
+        m_slots.assign( slot_count, 0 );
+    }
+
+    size_t pnp_device_set_t::find_slot( const uint64_t stored_key ) const {
+        const size_t slot_mask = m_slots.size( ) - 1;
+
+        size_t slot = hash_key( stored_key, slot_mask );
+        while ( m_slots[ slot ] && m_slots[ slot ] != stored_key )
+            slot = ( slot + 1 ) & slot_mask;
+
+        return slot;
+    }
+
+    void pnp_device_set_t::grow( ) {
+        std::vector< uint64_t > old_slots( m_slots.size( ) * 2, 0 );
+        old_slots.swap( m_slots );
+
+        for ( const uint64_t stored_key : old_slots ) {
+            if ( stored_key )
+                m_slots[ find_slot( stored_key ) ] = stored_key;
+        }
+    }
+
+    bool pnp_device_set_t::insert( const uint64_t key ) {
+        const uint64_t stored_key = key | g_occupied_bit;
+
+        size_t slot = find_slot( stored_key );
+        if ( m_slots[ slot ] )
+            return false; // Already present
+
+        if ( 2 * ( m_count + 1 ) > m_slots.size( ) ) {
+            grow( );
+            slot = find_slot( stored_key );
+        }
+
+        m_slots[ slot ] = stored_key;
+        ++m_count;
+        return true;
+    }
+
+    bool pnp_device_set_t::contains( const uint64_t key ) const {
+        return m_slots[ find_slot( key | g_occupied_bit ) ] != 0;
+    }
+
+    void pnp_device_set_t::clear( ) {
+        m_slots.assign( m_slots.size( ), 0 );
+        m_count = 0;
+    }
+} // namespace vac::modules::pnp_device_scanner
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "../../common/types.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace vac::modules::pnp_device_scanner {
+    /**
+     * @brief Open-addressing set of device identities used for de-duplication
+     *
+     * Devices are considered duplicates when vendor ID, product ID and the low 16 bits
+     * of the class code match (the device type flag is ignored), exactly like the
+     * linear comparison against every stored pnp_device_entry_t it replaces.
+     * The identity is packed into one 64-bit key; slots use linear probing with a
+     * load factor of at most 1/2 and grow by doubling.
+     */
+    class pnp_device_set_t {
+    public:
+        /**
+         * @param expected_devices Number of devices to size the table for up front
+         */
+        explicit pnp_device_set_t( size_t expected_devices = 508 );
+
+        /**
+         * @brief Pack the de-duplication identity of a device
+         * @param device Device entry
+         * @return (class & 0xFFFF) << 32 | VID << 16 | PID
+         */
+        static uint64_t make_key( const common::pnp_device_entry_t &device ) {
+            return ( static_cast< uint64_t >( static_cast< uint16_t >( device.m_type_and_class >> 8 ) ) << 32 )
+                 | ( static_cast< uint64_t >( device.m_vendor_id ) << 16 ) | device.m_product_id;
+        }
+
+        /**
+         * @brief Insert a key
+         * @param key Key built by make_key()
+         * @return true if the key was not present before
+         */
+        bool insert( uint64_t key );
+
+        /**
+         * @brief Check whether a key is present
+         * @param key Key built by make_key()
+         * @return true if the key was inserted before
+         */
+        bool contains( uint64_t key ) const;
+
+        /**
+         * @brief Remove all keys, keeping the allocated slots
+         */
+        void clear( );
+
+        size_t size( ) const { return m_count; }
+
+    private:
+        size_t find_slot( uint64_t stored_key ) const;
+        void   grow( );
+
+        std::vector< uint64_t > m_slots;       ///< 0 = empty, otherwise key with bit 63 set
+        size_t                  m_count = { }; ///< Keys stored
+    };
+} // namespace vac::modules::pnp_device_scanner
@@ -0,0 +1,127 @@
+#include "pnp_device_set_benchmark.hpp"
+#include "pnp_device_set.hpp"
+#include "../../utils/vac_clock_utils.hpp"
+#include "../../utils/vac_random_utils.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+namespace vac::modules::pnp_device_scanner {
+    namespace {
+        /**
+         * @brief VAC's duplicate check as shipped: compare against every device kept so far
+         */
+        void deduplicate_linear( const std::vector< common::pnp_device_entry_t > &enumerated,
+                                 std::vector< common::pnp_device_entry_t >       *kept ) {
+            kept->clear( );
+
+            for ( const common::pnp_device_entry_t &parsed_device : enumerated ) {
+                const size_t current_device_count  = kept->size( );
+                size_t       existing_device_index = 0;
+
+                for ( ; existing_device_index < current_device_count; ++existing_device_index ) {
+                    const common::pnp_device_entry_t &existing_device = ( *kept )[ existing_device_index ];
+                    if ( existing_device.m_vendor_id == parsed_device.m_vendor_id && existing_device.m_product_id == parsed_device.m_product_id
+                         && static_cast< unsigned short >( parsed_device.m_type_and_class >> 8 )
+                                == static_cast< unsigned short >( existing_device.m_type_and_class >> 8 ) )
+                        break; // Duplicate found
+                }
+
+                if ( existing_device_index == current_device_count )
+                    kept->push_back( parsed_device );
+            }
+        }
+
+        /**
+         * @brief The scanner's duplicate check, one set per scan
+         */
+        void deduplicate_with_set( const std::vector< common::pnp_device_entry_t > &enumerated,
+                                   std::vector< common::pnp_device_entry_t >       *kept ) {
+            pnp_device_set_t known_devices( enumerated.size( ) );
+            kept->clear( );
+
+            for ( const common::pnp_device_entry_t &parsed_device : enumerated ) {
+                if ( known_devices.insert( pnp_device_set_t::make_key( parsed_device ) ) )
+                    kept->push_back( parsed_device );
+            }
+        }
+
+        /**
+         * @brief Seeded enumeration, composite devices repeated once per interface
+         */
+        void build_enumeration( const pnp_device_set_benchmark_config_t &config, std::vector< common::pnp_device_entry_t > *enumerated ) {
+            uint64_t       state      = config.m_seed;
+            const uint32_t interfaces = std::max< uint32_t >( config.m_interfaces_per_device, 1 );
+
+            enumerated->clear( );
+
+            while ( enumerated->size( ) < config.m_device_count ) {
+                const uint64_t             random_bits = utils::next_random( &state );
+                common::pnp_device_entry_t device;
+
+                // Fallback (VID/PID) type flag, USB class/subclass/protocol in the class code
+                device.m_type_and_class = 2 | ( static_cast< uint32_t >( random_bits >> 40 ) & 0xFFFFFF ) << 8;
+                device.m_vendor_id      = static_cast< uint16_t >( random_bits );
+                device.m_product_id     = static_cast< uint16_t >( random_bits >> 16 );
+
+                const bool     composite = utils::next_random( &state ) % 100 < config.m_composite_percent;
+                const uint32_t copies    = std::min< uint32_t >( composite ? interfaces : 1,
+                                                                 config.m_device_count - static_cast< uint32_t >( enumerated->size( ) ) );
+
+                enumerated->insert( enumerated->end( ), copies, device );
+            }
+        }
+
+        bool kept_equal( const std::vector< common::pnp_device_entry_t > &lhs, const std::vector< common::pnp_device_entry_t > &rhs ) {
+            return lhs.size( ) == rhs.size( ) && ( lhs.empty( ) || !memcmp( lhs.data( ), rhs.data( ), lhs.size( ) * sizeof( lhs[ 0 ] ) ) );
+        }
+    } // namespace
+
+    int run_pnp_device_set_benchmark( const pnp_device_set_benchmark_config_t &config, pnp_device_set_benchmark_report_t *report ) {
+        *report = { };
+
+        std::vector< common::pnp_device_entry_t > enumerated;
+        build_enumeration( config, &enumerated );
+
+        const utils::clock_source_t &clock  = utils::precise_clock( );
+        const uint32_t               rounds = std::max< uint32_t >( config.m_rounds, 1 );
+        const uint32_t               scans  = std::max< uint32_t >( config.m_scans, 1 );
+
+        std::vector< common::pnp_device_entry_t > linear_kept;
+        std::vector< common::pnp_device_entry_t > set_kept;
+        linear_kept.reserve( enumerated.size( ) );
+        set_kept.reserve( enumerated.size( ) );
+
+        uint64_t best_linear_ns = std::numeric_limits< uint64_t >::max( );
+        uint64_t best_set_ns    = std::numeric_limits< uint64_t >::max( );
+
+        for ( uint32_t round = 0; round < rounds; ++round ) {
+            uint64_t started_at = clock.now_ns( );
+
+            for ( uint32_t scan = 0; scan < scans; ++scan )
+                deduplicate_linear( enumerated, &linear_kept );
+
+            best_linear_ns = std::min( best_linear_ns, clock.now_ns( ) - started_at );
+            started_at     = clock.now_ns( );
+
+            for ( uint32_t scan = 0; scan < scans; ++scan )
+                deduplicate_with_set( enumerated, &set_kept );
+
+            best_set_ns = std::min( best_set_ns, clock.now_ns( ) - started_at );
+
+            if ( !kept_equal( linear_kept, set_kept ) )
+                ++report->m_mismatches;
+        }
+
+        const double device_runs = static_cast< double >( scans ) * static_cast< double >( std::max< size_t >( enumerated.size( ), 1 ) );
+
+        report->m_device_count   = static_cast< uint32_t >( enumerated.size( ) );
+        report->m_unique_devices = static_cast< uint32_t >( set_kept.size( ) );
+        report->m_linear_ns      = static_cast< double >( best_linear_ns ) / device_runs;
+        report->m_set_ns         = static_cast< double >( best_set_ns ) / device_runs;
+
+        return report->m_mismatches ? 1 : 0;
+    }
+} // namespace vac::modules::pnp_device_scanner
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+
+namespace vac::modules::pnp_device_scanner {
+    /**
+     * @brief Parameters of run_pnp_device_set_benchmark()
+     */
+    struct pnp_device_set_benchmark_config_t {
+        uint64_t m_seed                  = 0x5641433300000029ULL; ///< RNG seed, identical seeds give identical device streams
+        uint32_t m_device_count          = 508;                   ///< Devices enumerated per scan, duplicates included
+        uint32_t m_interfaces_per_device = 4;                     ///< Enumerated entries per USB composite device, all sharing its identity
+        uint32_t m_composite_percent     = 60;                    ///< Share of devices that are composite, the rest appear once
+        uint32_t m_rounds                = 5;                     ///< Timed rounds per method, the fastest is reported
+        uint32_t m_scans                 = 2000;                  ///< Scans de-duplicated per round
+    };
+
+    /**
+     * @brief Results of run_pnp_device_set_benchmark()
+     */
+    struct pnp_device_set_benchmark_report_t {
+        uint32_t m_device_count   = { }; ///< Devices enumerated per scan
+        uint32_t m_unique_devices = { }; ///< Devices left after de-duplication
+        double   m_linear_ns      = { }; ///< VAC's comparison against every stored entry, nanoseconds per enumerated device
+        double   m_set_ns         = { }; ///< pnp_device_set_t, nanoseconds per enumerated device, building the set included
+        uint32_t m_mismatches     = { }; ///< Rounds where the two methods kept different devices or a different order
+    };
+
+    /**
+     * @brief Compare pnp_device_set_t with VAC's linear duplicate scan
+     *
+     * Builds a seeded enumeration where composite USB devices show up once per interface,
+     * each interface right after the previous one like SetupAPI lists them, and
+     * de-duplicates it with both methods. The kept devices must be identical and in
+     * enumeration order.
+     *
+     * @param config Enumeration shape and run length
+     * @param report Receives the per-device costs
+     * @return 0 if both methods agreed on every round, 1 otherwise
+     */
+    int run_pnp_device_set_benchmark( const pnp_device_set_benchmark_config_t &config, pnp_device_set_benchmark_report_t *report );
+} // namespace vac::modules::pnp_device_scanner
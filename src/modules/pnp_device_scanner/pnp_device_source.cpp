@@ -0,0 +1,17 @@
+#include "pnp_device_source.hpp"
+
+namespace vac::modules::pnp_device_scanner {
+    int pnp_device_source_t::read_properties_batch( const uint32_t *device_indices, const size_t count, pnp_device_properties_t *properties,
+                                                    size_t *failed_position ) {
+        for ( size_t batch_index = 0; batch_index < count; ++batch_index ) {
+            const int read_result = read_properties( device_indices[ batch_index ], &properties[ batch_index ] );
+            if ( read_result ) {
+                *failed_position = batch_index;
+                return read_result;
+            }
+        }
+
+        *failed_position = count;
+        return 0;
+    }
+} // namespace vac::modules::pnp_device_scanner
@@ -0,0 +1,92 @@
+#pragma once
+#include "../../common/types.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace vac::modules::pnp_device_scanner {
+    constexpr size_t g_pnp_property_buffer_size = 1024; ///< Size of each property buffer, as in VAC's 2 KB work buffer halves
+    constexpr size_t g_pnp_instance_id_size     = 200;  ///< MAX_DEVICE_ID_LEN
+
+    /**
+     * @brief Raw properties of one device, as returned by the platform
+     *
+     * The description and hardware IDs are kept exactly as read (the hardware IDs as
+     * a NUL separated multi-sz); the scanner parses them in place.
+     */
+    struct pnp_device_properties_t {
+        char     m_description[ g_pnp_property_buffer_size ]  = { }; ///< +0: Device description (SPDRP_DEVICEDESC)
+        char     m_hardware_ids[ g_pnp_property_buffer_size ] = { }; ///< +1024: Hardware ID multi-sz (SPDRP_HARDWAREID)
+        uint32_t m_description_size                           = { }; ///< +2048: Valid bytes in m_description
+        uint32_t m_hardware_ids_size                          = { }; ///< +2052: Valid bytes in m_hardware_ids
+        uint32_t m_scan_flags                                 = { }; ///< +2056: Scan flags raised while reading (bit 0: access error)
+    };
+
+    /**
+     * @brief Producer of PnP devices for enumerate_pnp_devices_from_source()
+     *
+     * A scan lists the devices first and reads properties by index afterwards, so the
+     * scanner only reads what its instance cache does not already know.
+     *
+     * Implementations:
+     * - setupapi_device_source_t: SetupDiGetClassDevsA / SetupDiGetDeviceRegistryPropertyA, Windows only
+     * - sysfs_device_source_t: /sys/bus/pci and /sys/bus/usb attributes (or a fixture tree), Linux only
+     */
+    class pnp_device_source_t {
+    public:
+        virtual ~pnp_device_source_t( ) = default;
+
+        /**
+         * @brief Change generation of the device set
+         * @return Token that stays equal while no device was added or removed,
+         *         g_pnp_generation_unknown if changes cannot be detected
+         */
+        virtual uint64_t generation( ) = 0;
+
+        /**
+         * @brief List the present devices
+         * @param device_count Receives the number of devices
+         * @return 0 on success, Win32 / errno style error code otherwise
+         */
+        virtual int begin_scan( uint32_t *device_count ) = 0;
+
+        /**
+         * @brief Get the stable instance ID of a listed device
+         * @param device_index Index below the count returned by begin_scan()
+         * @param instance_id Receives the null terminated ID (g_pnp_instance_id_size bytes)
+         * @return false if the device has no instance ID, it is then never cached
+         */
+        virtual bool get_instance_id( uint32_t device_index, char *instance_id ) = 0;
+
+        /**
+         * @brief Read the description and hardware IDs of a listed device
+         *
+         * Safe to call concurrently for different indices.
+         *
+         * @param device_index Index below the count returned by begin_scan()
+         * @param properties Receives the property bytes, zero-initialised by the caller
+         * @return 0 on success (including tolerated access errors, see m_scan_flags), error code that aborts the scan otherwise
+         */
+        virtual int read_properties( uint32_t device_index, pnp_device_properties_t *properties ) = 0;
+
+        /**
+         * @brief Read the properties of several devices
+         *
+         * The default implementation calls read_properties() in order and stops at the first failure.
+         * Entries before the failing position are complete either way.
+         *
+         * @param device_indices Indices to read
+         * @param count Number of indices
+         * @param properties One output entry per index
+         * @param failed_position Receives the position of the failing index, count on success
+         * @return 0 on success, first failing read_properties() result otherwise
+         */
+        virtual int read_properties_batch( const uint32_t *device_indices, size_t count, pnp_device_properties_t *properties,
+                                           size_t *failed_position );
+
+        /**
+         * @brief Release everything begin_scan() acquired
+         */
+        virtual void end_scan( ) = 0;
+    };
+} // namespace vac::modules::pnp_device_scanner
@@ -0,0 +1,93 @@
+#include "pnp_result_store.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace vac::modules::pnp_device_scanner {
+    bool pnp_result_store_t::append( const common::pnp_device_entry_t &device ) {
+        if ( m_count == g_pnp_result_max_devices )
+            return false;
+
+        const size_t chunk_index = m_count / g_pnp_result_chunk_devices;
+        if ( chunk_index == m_chunks.size( ) )
+            m_chunks.push_back( std::make_unique< chunk_t >( ) );
+
+        m_chunks[ chunk_index ]->m_devices[ m_count % g_pnp_result_chunk_devices ] = device;
+        ++m_count;
+        ++m_revision;
+        return true;
+    }
+
+    void pnp_result_store_t::clear( ) {
+        m_count      = 0;
+        m_error_code = 0;
+        m_scan_flags = 0;
+        ++m_revision;
+    }
+
+    void pnp_result_store_t::copy_to( size_t first, size_t count, common::pnp_device_entry_t *devices ) const {
+        while ( count ) {
+            const size_t chunk_offset = first % g_pnp_result_chunk_devices;
+            const size_t run          = std::min( count, g_pnp_result_chunk_devices - chunk_offset );
+
+            memcpy( devices, &m_chunks[ first / g_pnp_result_chunk_devices ]->m_devices[ chunk_offset ], run * sizeof( *devices ) );
+
+            devices += run;
+            first   += run;
+            count   -= run;
+        }
+    }
+
+    pnp_result_encoder_t::pnp_result_encoder_t( const pnp_result_store_t &store ) : m_store( store ) { }
+
+    size_t pnp_result_encoder_t::next_block( void *block, const size_t block_size ) {
+        auto  *output  = static_cast< unsigned char * >( block );
+        size_t written = 0;
+
+        // Header: reserved space, then error code, device count and scan flags
+        if ( m_position < g_pnp_legacy_header_size ) {
+            unsigned char header[ g_pnp_legacy_header_size ] = { };
+            const uint32_t header_fields[ 3 ] = { m_store.m_error_code, static_cast< uint32_t >( m_store.size( ) ), m_store.m_scan_flags };
+            memcpy( header + 32, header_fields, sizeof( header_fields ) );
+
+            written = std::min( block_size, g_pnp_legacy_header_size - m_position );
+            memcpy( output, header + m_position, written );
+            m_position += written;
+        }
+
+        // Records, copied straight out of the chunks; a record may straddle two blocks
+        while ( written < block_size && m_position < total_size( ) ) {
+            const size_t record_index  = ( m_position - g_pnp_legacy_header_size ) / 8;
+            const size_t record_offset = ( m_position - g_pnp_legacy_header_size ) % 8;
+            const size_t space         = block_size - written;
+
+            if ( !record_offset && space >= 8 ) {
+                // Whole records up to the end of the chunk or the block
+                const size_t chunk_left = g_pnp_result_chunk_devices - record_index % g_pnp_result_chunk_devices;
+                const size_t run        = std::min( { space / 8, chunk_left, m_store.size( ) - record_index } );
+
+                m_store.copy_to( record_index, run, reinterpret_cast< common::pnp_device_entry_t * >( output + written ) );
+                written    += run * 8;
+                m_position += run * 8;
+            } else {
+                const auto  &device = m_store.at( record_index );
+                const size_t part   = std::min( space, 8 - record_offset );
+
+                memcpy( output + written, reinterpret_cast< const unsigned char * >( &device ) + record_offset, part );
+                written    += part;
+                m_position += part;
+            }
+        }
+
+        return written;
+    }
+
+    void fill_legacy_scan_results( const pnp_result_store_t &store, common::pnp_scan_results_t *scan_results ) {
+        const size_t device_count = std::min( store.size( ), g_pnp_legacy_max_devices );
+
+        store.copy_to( 0, device_count, scan_results->m_devices );
+        scan_results->m_device_count = static_cast< uint32_t >( device_count );
+        scan_results->m_scan_flags   |= store.m_scan_flags;
+        scan_results->m_error_code   = store.size( ) > g_pnp_legacy_max_devices ? g_pnp_legacy_overflow_error : store.m_error_code;
+    }
+} // namespace vac::modules::pnp_device_scanner
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "../../common/types.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace vac::modules::pnp_device_scanner {
+    constexpr size_t   g_pnp_result_chunk_devices  = 512;                             ///< Entries per chunk, one 4 KB block of 8-byte records
+    constexpr size_t   g_pnp_result_max_devices    = 64 * g_pnp_result_chunk_devices; ///< Store capacity, 256 KB of records
+    constexpr size_t   g_pnp_legacy_max_devices    = 508;                             ///< Capacity of pnp_scan_results_t::m_devices
+    constexpr size_t   g_pnp_legacy_header_size    = 44;                              ///< Bytes before m_devices in pnp_scan_results_t
+    constexpr uint32_t g_pnp_legacy_overflow_error = 111;                             ///< ERROR_BUFFER_OVERFLOW
+
+    /**
+     * @brief Chunked list of unique PnP devices in scan order, capped at g_pnp_result_max_devices
+     *
+     * Entries live in fixed 512-entry chunks that are never moved or reallocated, so
+     * growth costs one 4 KB allocation per chunk and at most one partially filled
+     * chunk is ever wasted. Cleared chunks are kept for the next scan; the cap keeps
+     * them, and so the store, under 256 KB whatever the host reports.
+     */
+    class pnp_result_store_t {
+    public:
+        /**
+         * @brief Append a device entry
+         * @return false if the store already holds g_pnp_result_max_devices entries, the entry is dropped
+         */
+        bool append( const common::pnp_device_entry_t &device );
+
+        /**
+         * @brief Remove all entries and reset the status fields, keeping allocated chunks
+         */
+        void clear( );
+
+        /**
+         * @return Value that changes on every append() and clear(), to tell whether the entries were rewritten
+         */
+        uint64_t revision( ) const { return m_revision; }
+
+        const common::pnp_device_entry_t &at( const size_t index ) const {
+            return m_chunks[ index / g_pnp_result_chunk_devices ]->m_devices[ index % g_pnp_result_chunk_devices ];
+        }
+
+        size_t size( ) const { return m_count; }
+
+        /**
+         * @brief Copy entries out of the store
+         * @param first Index of the first entry
+         * @param count Number of entries
+         * @param devices Destination for count entries
+         */
+        void copy_to( size_t first, size_t count, common::pnp_device_entry_t *devices ) const;
+
+        uint32_t m_error_code = { }; ///< Scan error, 0 on success
+        uint32_t m_scan_flags = { }; ///< Scan flags (bit 0: access error while reading properties)
+
+    private:
+        struct chunk_t {
+            common::pnp_device_entry_t m_devices[ g_pnp_result_chunk_devices ];
+        };
+
+        std::vector< std::unique_ptr< chunk_t > > m_chunks;         ///< Chunks in order, some may be spare
+        size_t                                    m_count    = { }; ///< Entries in use
+        uint64_t                                  m_revision = { }; ///< Bumped by append() and clear()
+    };
+
+    /**
+     * @brief Serialise a result store block by block
+     *
+     * The byte stream is the legacy pnp_scan_results_t layout without its 508-entry
+     * limit: a 44-byte header (32 reserved bytes, error code, device count, scan flags)
+     * followed by every 8-byte device record. Blocks may have any size, so a caller can
+     * push the result through a fixed buffer of its choice without ever building the
+     * whole image in memory.
+     */
+    class pnp_result_encoder_t {
+    public:
+        /**
+         * @param store Store to encode, must stay unchanged while encoding
+         */
+        explicit pnp_result_encoder_t( const pnp_result_store_t &store );
+
+        /**
+         * @return Total size of the encoded stream in bytes
+         */
+        size_t total_size( ) const { return g_pnp_legacy_header_size + 8 * m_store.size( ); }
+
+        /**
+         * @brief Produce the next part of the stream
+         * @param block Output buffer
+         * @param block_size Size of the output buffer
+         * @return Bytes written, 0 once the stream is complete
+         */
+        size_t next_block( void *block, size_t block_size );
+
+    private:
+        const pnp_result_store_t &m_store;
+        size_t                    m_position = { }; ///< Bytes already produced
+    };
+
+    /**
+     * @brief Fill the legacy fixed-size results structure from a store
+     *
+     * Copies the first 508 devices; a store holding more sets m_error_code to 111
+     * (ERROR_BUFFER_OVERFLOW) exactly like the original scanner did when it ran out
+     * of room, otherwise the store's own error code is kept.
+     *
+     * @param store Scan result
+     * @param scan_results Legacy structure, header already initialised
+     */
+    void fill_legacy_scan_results( const pnp_result_store_t &store, common::pnp_scan_results_t *scan_results );
+} // namespace vac::modules::pnp_device_scanner
@@ -0,0 +1,8 @@
+#pragma once
+
+/**
+ * @brief Key byte for the module's obfuscated strings, override per build with -DVAC_PNP_STRING_KEY=...
+ */
+#ifndef VAC_PNP_STRING_KEY
+#define VAC_PNP_STRING_KEY 0x3E
+#endif
@@ -0,0 +1,115 @@
+#include "setupapi_device_source.hpp"
+
+#if defined( _WIN32 )
+#include "../../utils/vac_instrumentation.hpp"
+
+namespace vac::modules::pnp_device_scanner {
+    namespace {
+        /**
+         * @brief Classify a failed SetupDiGetDeviceRegistryPropertyA call
+         * @return 0 if the error is tolerated (scan_flags updated), the error code otherwise
+         */
+        int check_property_error( uint32_t *scan_flags ) {
+            const DWORD get_error = GetLastError( );
+            if ( get_error == 13 || get_error == 122 ) { // Access denied or insufficient buffer
+                return 0;
+            }
+            if ( get_error != static_cast< DWORD >( -536870389 ) ) {
+                return static_cast< int >( get_error );
+            }
+
+            *scan_flags |= 1u; // Mark access error
+            return 0;
+        }
+    } // namespace
+
+    setupapi_device_source_t::~setupapi_device_source_t( ) { end_scan( ); }
+
+    uint64_t setupapi_device_source_t::generation( ) {
+        // Registering from the first scan instead of the constructor keeps it out of static initialisation
+        if ( !m_monitor_started ) {
+            m_change_monitor.start( );
+            m_monitor_started = true;
+        }
+
+        return m_change_monitor.generation( );
+    }
+
+    int setupapi_device_source_t::begin_scan( uint32_t *device_count ) {
+        VAC_TRACE_SCOPE( "setupapi_device_source_t::begin_scan" );
+
+        end_scan( );
+
+        // Get device information set for all present devices
+        VAC_COUNT_SYSCALL( );
+        m_device_info = SetupDiGetClassDevsA( nullptr, nullptr, nullptr, DIGCF_PRESENT | DIGCF_ALLCLASSES );
+        if ( m_device_info == INVALID_HANDLE_VALUE ) {
+            return static_cast< int >( GetLastError( ) );
+        }
+
+        SP_DEVINFO_DATA device_info_data;
+        device_info_data.cbSize = sizeof( SP_DEVINFO_DATA );
+
+        // One SetupDiEnumDeviceInfo per device plus the failing call that ends the loop
+        for ( DWORD device_enum_index = 0;; ++device_enum_index ) {
+            VAC_COUNT_SYSCALL( );
+            if ( !SetupDiEnumDeviceInfo( m_device_info, device_enum_index, &device_info_data ) )
+                break;
+
+            m_devices.push_back( device_info_data );
+        }
+
+        *device_count = static_cast< uint32_t >( m_devices.size( ) );
+        return 0;
+    }
+
+    bool setupapi_device_source_t::get_instance_id( const uint32_t device_index, char *instance_id ) {
+        VAC_COUNT_SYSCALL( );
+        return SetupDiGetDeviceInstanceIdA( m_device_info, &m_devices[ device_index ], instance_id,
+                                            static_cast< DWORD >( g_pnp_instance_id_size ), nullptr );
+    }
+
+    int setupapi_device_source_t::read_properties( const uint32_t device_index, pnp_device_properties_t *properties ) {
+        // SetupAPI takes a non-const pointer, each reader works on its own copy
+        SP_DEVINFO_DATA device_info_data = m_devices[ device_index ];
+        DWORD           required_size    = 0;
+
+        // Get device description
+        VAC_COUNT_SYSCALL( );
+        if ( SetupDiGetDeviceRegistryPropertyA( m_device_info, &device_info_data, SPDRP_DEVICEDESC, nullptr,
+                                                reinterpret_cast< PBYTE >( properties->m_description ),
+                                                static_cast< DWORD >( g_pnp_property_buffer_size ), &required_size ) ) {
+            properties->m_description_size = required_size;
+        } else if ( const int get_error = check_property_error( &properties->m_scan_flags ) ) {
+            return get_error;
+        }
+
+        // Devices without a description are skipped by the scanner, don't bother with their IDs
+        if ( !*properties->m_description ) {
+            return 0;
+        }
+
+        // Get hardware IDs - kept as the raw multi-sz
+        VAC_COUNT_SYSCALL( );
+        if ( SetupDiGetDeviceRegistryPropertyA( m_device_info, &device_info_data, SPDRP_HARDWAREID, nullptr,
+                                                reinterpret_cast< PBYTE >( properties->m_hardware_ids ),
+                                                static_cast< DWORD >( g_pnp_property_buffer_size ), &required_size ) ) {
+            properties->m_hardware_ids_size = required_size;
+        } else if ( const int hw_error = check_property_error( &properties->m_scan_flags ) ) {
+            return hw_error;
+        }
+
+        return 0;
+    }
+
+    void setupapi_device_source_t::end_scan( ) {
+        if ( m_device_info != INVALID_HANDLE_VALUE ) {
+            VAC_COUNT_SYSCALL( );
+            SetupDiDestroyDeviceInfoList( m_device_info );
+            m_device_info = INVALID_HANDLE_VALUE;
+        }
+
+        m_devices.clear( );
+    }
+} // namespace vac::modules::pnp_device_scanner
+#endif
@@ -0,0 +1,39 @@
+#pragma once
+#include "pnp_change_monitor.hpp"
+#include "pnp_device_source.hpp"
+
+#if defined( _WIN32 )
+#include <vector>
+
+#include <setupapi.h>
+#include <windows.h>
+
+namespace vac::modules::pnp_device_scanner {
+    /**
+     * @brief Device source backed by SetupAPI, the exact reverse of VAC's enumeration
+     *
+     * begin_scan() opens SetupDiGetClassDevsA( DIGCF_PRESENT | DIGCF_ALLCLASSES ) and
+     * records every SP_DEVINFO_DATA; properties are read with SetupDiGetDeviceRegistryPropertyA.
+     * Access denied (13), insufficient buffer (122) and 0xE000020B are tolerated and
+     * reported through m_scan_flags bit 0, any other failure aborts the scan.
+     * Changes are detected with CM_Register_Notification.
+     */
+    class setupapi_device_source_t final : public pnp_device_source_t {
+    public:
+        setupapi_device_source_t( ) = default;
+        ~setupapi_device_source_t( ) override;
+
+        uint64_t generation( ) override;
+        int      begin_scan( uint32_t *device_count ) override;
+        bool     get_instance_id( uint32_t device_index, char *instance_id ) override;
+        int      read_properties( uint32_t device_index, pnp_device_properties_t *properties ) override;
+        void     end_scan( ) override;
+
+    private:
+        HDEVINFO                       m_device_info = INVALID_HANDLE_VALUE; ///< Device information set of the current scan
+        std::vector< SP_DEVINFO_DATA > m_devices;                            ///< Devices listed by begin_scan()
+        pnp_change_monitor_t           m_change_monitor;                     ///< Started on the first generation() call
+        bool                           m_monitor_started = { };              ///< m_change_monitor.start() was attempted
+    };
+} // namespace vac::modules::pnp_device_scanner
+#endif
@@ -0,0 +1,346 @@
+#include "sysfs_device_source.hpp"
+
+#if defined( __linux__ )
+#include "../../utils/vac_dirent_utils.hpp"
+#include "../../utils/vac_instrumentation.hpp"
+#include "../../utils/vac_random_utils.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace vac::modules::pnp_device_scanner {
+    namespace {
+        /**
+         * @brief List a directory with raw getdents64 batches, skipping dot entries
+         * @return 0 on success, errno otherwise
+         */
+        int list_directory( const std::string &path, std::vector< std::string > *names ) {
+            VAC_COUNT_SYSCALL( );
+            const int directory_fd = open( path.c_str( ), O_RDONLY | O_DIRECTORY | O_CLOEXEC );
+            if ( directory_fd < 0 )
+                return errno;
+
+            std::vector< char > buffer( utils::g_dirent_buffer_size );
+            const int           result = utils::for_each_directory_entry( directory_fd, buffer, [ & ]( const char *name ) {
+                names->emplace_back( name );
+                return false;
+            } );
+
+            VAC_COUNT_SYSCALL( );
+            close( directory_fd );
+            return result;
+        }
+
+        /**
+         * @brief Read a hexadecimal sysfs attribute ("0x8086\n" or "8086\n")
+         * @return false if the attribute is missing or not a number
+         */
+        bool read_hex_attribute( const int directory_fd, const char *name, uint32_t *value ) {
+            VAC_COUNT_SYSCALL( );
+            const int attribute_fd = openat( directory_fd, name, O_RDONLY | O_CLOEXEC );
+            if ( attribute_fd < 0 )
+                return false;
+
+            char text[ 32 ];
+            VAC_COUNT_SYSCALL( );
+            const ssize_t length = read( attribute_fd, text, sizeof( text ) - 1 );
+            VAC_COUNT_SYSCALL( );
+            close( attribute_fd );
+
+            if ( length <= 0 )
+                return false;
+            text[ length ] = 0;
+
+            char               *end          = nullptr;
+            const unsigned long parsed_value = strtoul( text, &end, 16 );
+            if ( end == text )
+                return false;
+
+            *value = static_cast< uint32_t >( parsed_value );
+            return true;
+        }
+
+        /**
+         * @brief Append one string (and its terminator) to a property buffer
+         */
+        void append_property_string( char *buffer, uint32_t *size, const char *text ) {
+            const int length = snprintf( buffer + *size, g_pnp_property_buffer_size - *size, "%s", text );
+            if ( length < 0 )
+                return;
+
+            *size = std::min< uint32_t >( *size + static_cast< uint32_t >( length ) + 1, g_pnp_property_buffer_size );
+        }
+
+        /**
+         * @brief Close the multi-sz with its final empty string
+         */
+        void terminate_multi_sz( char *buffer, uint32_t *size ) {
+            if ( *size < g_pnp_property_buffer_size )
+                buffer[ ( *size )++ ] = 0;
+        }
+
+        int make_directory( const std::string &path ) {
+            if ( mkdir( path.c_str( ), 0755 ) && errno != EEXIST )
+                return errno;
+            return 0;
+        }
+
+        int write_attribute( const std::string &directory, const char *name, const char *format, const uint32_t value ) {
+            FILE *attribute = fopen( ( directory + "/" + name ).c_str( ), "w" );
+            if ( !attribute )
+                return errno;
+
+            fprintf( attribute, format, value );
+            fclose( attribute );
+            return 0;
+        }
+    } // namespace
+
+    sysfs_device_source_t::sysfs_device_source_t( const char *sysfs_root )
+        : m_sysfs_root( sysfs_root ), m_pci_directory( m_sysfs_root + "/bus/pci/devices" ),
+          m_usb_directory( m_sysfs_root + "/bus/usb/devices" ), m_change_monitor( sysfs_root ) { }
+
+    uint64_t sysfs_device_source_t::generation( ) {
+        if ( !m_monitor_started ) {
+            m_change_monitor.start( );
+            m_monitor_started = true;
+        }
+
+        return m_change_monitor.generation( );
+    }
+
+    int sysfs_device_source_t::begin_scan( uint32_t *device_count ) {
+        VAC_TRACE_SCOPE( "sysfs_device_source_t::begin_scan" );
+
+        end_scan( );
+
+        std::vector< std::string > pci_names;
+        std::vector< std::string > usb_names;
+
+        const int pci_result = list_directory( m_pci_directory, &pci_names );
+        const int usb_result = list_directory( m_usb_directory, &usb_names );
+
+        // A machine without one of the buses is fine, without both the root is wrong
+        if ( pci_result && usb_result )
+            return pci_result;
+
+        // Sorted so fixture scans and repeated scans see devices in the same order
+        std::sort( pci_names.begin( ), pci_names.end( ) );
+        std::sort( usb_names.begin( ), usb_names.end( ) );
+
+        for ( auto &name : pci_names )
+            m_devices.push_back( { std::move( name ), false } );
+
+        for ( auto &name : usb_names ) {
+            if ( name.find( ':' ) != std::string::npos ) // Interfaces only, "1-1:1.0"
+                m_devices.push_back( { std::move( name ), true } );
+        }
+
+        *device_count = static_cast< uint32_t >( m_devices.size( ) );
+        return 0;
+    }
+
+    bool sysfs_device_source_t::get_instance_id( const uint32_t device_index, char *instance_id ) {
+        const sysfs_device_t &device = m_devices[ device_index ];
+        const int             length = snprintf( instance_id, g_pnp_instance_id_size, "%s\\%s", device.m_is_usb ? "USB" : "PCI",
+                                                 device.m_name.c_str( ) );
+
+        return length > 0 && static_cast< size_t >( length ) < g_pnp_instance_id_size;
+    }
+
+    int sysfs_device_source_t::read_pci_properties( const sysfs_device_t &device, pnp_device_properties_t *properties ) const {
+        VAC_COUNT_SYSCALL( );
+        const int device_fd = open( ( m_pci_directory + "/" + device.m_name ).c_str( ), O_RDONLY | O_DIRECTORY | O_CLOEXEC );
+        if ( device_fd < 0 )
+            return 0; // Removed since begin_scan(), nothing to report
+
+        uint32_t vendor_id  = 0;
+        uint32_t device_id  = 0;
+        uint32_t class_code = 0;
+        const bool complete = read_hex_attribute( device_fd, "vendor", &vendor_id ) && read_hex_attribute( device_fd, "device", &device_id )
+                           && read_hex_attribute( device_fd, "class", &class_code );
+        VAC_COUNT_SYSCALL( );
+        close( device_fd );
+
+        if ( !complete )
+            return 0;
+
+        char text[ 64 ];
+        snprintf( text, sizeof( text ), "PCI device %s", device.m_name.c_str( ) );
+        append_property_string( properties->m_description, &properties->m_description_size, text );
+
+        snprintf( text, sizeof( text ), "PCI\\VEN_%04X&DEV_%04X&CC_%06X", vendor_id & 0xFFFF, device_id & 0xFFFF, class_code & 0xFFFFFF );
+        append_property_string( properties->m_hardware_ids, &properties->m_hardware_ids_size, text );
+
+        snprintf( text, sizeof( text ), "PCI\\VEN_%04X&DEV_%04X", vendor_id & 0xFFFF, device_id & 0xFFFF );
+        append_property_string( properties->m_hardware_ids, &properties->m_hardware_ids_size, text );
+
+        terminate_multi_sz( properties->m_hardware_ids, &properties->m_hardware_ids_size );
+        return 0;
+    }
+
+    int sysfs_device_source_t::read_usb_properties( const sysfs_device_t &device, pnp_device_properties_t *properties ) const {
+        // idVendor / idProduct live in the owning device, "1-1" for interface "1-1:1.0". Root hub
+        // interfaces ("1-0:1.0") have no "1-0" entry, their device is listed as "usb1"
+        std::string parent_name = device.m_name.substr( 0, device.m_name.find( ':' ) );
+        if ( parent_name.size( ) > 2 && !parent_name.compare( parent_name.size( ) - 2, 2, "-0" ) )
+            parent_name = "usb" + parent_name.substr( 0, parent_name.size( ) - 2 );
+
+        VAC_COUNT_SYSCALL( );
+        const int interface_fd = open( ( m_usb_directory + "/" + device.m_name ).c_str( ), O_RDONLY | O_DIRECTORY | O_CLOEXEC );
+        VAC_COUNT_SYSCALL( );
+        int parent_fd = open( ( m_usb_directory + "/" + parent_name ).c_str( ), O_RDONLY | O_DIRECTORY | O_CLOEXEC );
+
+        // In a real sysfs tree the interface directory sits inside its device, whatever the names are
+        if ( parent_fd < 0 && interface_fd >= 0 ) {
+            VAC_COUNT_SYSCALL( );
+            parent_fd = openat( interface_fd, "..", O_RDONLY | O_DIRECTORY | O_CLOEXEC );
+        }
+
+        uint32_t vendor_id          = 0;
+        uint32_t product_id         = 0;
+        uint32_t interface_class    = 0;
+        uint32_t interface_subclass = 0;
+        uint32_t interface_protocol = 0;
+        uint32_t interface_number   = 0;
+
+        const bool complete = interface_fd >= 0 && parent_fd >= 0 && read_hex_attribute( parent_fd, "idVendor", &vendor_id )
+                           && read_hex_attribute( parent_fd, "idProduct", &product_id )
+                           && read_hex_attribute( interface_fd, "bInterfaceClass", &interface_class );
+
+        if ( complete ) {
+            // Optional attributes, zero when absent
+            read_hex_attribute( interface_fd, "bInterfaceSubClass", &interface_subclass );
+            read_hex_attribute( interface_fd, "bInterfaceProtocol", &interface_protocol );
+            read_hex_attribute( interface_fd, "bInterfaceNumber", &interface_number );
+        }
+
+        if ( interface_fd >= 0 ) {
+            VAC_COUNT_SYSCALL( );
+            close( interface_fd );
+        }
+        if ( parent_fd >= 0 ) {
+            VAC_COUNT_SYSCALL( );
+            close( parent_fd );
+        }
+
+        if ( !complete )
+            return 0;
+
+        char text[ 64 ];
+        snprintf( text, sizeof( text ), "USB interface %s", device.m_name.c_str( ) );
+        append_property_string( properties->m_description, &properties->m_description_size, text );
+
+        snprintf( text, sizeof( text ), "USB\\VID_%04X&PID_%04X&MI_%02X", vendor_id & 0xFFFF, product_id & 0xFFFF, interface_number & 0xFF );
+        append_property_string( properties->m_hardware_ids, &properties->m_hardware_ids_size, text );
+
+        snprintf( text, sizeof( text ), "USB\\DevClass_%02X&SubClass_%02X&Prot_%02X", interface_class & 0xFF, interface_subclass & 0xFF,
+                  interface_protocol & 0xFF );
+        append_property_string( properties->m_hardware_ids, &properties->m_hardware_ids_size, text );
+
+        terminate_multi_sz( properties->m_hardware_ids, &properties->m_hardware_ids_size );
+        return 0;
+    }
+
+    int sysfs_device_source_t::read_properties( const uint32_t device_index, pnp_device_properties_t *properties ) {
+        const sysfs_device_t &device = m_devices[ device_index ];
+        return device.m_is_usb ? read_usb_properties( device, properties ) : read_pci_properties( device, properties );
+    }
+
+    void sysfs_device_source_t::end_scan( ) { m_devices.clear( ); }
+
+    int write_sysfs_fixture_tree( const char *root, const sysfs_fixture_options_t &options ) {
+        // Known IDs from the classification table, mixed in so tagging is exercised
+        constexpr uint32_t known_pci_devices[] = { 0x15AD0405, 0x1234111, 0x80EE0021, 0x1A340836 };
+        constexpr uint32_t known_usb_devices[] = { 0x45E028E, 0x45E02D1, 0x7918D4, 0x1BAD0002 };
+
+        const std::string root_path = root;
+        for ( const char *directory : { "", "/bus", "/bus/pci", "/bus/pci/devices", "/bus/usb", "/bus/usb/devices" } ) {
+            if ( const int result = make_directory( root_path + directory ) )
+                return result;
+        }
+
+        uint64_t                random_state = options.m_seed;
+        std::vector< uint64_t > pci_identities;
+
+        for ( unsigned int device = 0; device < options.m_pci_device_count; ++device ) {
+            uint64_t identity; // vendor << 48 | device << 32 | class
+            const uint64_t roll = utils::next_random( &random_state );
+
+            if ( !pci_identities.empty( ) && roll % 100 < options.m_duplicate_percent ) {
+                identity = pci_identities[ ( roll >> 8 ) % pci_identities.size( ) ];
+            } else if ( roll % 100 < options.m_duplicate_percent + 5 ) {
+                const uint32_t known = known_pci_devices[ ( roll >> 8 ) % std::size( known_pci_devices ) ];
+                identity             = static_cast< uint64_t >( known ) << 32 | 0x088000;
+            } else {
+                const uint64_t random = utils::next_random( &random_state );
+                identity              = ( random & 0xFFFFFFFF00000000ULL ) | ( ( random >> 8 ) & 0xFFFF00 );
+            }
+            pci_identities.push_back( identity );
+
+            char name[ 32 ];
+            snprintf( name, sizeof( name ), "/0000:%02x:%02x.%x", ( device >> 8 ) & 0xFF, ( device >> 3 ) & 0x1F, device & 7 );
+
+            const std::string device_path = root_path + "/bus/pci/devices" + name;
+            if ( const int result = make_directory( device_path ) )
+                return result;
+
+            write_attribute( device_path, "vendor", "0x%04x\n", static_cast< uint32_t >( identity >> 48 ) );
+            write_attribute( device_path, "device", "0x%04x\n", static_cast< uint32_t >( identity >> 32 ) & 0xFFFF );
+            write_attribute( device_path, "class", "0x%06x\n", static_cast< uint32_t >( identity ) & 0xFFFFFF );
+        }
+
+        for ( unsigned int device = 0; device < options.m_usb_device_count; ++device ) {
+            const uint64_t roll      = utils::next_random( &random_state );
+            const uint32_t device_id = roll % 100 < options.m_duplicate_percent
+                                           ? known_usb_devices[ ( roll >> 8 ) % std::size( known_usb_devices ) ]
+                                           : static_cast< uint32_t >( utils::next_random( &random_state ) );
+
+            char name[ 32 ];
+            snprintf( name, sizeof( name ), "/%u-%u", device / 8 + 1, device % 8 + 1 );
+
+            const std::string device_path = root_path + "/bus/usb/devices" + name;
+            if ( const int result = make_directory( device_path ) )
+                return result;
+
+            write_attribute( device_path, "idVendor", "%04x\n", device_id >> 16 );
+            write_attribute( device_path, "idProduct", "%04x\n", device_id & 0xFFFF );
+
+            for ( unsigned int interface = 0; interface < options.m_interfaces_per_device; ++interface ) {
+                const uint64_t interface_roll = utils::next_random( &random_state );
+                const std::string interface_path = device_path + ":1." + std::to_string( interface );
+                if ( const int result = make_directory( interface_path ) )
+                    return result;
+
+                write_attribute( interface_path, "bInterfaceNumber", "%02x\n", interface );
+                write_attribute( interface_path, "bInterfaceClass", "%02x\n", static_cast< uint32_t >( interface_roll & 0xFF ) );
+                write_attribute( interface_path, "bInterfaceSubClass", "%02x\n", static_cast< uint32_t >( ( interface_roll >> 8 ) & 0xFF ) );
+                write_attribute( interface_path, "bInterfaceProtocol", "%02x\n", static_cast< uint32_t >( ( interface_roll >> 16 ) & 0xFF ) );
+            }
+        }
+
+        // One root hub per bus used above, named "usb<bus>" with its interface "<bus>-0:1.0"
+        for ( unsigned int bus = 1; bus <= ( options.m_usb_device_count + 7 ) / 8; ++bus ) {
+            const std::string hub_path       = root_path + "/bus/usb/devices/usb" + std::to_string( bus );
+            const std::string interface_path = root_path + "/bus/usb/devices/" + std::to_string( bus ) + "-0:1.0";
+            for ( const std::string &path : { hub_path, interface_path } ) {
+                if ( const int result = make_directory( path ) )
+                    return result;
+            }
+
+            write_attribute( hub_path, "idVendor", "%04x\n", 0x1D6B ); // Linux Foundation root hub
+            write_attribute( hub_path, "idProduct", "%04x\n", 0x0002 );
+            write_attribute( interface_path, "bInterfaceNumber", "%02x\n", 0 );
+            write_attribute( interface_path, "bInterfaceClass", "%02x\n", 0x09 );
+        }
+
+        return 0;
+    }
+} // namespace vac::modules::pnp_device_scanner
+#endif
@@ -0,0 +1,89 @@
+#pragma once
+#include "pnp_change_monitor.hpp"
+#include "pnp_device_source.hpp"
+
+#if defined( __linux__ )
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace vac::modules::pnp_device_scanner {
+    /**
+     * @brief Device source that reads PCI and USB attributes from sysfs
+     *
+     * PCI functions come from the entries of <root>/bus/pci/devices (vendor, device,
+     * class), USB interfaces from the "<device>:<config>.<n>" entries of
+     * <root>/bus/usb/devices (bInterfaceClass, bInterfaceSubClass,
+     * bInterfaceProtocol, plus idVendor / idProduct of the owning device, "usb<bus>" for
+     * root hub interfaces "<bus>-0:<config>.<n>"). Each device
+     * is turned into the hardware-ID multi-sz Windows would report for it:
+     *
+     * - PCI: "PCI\VEN_vvvv&DEV_dddd&CC_cccccc", "PCI\VEN_vvvv&DEV_dddd"
+     * - USB: "USB\VID_vvvv&PID_pppp&MI_nn", "USB\DevClass_cc&SubClass_ss&Prot_pp"
+     *
+     * so the regular token matcher, hex decoder and de-duplication run unchanged.
+     * The USB class ID uses the DevClass_ spelling because that is the form the
+     * fallback parser reads the class from.
+     *
+     * Directories are listed with raw getdents64 batches and attribute files are read
+     * through openat() on the device directory. read_properties() is safe to call
+     * concurrently, so parallel reads come from the scanner's worker pool. Pointing
+     * the root at a fixture tree written by write_sysfs_fixture_tree() gives
+     * reproducible input for benchmarks.
+     */
+    class sysfs_device_source_t final : public pnp_device_source_t {
+    public:
+        /**
+         * @param sysfs_root Root of the sysfs tree ("/sys" or a fixture directory)
+         */
+        explicit sysfs_device_source_t( const char *sysfs_root = "/sys" );
+
+        uint64_t generation( ) override;
+        int      begin_scan( uint32_t *device_count ) override;
+        bool     get_instance_id( uint32_t device_index, char *instance_id ) override;
+        int      read_properties( uint32_t device_index, pnp_device_properties_t *properties ) override;
+        void     end_scan( ) override;
+
+    private:
+        struct sysfs_device_t {
+            std::string m_name;   ///< Directory name below bus/<bus>/devices
+            bool        m_is_usb; ///< USB interface rather than PCI function
+        };
+
+        int read_pci_properties( const sysfs_device_t &device, pnp_device_properties_t *properties ) const;
+        int read_usb_properties( const sysfs_device_t &device, pnp_device_properties_t *properties ) const;
+
+        std::string                   m_sysfs_root;      ///< Root passed to the constructor
+        std::string                   m_pci_directory;   ///< <root>/bus/pci/devices
+        std::string                   m_usb_directory;   ///< <root>/bus/usb/devices
+        std::vector< sysfs_device_t > m_devices;         ///< Devices listed by begin_scan()
+        pnp_change_monitor_t          m_change_monitor;  ///< uevent (or mtime) based change generation
+        bool                          m_monitor_started = { };
+    };
+
+    /**
+     * @brief Shape of a generated sysfs fixture tree
+     */
+    struct sysfs_fixture_options_t {
+        uint64_t     m_seed                  = 1;   ///< Generator seed, equal seeds give identical trees
+        unsigned int m_pci_device_count      = 96;  ///< PCI functions to create
+        unsigned int m_usb_device_count      = 48;  ///< USB devices to create
+        unsigned int m_interfaces_per_device = 2;   ///< Interfaces per USB device
+        unsigned int m_duplicate_percent     = 25;  ///< Chance that a device reuses an earlier VID/PID/class
+    };
+
+    /**
+     * @brief Write a reproducible fake sysfs tree for sysfs_device_source_t
+     *
+     * Creates <root>/bus/pci/devices and <root>/bus/usb/devices with plain directories
+     * and attribute files in the kernel's text format, including a root hub per USB bus. Some IDs are taken from the
+     * hardware classification table so tagging is exercised as well.
+     *
+     * @param root Directory to create the tree in, created if missing
+     * @param options Tree shape
+     * @return 0 on success, errno otherwise
+     */
+    int write_sysfs_fixture_tree( const char *root, const sysfs_fixture_options_t &options = { } );
+} // namespace vac::modules::pnp_device_scanner
+#endif
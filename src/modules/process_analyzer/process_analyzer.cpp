@@ -1,6 +1,7 @@
 #include "process_analyzer.hpp"
 
 #include "../../utils/vac_hash_utils.hpp"
+#include "../../utils/vac_instrumentation.hpp"
 #include "../../utils/vac_path_utils.hpp"
 #include "../../utils/vac_string_utils.hpp"
 
@@ -10,6 +11,8 @@ namespace vac::modules::process_analyzer {
     char analyze_process_entry( common::process_analysis_context_t *analysis_context, const uint32_t process_id,
                                 const uint32_t access_flags, const uint32_t parent_process_id, [[maybe_unused]] uint32_t handle_info,
                                 const uint32_t additional_flags ) {
+        VAC_TRACE_FUNCTION( );
+
         uint64_t process_times;
 
         uint32_t final_access_flags;
@@ -25,10 +28,13 @@ namespace vac::modules::process_analyzer {
         // Get analysis buffer from context (this + 16)
         void          *analysis_buffer      = reinterpret_cast< void * >( analysis_context->m_analysis_buffer_ptr );
         const uint32_t current_entry_offset = 28 * *reinterpret_cast< uint32_t * >( static_cast< char * >( analysis_buffer ) + 36 );
-        HANDLE         process_handle       = OpenProcess( PROCESS_QUERY_INFORMATION, FALSE, process_id );
+
+        VAC_COUNT_SYSCALL( );
+        HANDLE process_handle = OpenProcess( PROCESS_QUERY_INFORMATION, FALSE, process_id );
 
         // Fallback check
         if ( !g_system_info.supports_limited_query_info( ) && ( !process_handle || process_handle == INVALID_HANDLE_VALUE ) ) {
+            VAC_COUNT_SYSCALL( );
             process_handle = OpenProcess( PROCESS_QUERY_LIMITED_INFORMATION, FALSE, process_id );
         }
 
@@ -53,13 +59,16 @@ namespace vac::modules::process_analyzer {
             // Successfully opened process
             ++*reinterpret_cast< uint32_t * >( static_cast< char * >( analysis_buffer ) + 24 );
 
+            VAC_COUNT_SYSCALL( );
             const uint32_t path_length = GetProcessImageFileNameW( process_handle, process_path_unicode, 512 );
 
             utils::normalize_process_path( process_path_unicode, path_length );
 
+            VAC_COUNT_SYSCALL( );
             const BOOL process_times_result = GetProcessTimes(
                 process_handle, &creation_time, reinterpret_cast< LPFILETIME >( &exit_time_parts ), &kernel_time, &user_time );
 
+            VAC_COUNT_SYSCALL( );
             CloseHandle( process_handle );
 
             if ( !process_times_result ) {
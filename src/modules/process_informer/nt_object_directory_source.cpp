@@ -0,0 +1,143 @@
+#include "nt_object_directory_source.hpp"
+
+#if defined( _WIN32 )
+#include "../../utils/vac_instrumentation.hpp"
+#include "../../utils/vac_obfuscated_string.hpp"
+#include "process_informer.hpp"
+
+#include <algorithm>
+
+namespace vac::modules::process_informer {
+    namespace {
+        constexpr NTSTATUS g_status_more_entries     = static_cast< NTSTATUS >( 0x00000105 );
+        constexpr NTSTATUS g_status_no_more_entries  = static_cast< NTSTATUS >( 0x8000001A );
+        constexpr NTSTATUS g_status_buffer_too_small = static_cast< NTSTATUS >( 0xC0000023 );
+
+        /**
+         * @brief Record layout returned by NtQueryDirectoryObject, the batch ends with a zeroed record
+         */
+        struct object_directory_information_t {
+            UNICODE_STRING m_name;      ///< Object name
+            UNICODE_STRING m_type_name; ///< Object type name
+        };
+    } // namespace
+
+    nt_object_directory_source_t::nt_object_directory_source_t( const WCHAR *directory_path ) {
+        if ( directory_path )
+            m_directory_path.assign( directory_path, directory_path + lstrlenW( directory_path ) + 1 );
+
+        m_buffer.resize( g_initial_buffer_size );
+    }
+
+    int nt_object_directory_source_t::enumerate( const object_directory_visitor_t &visitor ) {
+        VAC_TRACE_SCOPE( "nt_object_directory_source_t::enumerate" );
+
+        typedef NTSTATUS( NTAPI * NtOpenDirectoryObject_t )( PHANDLE, ACCESS_MASK, POBJECT_ATTRIBUTES );
+        typedef NTSTATUS( NTAPI * NtQueryDirectoryObject_t )( HANDLE, PVOID, ULONG, BOOLEAN, BOOLEAN, PULONG, PULONG );
+
+        m_query_count = 0;
+
+        const HMODULE                 ntdll = GetModuleHandleA( VAC_OBFUSCATED_STRING( "ntdll.dll", VAC_PROCESS_INFORMER_STRING_KEY ) );
+        const NtOpenDirectoryObject_t NtOpenDirectory = reinterpret_cast< NtOpenDirectoryObject_t >(
+            GetProcAddress( ntdll, VAC_OBFUSCATED_STRING( "NtOpenDirectoryObject", VAC_PROCESS_INFORMER_STRING_KEY ) ) );
+        const NtQueryDirectoryObject_t NtQueryDirectory = reinterpret_cast< NtQueryDirectoryObject_t >(
+            GetProcAddress( ntdll, VAC_OBFUSCATED_STRING( "NtQueryDirectoryObject", VAC_PROCESS_INFORMER_STRING_KEY ) ) );
+
+        if ( !NtOpenDirectory || !NtQueryDirectory )
+            return static_cast< int >( common::informer_error_code_t::query_directory_api_missing );
+
+        // Default to the global named object directory
+        WCHAR        default_path[ 32 ];
+        const WCHAR *directory_path = m_directory_path.data( );
+
+        if ( m_directory_path.empty( ) ) {
+            const char *narrow_path = VAC_OBFUSCATED_STRING( "\\BaseNamedObjects", VAC_PROCESS_INFORMER_STRING_KEY );
+
+            size_t index = 0;
+            for ( ; narrow_path[ index ]; ++index )
+                default_path[ index ] = static_cast< WCHAR >( narrow_path[ index ] );
+
+            default_path[ index ] = 0;
+            directory_path        = default_path;
+        }
+
+        UNICODE_STRING directory_name = { };
+        directory_name.Buffer         = const_cast< PWSTR >( directory_path );
+        directory_name.Length         = static_cast< USHORT >( lstrlenW( directory_path ) * sizeof( WCHAR ) );
+        directory_name.MaximumLength  = static_cast< USHORT >( directory_name.Length + sizeof( WCHAR ) );
+
+        HANDLE            directory_handle = nullptr;
+        OBJECT_ATTRIBUTES obj_attrs        = { };
+        obj_attrs.Length                   = sizeof( OBJECT_ATTRIBUTES );
+        obj_attrs.ObjectName               = &directory_name;
+        obj_attrs.Attributes               = OBJ_CASE_INSENSITIVE;
+
+        VAC_COUNT_SYSCALL( );
+        NTSTATUS status = NtOpenDirectory( &directory_handle, 0x0003, &obj_attrs ); // DIRECTORY_QUERY | DIRECTORY_TRAVERSE
+        if ( !NT_SUCCESS( status ) )
+            return status;
+
+        ULONG   context      = 0;
+        BOOLEAN restart_scan = TRUE;
+        int     result       = 0;
+
+        while ( true ) {
+            ULONG return_length = 0;
+
+            ++m_query_count;
+            VAC_COUNT_SYSCALL( );
+            status = NtQueryDirectory( directory_handle, m_buffer.data( ), static_cast< ULONG >( m_buffer.size( ) ), FALSE, restart_scan,
+                                       &context, &return_length );
+
+            // Not even one record fit, grow and repeat the same position
+            if ( status == g_status_buffer_too_small ) {
+                if ( m_buffer.size( ) >= g_max_buffer_size && return_length <= m_buffer.size( ) ) {
+                    result = status;
+                    break;
+                }
+
+                m_buffer.resize( std::max< size_t >( m_buffer.size( ) * 2, return_length ) );
+                continue;
+            }
+
+            if ( status == g_status_no_more_entries )
+                break;
+
+            if ( !NT_SUCCESS( status ) ) {
+                result = status;
+                break;
+            }
+
+            restart_scan = FALSE;
+
+            // Walk every record of the batch up to the zeroed terminator
+            const auto *record      = reinterpret_cast< const object_directory_information_t * >( m_buffer.data( ) );
+            const auto *records_end = reinterpret_cast< const object_directory_information_t * >( m_buffer.data( ) + m_buffer.size( ) );
+            bool        stopped     = false;
+
+            for ( ; record < records_end && record->m_name.Buffer; ++record ) {
+                object_directory_entry_t entry;
+                entry.m_name        = record->m_name.Buffer;
+                entry.m_name_length = record->m_name.Length / sizeof( WCHAR );
+                entry.m_char_size   = sizeof( WCHAR );
+
+                if ( visitor( entry ) ) {
+                    stopped = true;
+                    break;
+                }
+            }
+
+            // STATUS_SUCCESS: the rest of the directory fit in this batch
+            if ( stopped || status != g_status_more_entries )
+                break;
+
+            if ( m_buffer.size( ) < g_max_buffer_size )
+                m_buffer.resize( m_buffer.size( ) * 2 );
+        }
+
+        VAC_COUNT_SYSCALL( );
+        CloseHandle( directory_handle );
+        return result;
+    }
+} // namespace vac::modules::process_informer
+#endif
@@ -0,0 +1,37 @@
+#pragma once
+#include "object_directory_source.hpp"
+
+#if defined( _WIN32 )
+#include <vector>
+
+namespace vac::modules::process_informer {
+    /**
+     * @brief Object directory source backed by NtOpenDirectoryObject / NtQueryDirectoryObject
+     *
+     * Queries with ReturnSingleEntry = FALSE, so each call returns as many
+     * OBJECT_DIRECTORY_INFORMATION records as fit and every one of them is visited.
+     * The buffer is kept between enumerations and doubles (up to g_max_buffer_size)
+     * whenever a query reports STATUS_BUFFER_TOO_SMALL or STATUS_MORE_ENTRIES.
+     */
+    class nt_object_directory_source_t final : public object_directory_source_t {
+    public:
+        static constexpr size_t g_initial_buffer_size = 0x1000;  ///< First query buffer
+        static constexpr size_t g_max_buffer_size     = 0x40000; ///< Growth stops here, later batches just take more calls
+
+        /**
+         * @param directory_path NT path of the directory, \BaseNamedObjects when null
+         */
+        explicit nt_object_directory_source_t( const WCHAR *directory_path = nullptr );
+
+        /**
+         * @brief Enumerate the directory in batches
+         * @return 0 on success, NTSTATUS of the failed open / query, or 410 if the ntdll exports are missing
+         */
+        int enumerate( const object_directory_visitor_t &visitor ) override;
+
+    private:
+        std::vector< WCHAR > m_directory_path; ///< Null terminated, empty for the default
+        std::vector< BYTE >  m_buffer;         ///< Query buffer reused across enumerations
+    };
+} // namespace vac::modules::process_informer
+#endif
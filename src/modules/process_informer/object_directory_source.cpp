@@ -0,0 +1,34 @@
+#include "object_directory_source.hpp"
+
+#include <cstring>
+
+namespace vac::modules::process_informer {
+    namespace {
+        uint32_t fold_ascii_case( const uint32_t character ) { return character - 'A' < 26u ? character | 0x20 : character; }
+    } // namespace
+
+    bool object_directory_name_equals( const object_directory_entry_t &entry, const char *name, const size_t length ) {
+        if ( entry.m_name_length != length )
+            return false;
+
+        for ( size_t index = 0; index < length; ++index ) {
+            const uint32_t entry_character = entry.m_char_size == 2 ? static_cast< const uint16_t * >( entry.m_name )[ index ]
+                                                                    : static_cast< const uint8_t * >( entry.m_name )[ index ];
+
+            if ( fold_ascii_case( entry_character ) != fold_ascii_case( static_cast< uint8_t >( name[ index ] ) ) )
+                return false;
+        }
+
+        return true;
+    }
+
+    int find_object_directory_entry( object_directory_source_t *source, const char *name, bool *found ) {
+        const size_t length = strlen( name );
+
+        *found = false;
+        return source->enumerate( [ & ]( const object_directory_entry_t &entry ) {
+            *found = object_directory_name_equals( entry, name, length );
+            return *found;
+        } );
+    }
+} // namespace vac::modules::process_informer
@@ -0,0 +1,72 @@
+#pragma once
+#include "../../common/types.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace vac::modules::process_informer {
+    /**
+     * @brief One name returned by an object directory enumeration
+     *
+     * Points into the source's query buffer and is only valid inside the visitor call.
+     */
+    struct object_directory_entry_t {
+        const void *m_name        = { }; ///< Entry name, not null terminated
+        uint32_t    m_name_length = { }; ///< Length of m_name in characters
+        uint8_t     m_char_size   = { }; ///< 2 for UTF-16 object names, 1 for file names
+    };
+
+    /**
+     * @brief Called once per entry, returns true to stop the enumeration
+     */
+    using object_directory_visitor_t = std::function< bool( const object_directory_entry_t &entry ) >;
+
+    /**
+     * @brief Enumerator over a directory of named objects
+     *
+     * Implementations:
+     * - nt_object_directory_source_t: NtQueryDirectoryObject on \BaseNamedObjects, Windows only
+     * - shm_directory_source_t: getdents64 over /dev/shm (or any directory), Linux only
+     *
+     * Both fetch as many entries per system call as fit in a reusable buffer that is kept
+     * between enumerations, so query_count() measures how well the batching works.
+     */
+    class object_directory_source_t {
+    public:
+        virtual ~object_directory_source_t( ) = default;
+
+        /**
+         * @brief Visit every entry of the directory
+         * @param visitor Called for each entry until it returns true
+         * @return 0 on success (also when the visitor stopped early), NTSTATUS / errno style error code otherwise
+         */
+        virtual int enumerate( const object_directory_visitor_t &visitor ) = 0;
+
+        /**
+         * @brief Directory queries issued by the last enumerate()
+         */
+        uint32_t query_count( ) const { return m_query_count; }
+
+    protected:
+        uint32_t m_query_count = { }; ///< Queries issued by the last enumerate()
+    };
+
+    /**
+     * @brief Case-insensitive (ASCII) comparison of an entry name with a narrow name
+     * @param entry Entry passed to a visitor
+     * @param name Name to compare with
+     * @param length Length of name in characters
+     * @return true if both names are equal ignoring ASCII case
+     */
+    bool object_directory_name_equals( const object_directory_entry_t &entry, const char *name, size_t length );
+
+    /**
+     * @brief Search a directory for an entry by name
+     * @param source Directory to enumerate
+     * @param name Null terminated name, compared ignoring ASCII case
+     * @param found Receives whether the entry exists
+     * @return 0 on success, or the error returned by source->enumerate()
+     */
+    int find_object_directory_entry( object_directory_source_t *source, const char *name, bool *found );
+} // namespace vac::modules::process_informer
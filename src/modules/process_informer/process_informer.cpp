@@ -1,9 +1,25 @@
 #include "process_informer.hpp"
+#include "../../utils/vac_instrumentation.hpp"
+#include "../../utils/vac_obfuscated_string.hpp"
 #include "../../utils/vac_string_utils.hpp"
+#include "nt_object_directory_source.hpp"
+#include "process_section_reader.hpp"
 #include <winternl.h>
 
+#include <mutex>
+
 namespace vac::modules::process_informer {
+    namespace {
+        std::mutex               g_section_reader_mutex; ///< Serialises g_section_reader
+        process_section_reader_t g_section_reader;       ///< Mapping kept open across calls
+
+        std::mutex                   g_directory_source_mutex; ///< Serialises g_directory_source
+        nt_object_directory_source_t g_directory_source;       ///< \BaseNamedObjects, query buffer kept between searches
+    } // namespace
+
     int __cdecl read_process_information_section( unsigned __int8 *input_data, uint32_t *output_buffer, uint32_t *buffer_size ) {
+        VAC_TRACE_FUNCTION( );
+
         uint32_t error_code;
 
         // Clear output buffer
@@ -13,141 +29,82 @@ namespace vac::modules::process_informer {
         // Set magic signature
         output_buffer[ 4 ] = common::PROCESS_INFO_SECTION_MAGIC;
 
-        // Obfuscated strings - XOR with 0x13 to get real names
-        char obfuscated_kernel32[] = "xva}v"; // "kernel32" after XOR 0x13
-
-        // Deobfuscate library name
-        for ( char *p = obfuscated_kernel32; *p; ++p ) {
-            *p ^= 0x13;
-        }
-
-        // Load kernel32.dll
-        const HMODULE kernel32_handle = GetModuleHandleA( obfuscated_kernel32 );
+        // Load kernel32.dll, name decoded once per process
+        const HMODULE kernel32_handle = GetModuleHandleA( VAC_OBFUSCATED_STRING( "kernel32", VAC_PROCESS_INFORMER_STRING_KEY ) );
         if ( !kernel32_handle ) {
             error_code = GetLastError( );
             goto cleanup;
         }
 
-        // Build section GUID from input data
-        WCHAR section_guid[ 48 ];
-        wsprintfW( section_guid, L"{%02xDEDF05-86E9-%02x17-9E36-1D94%02x334DFA-A3%02x4421}", input_data[ 96 ], input_data[ 99 ],
-                   input_data[ 98 ], input_data[ 97 ] );
+        {
+            // The section stays mapped between calls, steady-state reads only touch the header
+            const std::lock_guard< std::mutex > lock( g_section_reader_mutex );
 
-        // Try to open the shared memory section
-        HANDLE section_handle = OpenFileMappingW( FILE_MAP_READ, FALSE, section_guid );
+            uint32_t                      system_error = 0;
+            common::informer_error_code_t result       = g_section_reader.open( &input_data[ 96 ], &system_error );
 
-        if ( !section_handle ) {
-            const DWORD last_error = GetLastError( );
+            if ( result == common::informer_error_code_t::success )
+                result = g_section_reader.poll( );
 
-            if ( last_error != ERROR_FILE_NOT_FOUND ) {
-                output_buffer[ 12 ] = static_cast< uint32_t >( common::informer_error_code_t::section_access_failed );
-                error_code          = last_error;
+            if ( result != common::informer_error_code_t::success ) {
+                output_buffer[ 12 ] = static_cast< uint32_t >( result );
+                error_code          = system_error ? system_error : static_cast< uint32_t >( result );
                 goto cleanup;
             }
 
-            // Fallback: Try directory object enumeration
-            section_handle = query_directory_object_for_section( section_guid );
-            if ( !section_handle ) {
-                output_buffer[ 12 ] = static_cast< uint32_t >( common::informer_error_code_t::directory_enum_failed );
-                error_code          = static_cast< uint32_t >( common::informer_error_code_t::directory_enum_failed );
-                goto cleanup;
-            }
-        }
-
-        // Map the section into memory
-        LPVOID mapped_section = MapViewOfFile( section_handle, FILE_MAP_READ, 0, 0, 0 );
-
-        if ( mapped_section ) {
             // Copy process information data (4072 bytes starting at offset 0x18)
             utils::copy_memory_vac( reinterpret_cast< unsigned char * >( output_buffer + 6 ),
-                                    reinterpret_cast< intptr_t >( mapped_section ) + 0x18, 4072 );
-
-            // Copy metadata from input
-            output_buffer[ 9 ]  = reinterpret_cast< uint32_t * >( input_data )[ 24 ];
-            output_buffer[ 10 ] = reinterpret_cast< uint32_t * >( input_data )[ 24 ];
-
-            UnmapViewOfFile( mapped_section );
-            error_code = 0; // Success
-        } else {
-            error_code          = GetLastError( );
-            output_buffer[ 12 ] = static_cast< uint32_t >( common::informer_error_code_t::section_mapping_failed );
+                                    reinterpret_cast< intptr_t >( g_section_reader.snapshot( ).m_process_data ), 4072 );
         }
 
-        CloseHandle( section_handle );
+        // Copy metadata from input
+        output_buffer[ 9 ]  = reinterpret_cast< uint32_t * >( input_data )[ 24 ];
+        output_buffer[ 10 ] = reinterpret_cast< uint32_t * >( input_data )[ 24 ];
+        error_code          = 0; // Success
 
     cleanup:
         output_buffer[ 5 ] = error_code;
         return 0;
     }
 
-    HANDLE __fastcall query_directory_object_for_section( const WCHAR *section_name ) {
-        typedef NTSTATUS( NTAPI * NtOpenDirectoryObject_t )( PHANDLE, ACCESS_MASK, POBJECT_ATTRIBUTES );
-        typedef NTSTATUS( NTAPI * NtQueryDirectoryObject_t )( HANDLE, PVOID, ULONG, BOOLEAN, BOOLEAN, PULONG, PULONG );
+    common::informer_error_code_t acquire_process_information_view( const unsigned __int8 *input_data, process_section_view_t *view,
+                                                                    uint32_t *system_error ) {
+        VAC_TRACE_FUNCTION( );
 
-        const HMODULE                 ntdll = GetModuleHandleA( "ntdll.dll" );
-        const NtOpenDirectoryObject_t NtOpenDirectory
-            = reinterpret_cast< NtOpenDirectoryObject_t >( GetProcAddress( ntdll, "NtOpenDirectoryObject" ) );
-        const NtQueryDirectoryObject_t NtQueryDirectory
-            = reinterpret_cast< NtQueryDirectoryObject_t >( GetProcAddress( ntdll, "NtQueryDirectoryObject" ) );
+        const std::lock_guard< std::mutex > lock( g_section_reader_mutex );
 
-        if ( !NtOpenDirectory || !NtQueryDirectory ) {
-            return nullptr;
-        }
+        uint32_t                      open_error = 0;
+        common::informer_error_code_t result     = g_section_reader.open( &input_data[ 96 ], &open_error );
 
-        HANDLE            directory_handle = nullptr;
-        OBJECT_ATTRIBUTES obj_attrs        = { };
-        obj_attrs.Length                   = sizeof( OBJECT_ATTRIBUTES );
-        obj_attrs.Attributes               = OBJ_CASE_INSENSITIVE;
+        if ( system_error )
+            *system_error = open_error;
 
-        NTSTATUS status = NtOpenDirectory( &directory_handle, 0x0003, &obj_attrs ); // DIRECTORY_QUERY | DIRECTORY_TRAVERSE
-        if ( !NT_SUCCESS( status ) ) {
-            return nullptr;
-        }
+        if ( result == common::informer_error_code_t::success )
+            result = g_section_reader.view( view );
 
-        // Allocate buffer for directory enumeration
-        ULONG  buffer_size = 1024;
-        PVOID  buffer      = HeapAlloc( GetProcessHeap( ), 0, buffer_size );
-        ULONG  context     = 0;
-        ULONG  return_length;
-        HANDLE found_section = nullptr;
-
-        while ( buffer ) {
-            status = NtQueryDirectory( directory_handle, buffer, buffer_size, TRUE, FALSE, &context, &return_length );
-
-            if ( status == 0xC0000023 ) {
-                HeapFree( GetProcessHeap( ), 0, buffer );
-                buffer_size += 1024;
-                buffer       = HeapAlloc( GetProcessHeap( ), 0, buffer_size );
-                continue;
-            }
-
-            if ( !NT_SUCCESS( status ) ) {
-                break;
-            }
-
-            typedef struct _OBJECT_DIRECTORY_INFORMATION {
-                UNICODE_STRING Name;
-                UNICODE_STRING TypeName;
-            } *POBJECT_DIRECTORY_INFORMATION;
+        return result;
+    }
 
-            // Parse directory entry and check if it matches our section name
-            const POBJECT_DIRECTORY_INFORMATION dir_info = static_cast< POBJECT_DIRECTORY_INFORMATION >( buffer );
+    HANDLE __fastcall query_directory_object_for_section( const WCHAR *section_name ) {
+        VAC_TRACE_FUNCTION( );
 
-            if ( dir_info->Name.Buffer && lstrcmpiW( dir_info->Name.Buffer, section_name ) == 0 ) {
-                // Found the section - try to open it
-                found_section = OpenFileMappingW( FILE_MAP_READ, FALSE, section_name );
-                break;
-            }
-        }
+        // Section names are GUIDs, plain ASCII
+        char   narrow_name[ 64 ];
+        size_t index = 0;
+        for ( ; section_name[ index ] && index < sizeof( narrow_name ) - 1; ++index )
+            narrow_name[ index ] = static_cast< char >( section_name[ index ] );
 
-        if ( buffer ) {
-            HeapFree( GetProcessHeap( ), 0, buffer );
-        }
+        narrow_name[ index ] = 0;
 
-        if ( directory_handle ) {
-            CloseHandle( directory_handle );
+        bool found = false;
+        {
+            const std::lock_guard< std::mutex > lock( g_directory_source_mutex );
+            if ( find_object_directory_entry( &g_directory_source, narrow_name, &found ) || !found )
+                return nullptr;
         }
 
-        return found_section;
+        // Found the section - try to open it
+        VAC_COUNT_SYSCALL( );
+        return OpenFileMappingW( FILE_MAP_READ, FALSE, section_name );
     }
 } // namespace vac::modules::process_informer
\ No newline at end of file
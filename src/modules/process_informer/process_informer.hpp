@@ -1,6 +1,14 @@
 #pragma once
 #include "../../common/types.hpp"
 #include "../../utils/vac_string_utils.hpp"
+#include "process_section_view.hpp"
+
+/**
+ * @brief Key byte for the module's obfuscated strings, override per build with -DVAC_PROCESS_INFORMER_STRING_KEY=...
+ */
+#ifndef VAC_PROCESS_INFORMER_STRING_KEY
+#define VAC_PROCESS_INFORMER_STRING_KEY 0x13
+#endif
 
 namespace vac::modules::process_informer {
     /**
@@ -14,6 +22,14 @@ namespace vac::modules::process_informer {
      *
      * Error 0x1D2 (466) indicates the section doesn't exist - likely disabled on modern Windows.
      *
+     * Compatibility wrapper that copies the whole payload for callers that expect the output
+     * buffer layout; consumers that only need the header or a few records should use
+     * acquire_process_information_view() instead. The section is mapped on the first call and
+     * kept mapped through a process_section_reader_t; later calls only re-copy the payload when
+     * the producer updated it, and every new copy is verified against the section's CRC32C.
+     * Error 496 means no consistent copy could be taken while the producer was writing, 497
+     * that the payload did not match m_checksum.
+     *
      * @param input_data Input context data containing GUID bytes at offsets 96-99
      * @param output_buffer Output buffer (4096 bytes)
      * @param buffer_size Buffer size pointer (set to 4096)
@@ -22,19 +38,29 @@ namespace vac::modules::process_informer {
     int __cdecl read_process_information_section( unsigned __int8 *input_data, uint32_t *output_buffer, uint32_t *buffer_size );
 
     /**
-     * @brief Query directory object recursively
+     * @brief Zero-copy view of the process information section
      *
-     * This function performs recursive directory object enumeration to locate
-     * the process information section when direct access fails. Uses progressive
-     * buffer allocation to handle varying directory sizes.
+     * Opens (or reuses) the same mapping as read_process_information_section() and returns a
+     * read-only view into it. The view keeps the section mapped for as long as it is held; see
+     * process_section_view_t for the consistency check after reading records.
+     *
+     * @param input_data Input context data containing GUID bytes at offsets 96-99
+     * @param view Receives the view
+     * @param system_error Optional, receives the GetLastError() value of a failed open
+     * @return informer_error_code_t value, success if view is valid
+     */
+    common::informer_error_code_t acquire_process_information_view( const unsigned __int8 *input_data, process_section_view_t *view,
+                                                                    uint32_t *system_error = nullptr );
+
+    /**
+     * @brief Locate the section by enumerating \BaseNamedObjects
      *
-     * Implementation details:
-     * - Opens directory object with DIRECTORY_QUERY | DIRECTORY_TRAVERSE access
-     * - Uses NtQueryDirectoryObject with single entry enumeration
-     * - Progressively expands buffer size on STATUS_BUFFER_TOO_SMALL
-     * - Performs case-insensitive string comparison for object names
-     * - Returns handle to located section object
+     * Fallback for when OpenFileMappingW reports ERROR_FILE_NOT_FOUND. Searches the
+     * directory through nt_object_directory_source_t, which fetches entries in batches
+     * (ReturnSingleEntry = FALSE) into a buffer kept between calls, and compares every
+     * returned name case-insensitively. The section is opened by name once found.
      *
+     * @param section_name Section name to look for
      * @return Handle to section object, or NULL if not found
      */
     HANDLE __fastcall query_directory_object_for_section( const WCHAR *section_name );
@@ -0,0 +1,186 @@
+#include "process_section_load_test.hpp"
+
+#if defined( __linux__ )
+#include "../../utils/vac_clock_utils.hpp"
+#include "process_section_producer.hpp"
+#include "process_section_reader.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace vac::modules::process_informer {
+    namespace {
+        constexpr size_t   g_publish_time_slots = 4096;          ///< Publish timestamps kept, indexed by version; older ones are overwritten
+        constexpr uint64_t g_producer_spin_ns   = 50000;         ///< Below this the producer yields instead of sleeping
+        constexpr uint64_t g_nanoseconds        = 1000000000ull; ///< Per second
+
+        /**
+         * @brief Per-reader counters, merged into the report after the run
+         */
+        struct reader_totals_t {
+            uint64_t m_polls             = { }; ///< poll() calls
+            uint64_t m_copies            = { }; ///< Polls that copied a new version
+            uint64_t m_contended         = { }; ///< section_read_contended results
+            uint64_t m_checksum_failures = { }; ///< section_checksum_mismatch results
+            uint64_t m_samples           = { }; ///< Successful polls measured for staleness
+            uint64_t m_staleness_sum_ns  = { }; ///< Sum of staleness
+            uint64_t m_max_staleness_ns  = { }; ///< Worst staleness
+            uint64_t m_behind_sum        = { }; ///< Sum of versions behind
+            uint64_t m_max_behind        = { }; ///< Worst versions behind
+        };
+    } // namespace
+
+    int run_section_load_test( const section_load_test_config_t &config, section_load_test_report_t *report ) {
+        *report = { };
+
+        process_section_producer_t producer;
+        const int                  create_result = producer.create( config.m_guid_bytes );
+        if ( create_result )
+            return create_result;
+
+        const utils::clock_source_t          &clock = utils::precise_clock( );
+        std::vector< std::atomic< uint64_t > > publish_times( g_publish_time_slots );
+        std::atomic< uint32_t >                latest_version{ 0 };
+        std::atomic< bool >                    stopping{ false };
+
+        // create() already published the empty version 0
+        publish_times[ 0 ].store( clock.now_ns( ), std::memory_order_relaxed );
+
+        // Every reader maps the section by name, like separate consumer processes would
+        const uint32_t                                             reader_count = std::max< uint32_t >( config.m_reader_count, 1 );
+        std::vector< std::unique_ptr< process_section_reader_t > > readers;
+
+        for ( uint32_t reader_index = 0; reader_index < reader_count; ++reader_index ) {
+            auto     reader       = std::make_unique< process_section_reader_t >( );
+            uint32_t system_error = 0;
+
+            const common::informer_error_code_t open_result = reader->open( config.m_guid_bytes, &system_error );
+            if ( open_result != common::informer_error_code_t::success )
+                return static_cast< int >( open_result );
+
+            readers.push_back( std::move( reader ) );
+        }
+
+        std::vector< reader_totals_t > totals( reader_count );
+        std::vector< std::thread >     threads;
+
+        for ( uint32_t reader_index = 0; reader_index < reader_count; ++reader_index ) {
+            threads.emplace_back( [ &, reader_index ]( ) {
+                process_section_reader_t &reader = *readers[ reader_index ];
+                reader_totals_t          &total  = totals[ reader_index ];
+
+                while ( !stopping.load( std::memory_order_relaxed ) ) {
+                    bool                                changed = false;
+                    const common::informer_error_code_t result  = reader.poll( &changed );
+
+                    ++total.m_polls;
+
+                    if ( result == common::informer_error_code_t::section_read_contended ) {
+                        ++total.m_contended;
+                        continue;
+                    }
+
+                    if ( result == common::informer_error_code_t::section_checksum_mismatch ) {
+                        ++total.m_checksum_failures;
+                        continue;
+                    }
+
+                    total.m_copies += changed;
+
+                    // Stale since the next version was published; its slot is only overwritten
+                    // g_publish_time_slots versions later, so far behind readers are under-reported
+                    const uint32_t held      = reader.snapshot( ).m_last_update_time;
+                    const uint32_t latest    = latest_version.load( std::memory_order_acquire );
+                    const uint64_t behind    = latest > held ? latest - held : 0;
+                    uint64_t       staleness = 0;
+
+                    if ( behind ) {
+                        const uint64_t superseded_at = publish_times[ ( held + 1 ) % g_publish_time_slots ].load( std::memory_order_relaxed );
+                        const uint64_t now           = clock.now_ns( );
+                        staleness                    = now > superseded_at ? now - superseded_at : 0;
+                    }
+
+                    ++total.m_samples;
+                    total.m_staleness_sum_ns += staleness;
+                    total.m_max_staleness_ns  = std::max( total.m_max_staleness_ns, staleness );
+                    total.m_behind_sum       += behind;
+                    total.m_max_behind        = std::max( total.m_max_behind, behind );
+                }
+            } );
+        }
+
+        // Synthetic records, one of them changes with every update
+        std::vector< common::process_entry_t > entries( std::min< size_t >( config.m_record_count, g_section_record_capacity ) );
+        for ( size_t entry_index = 0; entry_index < entries.size( ); ++entry_index ) {
+            entries[ entry_index ].m_process_id        = static_cast< uint32_t >( 4 * ( entry_index + 1 ) );
+            entries[ entry_index ].m_parent_process_id = 4;
+        }
+
+        const uint64_t interval_ns = config.m_update_rate_hz ? g_nanoseconds / config.m_update_rate_hz : 0;
+        const uint64_t start_ns    = clock.now_ns( );
+        const uint64_t end_ns      = start_ns + static_cast< uint64_t >( config.m_duration_ms ) * 1000000ull;
+        uint64_t       next_ns     = start_ns;
+        uint32_t       version     = 0;
+
+        for ( uint64_t now_ns = start_ns; now_ns < end_ns; now_ns = clock.now_ns( ) ) {
+            if ( now_ns < next_ns ) {
+                const uint64_t wait_ns = std::min( next_ns, end_ns ) - now_ns;
+                if ( wait_ns > g_producer_spin_ns )
+                    std::this_thread::sleep_for( std::chrono::nanoseconds( wait_ns - g_producer_spin_ns ) );
+                else
+                    std::this_thread::yield( );
+
+                continue;
+            }
+
+            ++version;
+            if ( !entries.empty( ) )
+                entries[ version % entries.size( ) ].m_creation_time_low = version;
+
+            // Stamped before publishing so a reader never holds a version without a time
+            publish_times[ version % g_publish_time_slots ].store( clock.now_ns( ), std::memory_order_relaxed );
+            producer.publish( entries.data( ), entries.size( ), version );
+            latest_version.store( version, std::memory_order_release );
+
+            next_ns += interval_ns;
+        }
+
+        stopping.store( true, std::memory_order_relaxed );
+        for ( std::thread &thread : threads )
+            thread.join( );
+
+        const uint64_t elapsed_ns = clock.now_ns( ) - start_ns;
+        uint64_t       samples    = 0;
+
+        report->m_published = producer.published( ) - 1;
+
+        for ( const reader_totals_t &total : totals ) {
+            report->m_polls               += total.m_polls;
+            report->m_copies              += total.m_copies;
+            report->m_contended           += total.m_contended;
+            report->m_checksum_failures   += total.m_checksum_failures;
+            report->m_max_staleness_ns     = std::max( report->m_max_staleness_ns, total.m_max_staleness_ns );
+            report->m_max_versions_behind  = std::max( report->m_max_versions_behind, total.m_max_behind );
+
+            report->m_mean_staleness_ns    += static_cast< double >( total.m_staleness_sum_ns );
+            report->m_mean_versions_behind += static_cast< double >( total.m_behind_sum );
+            samples                        += total.m_samples;
+        }
+
+        if ( samples ) {
+            report->m_mean_staleness_ns    /= static_cast< double >( samples );
+            report->m_mean_versions_behind /= static_cast< double >( samples );
+        }
+
+        if ( elapsed_ns )
+            report->m_polls_per_second
+                = static_cast< double >( report->m_polls ) * static_cast< double >( g_nanoseconds ) / static_cast< double >( elapsed_ns );
+
+        return 0;
+    }
+} // namespace vac::modules::process_informer
+#endif
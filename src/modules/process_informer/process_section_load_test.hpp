@@ -0,0 +1,54 @@
+#pragma once
+
+#include "../../common/types.hpp"
+
+#if defined( __linux__ )
+#include <cstdint>
+
+namespace vac::modules::process_informer {
+    /**
+     * @brief Parameters of run_section_load_test()
+     */
+    struct section_load_test_config_t {
+        uint8_t  m_guid_bytes[ 4 ] = { 0x5A, 0x01, 0x02, 0x03 }; ///< Names the shared memory object like input_data[ 96 .. 99 ]
+        uint32_t m_update_rate_hz  = 1000;                       ///< Producer updates per second, 0 for as fast as possible
+        uint32_t m_duration_ms     = 1000;                       ///< Length of the run
+        uint32_t m_reader_count    = 1;                          ///< Concurrent reader threads, each with its own mapping
+        uint32_t m_record_count    = 64;                         ///< Records per update, capped at g_section_record_capacity
+    };
+
+    /**
+     * @brief Results of run_section_load_test(), summed over all readers
+     *
+     * Staleness is measured per successful poll: it is the time since the producer published
+     * the first version newer than the one the reader now holds, 0 if the reader holds the
+     * latest, so it does not grow with the publish interval. Versions behind is how many newer
+     * updates had already been published at that point.
+     */
+    struct section_load_test_report_t {
+        uint64_t m_published            = { }; ///< Updates written by the producer
+        uint64_t m_polls                = { }; ///< poll() calls
+        uint64_t m_copies               = { }; ///< Polls that copied a new version
+        uint64_t m_contended            = { }; ///< Polls that returned section_read_contended
+        uint64_t m_checksum_failures    = { }; ///< Polls that returned section_checksum_mismatch
+        double   m_polls_per_second     = { }; ///< Reader throughput, all readers together
+        double   m_mean_staleness_ns    = { }; ///< Mean time since the held version was superseded
+        uint64_t m_max_staleness_ns     = { }; ///< Worst time since the held version was superseded
+        double   m_mean_versions_behind = { }; ///< Mean number of newer versions already published
+        uint64_t m_max_versions_behind  = { }; ///< Worst number of newer versions already published
+    };
+
+    /**
+     * @brief Run a local producer and concurrent readers over a POSIX shared memory section
+     *
+     * Creates the section with process_section_producer_t, publishes updates at the configured
+     * rate from one thread, and has every reader thread open the section by name through
+     * process_section_reader_t and poll it in a tight loop until the run ends.
+     *
+     * @param config Run parameters
+     * @param report Receives the results
+     * @return 0 on success, errno of a failed create, or the informer error code of a failed reader open
+     */
+    int run_section_load_test( const section_load_test_config_t &config, section_load_test_report_t *report );
+} // namespace vac::modules::process_informer
+#endif
@@ -0,0 +1,97 @@
+#include "process_section_poll_benchmark.hpp"
+
+#if defined( __linux__ )
+#include "../../utils/vac_clock_utils.hpp"
+#include "process_section_producer.hpp"
+#include "process_section_reader.hpp"
+#include "process_section_view.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+namespace vac::modules::process_informer {
+    int run_section_poll_benchmark( const section_poll_benchmark_config_t &config, section_poll_benchmark_report_t *report ) {
+        *report = { };
+
+        process_section_producer_t producer;
+        const int                  create_result = producer.create( config.m_guid_bytes );
+        if ( create_result )
+            return create_result;
+
+        std::vector< common::process_entry_t > entries( std::min< size_t >( config.m_record_count, g_section_record_capacity ) );
+        for ( size_t entry_index = 0; entry_index < entries.size( ); ++entry_index ) {
+            entries[ entry_index ].m_process_id        = static_cast< uint32_t >( 4 * ( entry_index + 1 ) );
+            entries[ entry_index ].m_parent_process_id = 4;
+        }
+
+        const utils::clock_source_t &clock  = utils::precise_clock( );
+        const uint32_t               rounds = std::max< uint32_t >( config.m_rounds, 1 );
+        const uint32_t               reads  = std::max< uint32_t >( config.m_reads, 1 );
+
+        process_section_reader_t reader;
+        uint32_t                 system_error = 0;
+        uint32_t                 version      = 0;
+
+        uint64_t best_reopen_ns  = std::numeric_limits< uint64_t >::max( );
+        uint64_t best_steady_ns  = std::numeric_limits< uint64_t >::max( );
+        uint64_t best_changed_ns = std::numeric_limits< uint64_t >::max( );
+        uint64_t best_publish_ns = std::numeric_limits< uint64_t >::max( );
+
+        producer.publish( entries.data( ), entries.size( ), ++version );
+
+        for ( uint32_t round = 0; round < rounds; ++round ) {
+            common::informer_error_code_t result = common::informer_error_code_t::success;
+
+            // Every read pays for the name, the open, the mapping and a full copy
+            uint64_t started_at = clock.now_ns( );
+
+            for ( uint32_t read = 0; read < reads && result == common::informer_error_code_t::success; ++read ) {
+                reader.close( );
+                result = reader.open( config.m_guid_bytes, &system_error );
+                if ( result == common::informer_error_code_t::success )
+                    result = reader.poll( );
+            }
+
+            best_reopen_ns = std::min( best_reopen_ns, clock.now_ns( ) - started_at );
+
+            // Mapping kept, nothing published in between
+            started_at = clock.now_ns( );
+
+            for ( uint32_t read = 0; read < reads && result == common::informer_error_code_t::success; ++read )
+                result = reader.poll( );
+
+            best_steady_ns = std::min( best_steady_ns, clock.now_ns( ) - started_at );
+
+            // Mapping kept, a new version before every poll
+            started_at = clock.now_ns( );
+
+            for ( uint32_t read = 0; read < reads && result == common::informer_error_code_t::success; ++read ) {
+                entries[ read % std::max< size_t >( entries.size( ), 1 ) ].m_creation_time_low = ++version;
+                producer.publish( entries.data( ), entries.size( ), version );
+                result = reader.poll( );
+            }
+
+            best_changed_ns = std::min( best_changed_ns, clock.now_ns( ) - started_at );
+
+            // Publishing alone, taken out of the changed path
+            started_at = clock.now_ns( );
+
+            for ( uint32_t read = 0; read < reads; ++read ) {
+                entries[ read % std::max< size_t >( entries.size( ), 1 ) ].m_creation_time_low = ++version;
+                producer.publish( entries.data( ), entries.size( ), version );
+            }
+
+            best_publish_ns = std::min( best_publish_ns, clock.now_ns( ) - started_at );
+
+            if ( result != common::informer_error_code_t::success )
+                return static_cast< int >( result );
+        }
+
+        report->m_reopen_ns       = static_cast< double >( best_reopen_ns ) / reads;
+        report->m_steady_poll_ns  = static_cast< double >( best_steady_ns ) / reads;
+        report->m_changed_poll_ns = static_cast< double >( best_changed_ns > best_publish_ns ? best_changed_ns - best_publish_ns : 0 ) / reads;
+        return 0;
+    }
+} // namespace vac::modules::process_informer
+#endif
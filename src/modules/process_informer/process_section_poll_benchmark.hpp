@@ -0,0 +1,42 @@
+#pragma once
+
+#include "../../common/types.hpp"
+
+#if defined( __linux__ )
+#include <cstdint>
+
+namespace vac::modules::process_informer {
+    /**
+     * @brief Parameters of run_section_poll_benchmark()
+     */
+    struct section_poll_benchmark_config_t {
+        uint8_t  m_guid_bytes[ 4 ] = { 0x5A, 0x04, 0x04, 0x04 }; ///< Names the shared memory object like input_data[ 96 .. 99 ]
+        uint32_t m_record_count    = 64;                         ///< Records per update, capped at g_section_record_capacity
+        uint32_t m_rounds          = 5;                          ///< Timed rounds per path, the fastest is reported
+        uint32_t m_reads           = 20000;                      ///< Reads per round
+    };
+
+    /**
+     * @brief Results of run_section_poll_benchmark(), nanoseconds per read
+     */
+    struct section_poll_benchmark_report_t {
+        double m_reopen_ns       = { }; ///< Open, map, copy and unmap on every read, like VAC's read_process_information_section
+        double m_steady_poll_ns  = { }; ///< poll() of a kept mapping while the section is unchanged
+        double m_changed_poll_ns = { }; ///< poll() of a kept mapping after every update, copy and checksum included
+    };
+
+    /**
+     * @brief Compare the long-lived reader with opening the section for every read
+     *
+     * Creates the section with process_section_producer_t and reads it on the calling
+     * thread through process_section_reader_t three ways: closed and reopened around every
+     * poll(), polled while nothing changes, and polled right after each publish (the
+     * publish itself is timed separately and subtracted).
+     *
+     * @param config Section and run length
+     * @param report Receives the per-read costs
+     * @return 0 on success, errno of a failed create, or the informer error code of a failed read
+     */
+    int run_section_poll_benchmark( const section_poll_benchmark_config_t &config, section_poll_benchmark_report_t *report );
+} // namespace vac::modules::process_informer
+#endif
@@ -0,0 +1,112 @@
+#include "process_section_producer.hpp"
+#include "../../utils/vac_crc32c_utils.hpp"
+#include "../../utils/vac_instrumentation.hpp"
+#include "process_section_reader.hpp"
+#include "process_section_view.hpp"
+
+#if defined( __linux__ )
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+namespace vac::modules::process_informer {
+    process_section_producer_t::~process_section_producer_t( ) { close( ); }
+
+#if defined( __linux__ )
+    int process_section_producer_t::create( const uint8_t *guid_bytes ) {
+        close( );
+
+        m_name[ 0 ] = '/';
+        format_section_name( guid_bytes, m_name + 1 );
+
+        VAC_COUNT_SYSCALL( );
+        const int section_fd = shm_open( m_name, O_RDWR | O_CREAT | O_CLOEXEC, 0600 );
+        if ( section_fd < 0 )
+            return errno;
+
+        VAC_COUNT_SYSCALL( );
+        if ( ftruncate( section_fd, sizeof( common::process_info_section_t ) ) ) {
+            const int truncate_error = errno;
+            VAC_COUNT_SYSCALL( );
+            ::close( section_fd );
+            VAC_COUNT_SYSCALL( );
+            shm_unlink( m_name );
+            return truncate_error;
+        }
+
+        VAC_COUNT_SYSCALL( );
+        void     *mapped_section = mmap( nullptr, sizeof( common::process_info_section_t ), PROT_READ | PROT_WRITE, MAP_SHARED, section_fd, 0 );
+        const int map_error      = errno;
+        VAC_COUNT_SYSCALL( );
+        ::close( section_fd );
+
+        if ( mapped_section == MAP_FAILED ) {
+            VAC_COUNT_SYSCALL( );
+            shm_unlink( m_name );
+            return map_error;
+        }
+
+        m_section = static_cast< common::process_info_section_t * >( mapped_section );
+        m_owned   = true;
+
+        // Fresh objects are zero filled; restart the counter on a reused one
+        m_section->m_reserved = 0;
+        publish( nullptr, 0, 0 );
+        return 0;
+    }
+#endif
+
+    void process_section_producer_t::attach( void *section ) {
+        close( );
+        m_section = static_cast< common::process_info_section_t * >( section );
+    }
+
+    void process_section_producer_t::close( ) {
+#if defined( __linux__ )
+        if ( m_owned ) {
+            VAC_COUNT_SYSCALL( );
+            munmap( m_section, sizeof( common::process_info_section_t ) );
+            VAC_COUNT_SYSCALL( );
+            shm_unlink( m_name );
+        }
+#endif
+
+        m_section   = nullptr;
+        m_owned     = false;
+        m_name[ 0 ] = 0;
+        m_published = 0;
+    }
+
+    void process_section_producer_t::publish( const common::process_entry_t *entries, size_t entry_count, const uint32_t update_time ) {
+        volatile uint32_t *sequence = &m_section->m_reserved;
+
+        entry_count = std::min( entry_count, g_section_record_capacity );
+
+        // Odd: readers drop anything they copy until the counter is even again
+        *sequence = *sequence + 1;
+        std::atomic_thread_fence( std::memory_order_release );
+
+        const size_t record_bytes = entry_count * sizeof( common::process_entry_t );
+        uint32_t     checksum     = utils::copy_memory_crc32c( m_section->m_process_data, entries, record_bytes );
+
+        memset( m_section->m_process_data + record_bytes, 0, g_section_payload_size - record_bytes );
+        checksum = utils::crc32c( m_section->m_process_data + record_bytes, g_section_payload_size - record_bytes, checksum );
+
+        m_section->m_magic_signature  = common::PROCESS_INFO_SECTION_MAGIC;
+        m_section->m_section_size     = sizeof( common::process_info_section_t );
+        m_section->m_process_count    = static_cast< uint32_t >( entry_count );
+        m_section->m_last_update_time = update_time;
+        m_section->m_checksum         = checksum;
+
+        std::atomic_thread_fence( std::memory_order_release );
+        *sequence = *sequence + 1;
+
+        ++m_published;
+    }
+} // namespace vac::modules::process_informer
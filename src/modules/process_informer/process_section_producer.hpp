@@ -0,0 +1,69 @@
+#pragma once
+
+#include "../../common/types.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace vac::modules::process_informer {
+    /**
+     * @brief Writer side of the process information section protocol
+     *
+     * publish() follows the protocol process_section_reader_t expects: m_reserved (+20) is
+     * made odd, the header and payload are written, m_checksum (+4096) receives the CRC32C
+     * of m_process_data, and m_reserved is made even again.
+     *
+     * create() backs the section with a POSIX shared memory object named like the Windows
+     * section (Linux only); attach() writes into memory the caller owns. Intended for load
+     * tests and local runs, there is a single writer per section.
+     */
+    class process_section_producer_t {
+    public:
+        process_section_producer_t( ) = default;
+        ~process_section_producer_t( );
+
+        process_section_producer_t( const process_section_producer_t & )            = delete;
+        process_section_producer_t &operator=( const process_section_producer_t & ) = delete;
+
+#if defined( __linux__ )
+        /**
+         * @brief Create (or truncate) the shared memory object for the four GUID bytes and map it writable
+         * @param guid_bytes input_data[ 96 .. 99 ] of the module input
+         * @return 0 on success, errno otherwise
+         */
+        int create( const uint8_t *guid_bytes );
+#endif
+
+        /**
+         * @brief Publish into caller-owned memory
+         * @param section Writable section, at least sizeof( process_info_section_t ) bytes
+         */
+        void attach( void *section );
+
+        /**
+         * @brief Unmap and unlink a created section, detach an attached one
+         */
+        void close( );
+
+        bool is_open( ) const { return m_section != nullptr; }
+
+        /**
+         * @brief Write one update
+         * @param entries Records to publish, only the first g_section_record_capacity are written
+         * @param entry_count Number of records in entries
+         * @param update_time Value stored in m_last_update_time
+         */
+        void publish( const common::process_entry_t *entries, size_t entry_count, uint32_t update_time );
+
+        /**
+         * @brief Updates published since the section was opened, including the empty one create() writes
+         */
+        uint64_t published( ) const { return m_published; }
+
+    private:
+        common::process_info_section_t *m_section    = { }; ///< Mapped or attached section
+        bool                            m_owned      = { }; ///< Created by create(), unmapped and unlinked by close()
+        char                            m_name[ 64 ] = { }; ///< shm_open name of a created section
+        uint64_t                        m_published  = { }; ///< Completed publish() calls
+    };
+} // namespace vac::modules::process_informer
@@ -0,0 +1,336 @@
+#include "process_section_reader.hpp"
+#include "../../utils/vac_clock_utils.hpp"
+#include "../../utils/vac_crc32c_utils.hpp"
+#include "../../utils/vac_instrumentation.hpp"
+
+#if defined( _WIN32 )
+#include "process_informer.hpp"
+#elif defined( __linux__ )
+#include "shm_directory_source.hpp"
+
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <atomic>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+namespace vac::modules::process_informer {
+    namespace {
+        constexpr size_t g_sequence_offset = offsetof( common::process_info_section_t, m_reserved );
+        constexpr size_t g_copied_size     = offsetof( common::process_info_section_t, m_checksum ); ///< Header and payload
+
+        uint32_t load_header_word( const section_mapping_t &mapping, const size_t offset ) {
+            return *reinterpret_cast< const volatile uint32_t * >( mapping.data( ) + offset );
+        }
+    } // namespace
+
+    void format_section_name( const uint8_t *guid_bytes, char *name ) {
+        snprintf( name, g_section_name_size, "{%02xDEDF05-86E9-%02x17-9E36-1D94%02x334DFA-A3%02x4421}", guid_bytes[ 0 ], guid_bytes[ 3 ],
+                  guid_bytes[ 2 ], guid_bytes[ 1 ] );
+    }
+
+    process_section_reader_t::~process_section_reader_t( ) { close( ); }
+
+    common::informer_error_code_t process_section_reader_t::open( const uint8_t *guid_bytes, uint32_t *system_error ) {
+        VAC_TRACE_SCOPE( "process_section_reader_t::open" );
+
+        *system_error = 0;
+
+        if ( m_mapping && !memcmp( m_guid_bytes, guid_bytes, sizeof( m_guid_bytes ) ) && !is_stale( ) )
+            return common::informer_error_code_t::success;
+
+        close( );
+
+#if defined( _WIN32 )
+        // Build section GUID from input data
+        WCHAR section_guid[ 48 ];
+        wsprintfW( section_guid, L"{%02xDEDF05-86E9-%02x17-9E36-1D94%02x334DFA-A3%02x4421}", guid_bytes[ 0 ], guid_bytes[ 3 ], guid_bytes[ 2 ],
+                   guid_bytes[ 1 ] );
+
+        // Try to open the shared memory section
+        VAC_COUNT_SYSCALL( );
+        HANDLE section_handle = OpenFileMappingW( FILE_MAP_READ, FALSE, section_guid );
+
+        if ( !section_handle ) {
+            const DWORD last_error = GetLastError( );
+
+            if ( last_error != ERROR_FILE_NOT_FOUND ) {
+                *system_error = last_error;
+                return common::informer_error_code_t::section_access_failed;
+            }
+
+            // Fallback: Try directory object enumeration
+            section_handle = query_directory_object_for_section( section_guid );
+            if ( !section_handle ) {
+                *system_error = static_cast< uint32_t >( common::informer_error_code_t::directory_enum_failed );
+                return common::informer_error_code_t::directory_enum_failed;
+            }
+        }
+
+        // Map the section once, it stays mapped until close() and the last view are done with it
+        VAC_COUNT_SYSCALL( );
+        const LPVOID mapped_section = MapViewOfFile( section_handle, FILE_MAP_READ, 0, 0, 0 );
+        if ( !mapped_section ) {
+            *system_error = GetLastError( );
+            VAC_COUNT_SYSCALL( );
+            CloseHandle( section_handle );
+            return common::informer_error_code_t::section_mapping_failed;
+        }
+
+        // Views are at least a page, so the header and payload are always covered
+        MEMORY_BASIC_INFORMATION region = { };
+        VAC_COUNT_SYSCALL( );
+        const size_t             mapped_size
+            = VirtualQuery( mapped_section, &region, sizeof( region ) ) ? static_cast< size_t >( region.RegionSize ) : g_copied_size;
+
+        m_mapping = std::make_shared< const section_mapping_t >( mapped_section, mapped_size, section_handle, true );
+        memcpy( m_guid_bytes, guid_bytes, sizeof( m_guid_bytes ) );
+        return common::informer_error_code_t::success;
+#elif defined( __linux__ )
+        // Same name as the Windows section, as a POSIX shared memory object
+        char section_name[ 1 + g_section_name_size ] = { '/' };
+        format_section_name( guid_bytes, section_name + 1 );
+
+        VAC_COUNT_SYSCALL( );
+        int section_fd = shm_open( section_name, O_RDONLY | O_CLOEXEC, 0 );
+
+        if ( section_fd < 0 ) {
+            if ( errno != ENOENT ) {
+                *system_error = static_cast< uint32_t >( errno );
+                return common::informer_error_code_t::section_access_failed;
+            }
+
+            // Fallback: section names are case-insensitive on Windows, look for another casing in /dev/shm
+            shm_directory_source_t directory;
+            bool                   found = false;
+
+            directory.enumerate( [ & ]( const object_directory_entry_t &entry ) {
+                if ( !object_directory_name_equals( entry, section_name + 1, g_section_name_size - 1 ) )
+                    return false;
+
+                memcpy( section_name + 1, entry.m_name, entry.m_name_length );
+                found = true;
+                return true;
+            } );
+
+            if ( found ) {
+                VAC_COUNT_SYSCALL( );
+                section_fd = shm_open( section_name, O_RDONLY | O_CLOEXEC, 0 );
+            }
+
+            if ( section_fd < 0 ) {
+                *system_error = static_cast< uint32_t >( common::informer_error_code_t::directory_enum_failed );
+                return common::informer_error_code_t::directory_enum_failed;
+            }
+        }
+
+        // Unlike a Windows view the mapping ends at the object size and reading past it faults
+        VAC_COUNT_SYSCALL( );
+        struct stat section_status = { };
+        const int   stat_result    = fstat( section_fd, &section_status );
+
+        if ( stat_result || static_cast< size_t >( section_status.st_size ) < g_copied_size ) {
+            *system_error = static_cast< uint32_t >( stat_result ? errno : EINVAL );
+            VAC_COUNT_SYSCALL( );
+            ::close( section_fd );
+            return common::informer_error_code_t::section_mapping_failed;
+        }
+
+        const size_t mapped_size = static_cast< size_t >( section_status.st_size );
+        VAC_COUNT_SYSCALL( );
+        void     *mapped_section = mmap( nullptr, mapped_size, PROT_READ, MAP_SHARED, section_fd, 0 );
+        const int map_error      = errno;
+        VAC_COUNT_SYSCALL( );
+        ::close( section_fd );
+
+        if ( mapped_section == MAP_FAILED ) {
+            *system_error = static_cast< uint32_t >( map_error );
+            return common::informer_error_code_t::section_mapping_failed;
+        }
+
+        m_mapping = std::make_shared< const section_mapping_t >( mapped_section, mapped_size, nullptr, true );
+        memcpy( m_guid_bytes, guid_bytes, sizeof( m_guid_bytes ) );
+        return common::informer_error_code_t::success;
+#endif
+    }
+
+    void process_section_reader_t::attach( const void *view, const size_t size ) {
+        close( );
+        m_mapping = std::make_shared< const section_mapping_t >( view, size, nullptr, false );
+    }
+
+    void process_section_reader_t::close( ) {
+        m_mapping.reset( );
+        m_has_snapshot   = false;
+        m_seen_change_ns = 0;
+        m_seen_valid     = false;
+        m_counter_stuck  = false;
+        memset( m_guid_bytes, 0, sizeof( m_guid_bytes ) );
+    }
+
+    bool process_section_reader_t::is_stale( ) {
+        const section_mapping_t &mapping          = *m_mapping;
+        const uint32_t           magic_signature  = load_header_word( mapping, offsetof( common::process_info_section_t, m_magic_signature ) );
+        const uint32_t           section_size     = load_header_word( mapping, offsetof( common::process_info_section_t, m_section_size ) );
+        const uint32_t           sequence         = load_header_word( mapping, g_sequence_offset );
+        const uint32_t           last_update_time = load_header_word( mapping, offsetof( common::process_info_section_t, m_last_update_time ) );
+        const uint64_t           now_ns           = utils::platform_clock( ).now_ns( );
+
+        // A header that validated once and no longer does belongs to a section being torn down
+        const bool valid = magic_signature == common::PROCESS_INFO_SECTION_MAGIC && section_size >= g_copied_size;
+        if ( m_seen_valid && !valid )
+            return true;
+
+        m_seen_valid = m_seen_valid || valid;
+
+        if ( !m_seen_change_ns || sequence != m_seen_sequence || last_update_time != m_seen_update_time ) {
+            m_seen_sequence    = sequence;
+            m_seen_update_time = last_update_time;
+            m_seen_change_ns   = now_ns;
+            return false;
+        }
+
+        // A producer that recreated the section left this view orphaned and frozen; remapping an idle one is cheap
+        return now_ns - m_seen_change_ns >= g_section_stale_ms * 1000000ULL;
+    }
+
+    bool process_section_reader_t::try_view( process_section_view_t *view ) const {
+        // Odd: the producer is in the middle of an update
+        const uint32_t sequence = load_header_word( *m_mapping, g_sequence_offset );
+        if ( sequence & 1 )
+            return false;
+
+        std::atomic_thread_fence( std::memory_order_acquire );
+        *view = process_section_view_t( m_mapping, sequence );
+        return true;
+    }
+
+    common::informer_error_code_t process_section_reader_t::view( process_section_view_t *view ) const {
+        if ( !m_mapping )
+            return common::informer_error_code_t::section_mapping_failed;
+
+        const uint32_t first_sequence = load_header_word( *m_mapping, g_sequence_offset );
+        const bool     known_stuck    = m_counter_stuck && first_sequence == m_stuck_sequence;
+        bool           counter_stuck  = true;
+
+        for ( uint32_t attempt = 0; !known_stuck && attempt < g_section_read_attempts; ++attempt ) {
+            if ( try_view( view ) )
+                return common::informer_error_code_t::success;
+
+            counter_stuck = counter_stuck && load_header_word( *m_mapping, g_sequence_offset ) == first_sequence;
+            std::this_thread::yield( );
+        }
+
+        if ( !counter_stuck )
+            return common::informer_error_code_t::section_read_contended;
+
+        // One odd value for the whole budget, now or in an earlier poll(): the producer does not maintain the counter
+        std::atomic_thread_fence( std::memory_order_acquire );
+        *view = process_section_view_t( m_mapping, first_sequence );
+        return common::informer_error_code_t::success;
+    }
+
+    bool process_section_reader_t::refresh( const process_section_view_t &view, bool *changed, bool *checksum_failed ) {
+        // Nothing new since the last copy: two header loads and done
+        if ( m_has_snapshot && view.sequence( ) == m_sequence && view.last_update_time( ) == m_update_time )
+            return view.consistent( );
+
+        // The payload checksum is computed while it is copied, no second pass over the data
+        uint32_t checksum = 0;
+        memcpy( reinterpret_cast< uint8_t * >( &m_snapshot ), view.data( ), g_section_payload_offset );
+        const uint32_t payload_checksum = utils::copy_memory_crc32c( m_snapshot.m_process_data, view.payload( ), g_section_payload_size );
+        const bool     checksum_mapped  = view.read_checksum( &checksum );
+
+        // Torn, an update started meanwhile; without a working counter only the update time tells
+        if ( !view.consistent( ) || view.last_update_time( ) != m_snapshot.m_last_update_time )
+            return false;
+
+        // A producer that skips the counter can still tear the copy, so a mismatch is retried too
+        if ( !checksum_mapped || payload_checksum != checksum ) {
+            *checksum_failed = true;
+            return false;
+        }
+
+        m_snapshot.m_checksum = checksum;
+        m_sequence            = view.sequence( );
+        m_update_time         = m_snapshot.m_last_update_time;
+        m_has_snapshot        = true;
+
+        if ( changed )
+            *changed = true;
+
+        return true;
+    }
+
+    common::informer_error_code_t process_section_reader_t::poll( bool *changed ) {
+        VAC_TRACE_SCOPE( "process_section_reader_t::poll" );
+
+        if ( changed )
+            *changed = false;
+
+        if ( !m_mapping )
+            return common::informer_error_code_t::section_mapping_failed;
+
+        const uint32_t first_sequence = load_header_word( *m_mapping, g_sequence_offset );
+
+        // Already found stuck at this value: no point in spending the seqlock budget again
+        if ( m_counter_stuck && first_sequence == m_stuck_sequence )
+            return poll_without_counter( first_sequence, changed );
+
+        m_counter_stuck = false;
+
+        bool counter_stuck   = true;
+        bool checksum_failed = false;
+
+        for ( uint32_t attempt = 0; attempt < g_section_read_attempts; ++attempt ) {
+            process_section_view_t view;
+            if ( !try_view( &view ) ) {
+                counter_stuck = counter_stuck && load_header_word( *m_mapping, g_sequence_offset ) == first_sequence;
+                std::this_thread::yield( );
+                continue;
+            }
+
+            counter_stuck = false;
+
+            if ( refresh( view, changed, &checksum_failed ) )
+                return common::informer_error_code_t::success;
+
+            if ( checksum_failed )
+                std::this_thread::yield( );
+        }
+
+        if ( !counter_stuck ) {
+            return checksum_failed ? common::informer_error_code_t::section_checksum_mismatch
+                                   : common::informer_error_code_t::section_read_contended;
+        }
+
+        // One odd value for the whole budget is a producer that leaves m_reserved alone rather than one stuck
+        // mid-update, remembered until the counter moves so later polls go straight to the fallback
+        m_counter_stuck  = true;
+        m_stuck_sequence = first_sequence;
+        return poll_without_counter( first_sequence, changed );
+    }
+
+    common::informer_error_code_t process_section_reader_t::poll_without_counter( const uint32_t sequence, bool *changed ) {
+        bool checksum_failed = false;
+
+        // Read it like any producer without a counter, by m_last_update_time and the checksum
+        for ( uint32_t attempt = 0; attempt < g_section_read_attempts; ++attempt ) {
+            std::atomic_thread_fence( std::memory_order_acquire );
+            if ( refresh( process_section_view_t( m_mapping, sequence ), changed, &checksum_failed ) )
+                return common::informer_error_code_t::success;
+
+            std::this_thread::yield( );
+        }
+
+        return checksum_failed ? common::informer_error_code_t::section_checksum_mismatch
+                               : common::informer_error_code_t::section_read_contended;
+    }
+} // namespace vac::modules::process_informer
@@ -0,0 +1,156 @@
+#pragma once
+
+#include "../../common/types.hpp"
+#include "process_section_view.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace vac::modules::process_informer {
+    constexpr uint32_t g_section_read_attempts = 64;   ///< Seqlock retries before a poll gives up
+    constexpr size_t   g_section_name_size     = 48;   ///< Formatted section name plus terminator
+    constexpr uint64_t g_section_stale_ms      = 2000; ///< Header unchanged for this long makes open() map the section again
+
+    /**
+     * @brief Format the section name from the four GUID bytes
+     *
+     * "{%02xDEDF05-86E9-%02x17-9E36-1D94%02x334DFA-A3%02x4421}" with guid_bytes[ 0 ], [ 3 ], [ 2 ], [ 1 ],
+     * the name the Windows path passes to OpenFileMappingW and the Linux path to shm_open (with a leading '/').
+     *
+     * @param guid_bytes input_data[ 96 .. 99 ] of the module input
+     * @param name Receives the null terminated name, g_section_name_size characters
+     */
+    void format_section_name( const uint8_t *guid_bytes, char *name );
+
+    /**
+     * @brief Long-lived reader for the process information section
+     *
+     * Keeps the section view mapped across calls instead of opening, mapping, copying and
+     * unmapping on every read. poll() follows a sequence-counter protocol over the header:
+     * the producer makes m_reserved (+20) odd before it writes and even again afterwards,
+     * so a copy is only accepted when the counter was even and unchanged around it. The
+     * payload is only copied again when m_last_update_time or the counter moved, so a
+     * steady-state poll is a few loads from the mapped header.
+     *
+     * Every new copy is checked against m_checksum, a CRC32C of m_process_data computed
+     * in the same pass as the copy. Producers that leave m_reserved alone still work; their
+     * updates are picked up from m_last_update_time, and the checksum catches torn copies.
+     * A counter that holds one odd value for the whole retry budget is treated the same way
+     * instead of as contention, and the reader remembers that value: later polls skip the
+     * seqlock retries until the counter moves again, so the steady state stays a few loads.
+     *
+     * A producer that recreates the section leaves the old mapping orphaned, so open() maps
+     * the section again once the header stopped validating or has not changed for
+     * g_section_stale_ms.
+     *
+     * view() hands out the mapped section itself for consumers that only need the header or
+     * a few records; poll() and snapshot() are the copying path kept for the module output.
+     *
+     * Not thread safe; the module serialises access.
+     */
+    class process_section_reader_t {
+    public:
+        process_section_reader_t( ) = default;
+        ~process_section_reader_t( );
+
+        process_section_reader_t( const process_section_reader_t & )             = delete;
+        process_section_reader_t &operator=( const process_section_reader_t & ) = delete;
+
+        /**
+         * @brief Open and map the section named from the four GUID bytes
+         *
+         * Windows: tries OpenFileMappingW first and falls back to query_directory_object_for_section()
+         * when the name is not found. Linux: shm_open( "/<name>" ), falling back to a case-insensitive
+         * search of /dev/shm. Keeps the current mapping if the same section is already mapped and
+         * not stale (see is_stale()).
+         *
+         * @param guid_bytes input_data[ 96 .. 99 ] of the module input
+         * @param system_error Receives the GetLastError() / errno value of a failed call, or the informer code
+         * @return informer_error_code_t value, success if the section is mapped
+         */
+        common::informer_error_code_t open( const uint8_t *guid_bytes, uint32_t *system_error );
+
+        /**
+         * @brief Read from a section that is already mapped elsewhere
+         * @param view Start of the section, must outlive the reader and every view taken from it
+         * @param size Readable bytes at view
+         */
+        void attach( const void *view, size_t size = sizeof( common::process_info_section_t ) );
+
+        /**
+         * @brief Drop the reader's reference to the section, unmapped once no view holds it
+         */
+        void close( );
+
+        bool is_open( ) const { return m_mapping != nullptr; }
+
+        /**
+         * @brief Zero-copy view of the section taken at an even sequence counter
+         *
+         * If the counter holds one odd value for the whole retry budget, or poll() already found it
+         * stuck at its current value, the view is taken at that value; consistent() then cannot see
+         * updates, verify_checksum() still can.
+         *
+         * @param view Receives the view, left untouched on failure
+         * @return success, section_mapping_failed if nothing is open, or section_read_contended
+         */
+        common::informer_error_code_t view( process_section_view_t *view ) const;
+
+        /**
+         * @brief Refresh the local snapshot if the section changed
+         * @param changed Optional, receives true if the snapshot was re-copied
+         * @return success, section_checksum_mismatch if every consistent copy failed the CRC32C check, or
+         *         section_read_contended if no consistent copy was seen within g_section_read_attempts
+         */
+        common::informer_error_code_t poll( bool *changed = nullptr );
+
+        /**
+         * @brief Last consistent copy, valid after a successful poll()
+         */
+        const common::process_info_section_t &snapshot( ) const { return m_snapshot; }
+
+    private:
+        /**
+         * @brief Single attempt at view(), fails while the counter is odd
+         */
+        bool try_view( process_section_view_t *view ) const;
+
+        /**
+         * @brief Copy the section into m_snapshot unless it is unchanged
+         * @param view View to copy from
+         * @param changed Optional, set to true if m_snapshot was re-copied
+         * @param checksum_failed Set if a consistent copy failed the CRC32C check
+         * @return true if m_snapshot is current, false if the copy was torn or failed the check
+         */
+        bool refresh( const process_section_view_t &view, bool *changed, bool *checksum_failed );
+
+        /**
+         * @brief poll() for a producer that leaves the counter at one odd value, by m_last_update_time and the checksum
+         * @param sequence The stuck counter value
+         */
+        common::informer_error_code_t poll_without_counter( uint32_t sequence, bool *changed );
+
+        /**
+         * @brief Whether the mapped header stopped validating or has not changed for g_section_stale_ms
+         *
+         * Magic and size only count once they validated after the mapping was made, so producers
+         * that never write them are not remapped on every call.
+         */
+        bool is_stale( );
+
+        std::shared_ptr< const section_mapping_t > m_mapping          = { }; ///< Shared with outstanding views
+        uint8_t                                    m_guid_bytes[ 4 ]  = { }; ///< GUID bytes of the mapped section
+        bool                                       m_has_snapshot     = { }; ///< m_snapshot holds a consistent copy
+        uint32_t                                   m_sequence         = { }; ///< m_reserved seen with the snapshot
+        uint32_t                                   m_update_time      = { }; ///< m_last_update_time seen with the snapshot
+        uint32_t                                   m_seen_sequence    = { }; ///< m_reserved at the last is_stale()
+        uint32_t                                   m_seen_update_time = { }; ///< m_last_update_time at the last is_stale()
+        uint64_t                                   m_seen_change_ns   = { }; ///< platform_clock() time the header last changed, 0 before the first check
+        bool                                       m_seen_valid       = { }; ///< Magic and size validated since the section was mapped
+        bool                                       m_counter_stuck    = { }; ///< m_reserved held m_stuck_sequence for a whole retry budget
+        uint32_t                                   m_stuck_sequence   = { }; ///< Odd m_reserved value the producer never moves off
+
+        common::process_info_section_t m_snapshot = { }; ///< Local copy handed to callers
+    };
+} // namespace vac::modules::process_informer
@@ -0,0 +1,90 @@
+#include "process_section_view.hpp"
+
+#include "../../common/platform.hpp"
+#include "../../utils/vac_crc32c_utils.hpp"
+#include "../../utils/vac_instrumentation.hpp"
+
+#if defined( __linux__ )
+#include <sys/mman.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <utility>
+
+namespace vac::modules::process_informer {
+    section_mapping_t::section_mapping_t( const void *view, const size_t size, void *handle, const bool owned )
+        : m_view( static_cast< const volatile uint8_t * >( view ) ), m_size( size ), m_handle( handle ), m_owned( owned ) { }
+
+    section_mapping_t::~section_mapping_t( ) {
+        if ( !m_owned )
+            return;
+
+#if defined( _WIN32 )
+        VAC_COUNT_SYSCALL( );
+        UnmapViewOfFile( const_cast< const uint8_t * >( m_view ) );
+        if ( m_handle ) {
+            VAC_COUNT_SYSCALL( );
+            CloseHandle( m_handle );
+        }
+#elif defined( __linux__ )
+        VAC_COUNT_SYSCALL( );
+        munmap( const_cast< uint8_t * >( m_view ), m_size );
+#endif
+    }
+
+    process_section_view_t::process_section_view_t( std::shared_ptr< const section_mapping_t > mapping, const uint32_t sequence )
+        : m_mapping( std::move( mapping ) ), m_sequence( sequence ) {
+        m_record_count = std::min< size_t >( process_count( ), g_section_record_capacity );
+    }
+
+    uint32_t process_section_view_t::load_header_word( const size_t offset ) const {
+        return *reinterpret_cast< const volatile uint32_t * >( m_mapping->data( ) + offset );
+    }
+
+    uint32_t process_section_view_t::magic_signature( ) const {
+        return load_header_word( offsetof( common::process_info_section_t, m_magic_signature ) );
+    }
+
+    uint32_t process_section_view_t::section_size( ) const { return load_header_word( offsetof( common::process_info_section_t, m_section_size ) ); }
+
+    uint32_t process_section_view_t::process_count( ) const {
+        return load_header_word( offsetof( common::process_info_section_t, m_process_count ) );
+    }
+
+    uint32_t process_section_view_t::last_update_time( ) const {
+        return load_header_word( offsetof( common::process_info_section_t, m_last_update_time ) );
+    }
+
+    uint32_t process_section_view_t::flags( ) const { return load_header_word( offsetof( common::process_info_section_t, m_flags ) ); }
+
+    const uint8_t *process_section_view_t::data( ) const { return const_cast< const uint8_t * >( m_mapping->data( ) ); }
+
+    const common::process_entry_t *process_section_view_t::at( const size_t index ) const {
+        return index < m_record_count ? begin( ) + index : nullptr;
+    }
+
+    process_section_view_t::iterator process_section_view_t::begin( ) const {
+        return reinterpret_cast< iterator >( payload( ) );
+    }
+
+    bool process_section_view_t::read_checksum( uint32_t *checksum ) const {
+        constexpr size_t checksum_offset = offsetof( common::process_info_section_t, m_checksum );
+        if ( m_mapping->size( ) < checksum_offset + sizeof( uint32_t ) )
+            return false;
+
+        *checksum = load_header_word( checksum_offset );
+        return true;
+    }
+
+    bool process_section_view_t::verify_checksum( ) const {
+        uint32_t checksum = 0;
+        return read_checksum( &checksum ) && utils::crc32c( payload( ), g_section_payload_size ) == checksum;
+    }
+
+    bool process_section_view_t::consistent( ) const {
+        // Order the caller's reads of the records before the counter re-check
+        std::atomic_thread_fence( std::memory_order_acquire );
+        return load_header_word( offsetof( common::process_info_section_t, m_reserved ) ) == m_sequence;
+    }
+} // namespace vac::modules::process_informer
@@ -0,0 +1,130 @@
+#pragma once
+
+#include "../../common/types.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace vac::modules::process_informer {
+    constexpr size_t g_section_payload_offset = offsetof( common::process_info_section_t, m_process_data ); ///< +24
+    constexpr size_t g_section_payload_size   = sizeof( common::process_info_section_t::m_process_data ); ///< 4072 bytes
+    constexpr size_t g_section_record_capacity
+        = g_section_payload_size / sizeof( common::process_entry_t ); ///< Whole records that fit in the payload (145)
+
+    static_assert( sizeof( common::process_entry_t ) == 28, "process_entry_t must match the section record layout" );
+    static_assert( g_section_payload_offset % alignof( common::process_entry_t ) == 0, "records must be naturally aligned in the section" );
+
+    /**
+     * @brief A mapped process information section
+     *
+     * Owned through std::shared_ptr by the reader and by every view taken from it, so the
+     * memory is only unmapped once the reader has closed it and the last view is gone.
+     */
+    class section_mapping_t {
+    public:
+        /**
+         * @param view Start of the mapped section
+         * @param size Bytes readable from view
+         * @param handle Section handle to close with the view (Windows), may be null
+         * @param owned Unmap the view (UnmapViewOfFile / munmap) on destruction
+         */
+        section_mapping_t( const void *view, size_t size, void *handle, bool owned );
+        ~section_mapping_t( );
+
+        section_mapping_t( const section_mapping_t & )            = delete;
+        section_mapping_t &operator=( const section_mapping_t & ) = delete;
+
+        const volatile uint8_t *data( ) const { return m_view; }
+        size_t                  size( ) const { return m_size; }
+
+    private:
+        const volatile uint8_t *m_view   = { }; ///< Mapped section
+        size_t                  m_size   = { }; ///< Readable bytes
+        void                   *m_handle = { }; ///< Section handle (Windows)
+        bool                    m_owned  = { }; ///< View was mapped by the reader
+    };
+
+    /**
+     * @brief Read-only view into the mapped section, no payload copy
+     *
+     * Taken while the producer's sequence counter (m_reserved) was even, or at the odd value of
+     * a producer that leaves the counter alone (see process_section_reader_t::view()). Records are read in
+     * place; the record count is fixed when the view is taken and never exceeds what fits in
+     * the payload, whatever m_process_count claims. Because the producer can start a new
+     * update at any time, callers that need a consistent set of records check consistent()
+     * after reading them and take a new view if it returns false.
+     *
+     * The view keeps the mapping alive, so it stays safe to read after the reader closes or
+     * switches to another section.
+     */
+    class process_section_view_t {
+    public:
+        using iterator = const common::process_entry_t *; ///< Records are naturally aligned in the section
+
+        process_section_view_t( ) = default;
+        process_section_view_t( std::shared_ptr< const section_mapping_t > mapping, uint32_t sequence );
+
+        bool is_valid( ) const { return m_mapping != nullptr; }
+
+        uint32_t magic_signature( ) const;
+        uint32_t section_size( ) const;
+        uint32_t process_count( ) const;
+        uint32_t last_update_time( ) const;
+        uint32_t flags( ) const;
+
+        /**
+         * @brief Sequence counter value the view was taken at
+         */
+        uint32_t sequence( ) const { return m_sequence; }
+
+        /**
+         * @brief Start of the section (header included), for callers that copy it out
+         */
+        const uint8_t *data( ) const;
+
+        /**
+         * @brief Start of the 4072-byte payload
+         */
+        const uint8_t *payload( ) const { return data( ) + g_section_payload_offset; }
+
+        /**
+         * @brief Number of records, min( m_process_count, g_section_record_capacity ) when the view was taken
+         */
+        size_t size( ) const { return m_record_count; }
+        bool   empty( ) const { return !m_record_count; }
+
+        /**
+         * @brief Bounds-checked record access
+         * @return Record in the mapped section, or nullptr if index >= size()
+         */
+        const common::process_entry_t *at( size_t index ) const;
+
+        iterator begin( ) const;
+        iterator end( ) const { return begin( ) + m_record_count; }
+
+        /**
+         * @brief Read m_checksum (+4096)
+         * @return false if the mapping does not reach the checksum field
+         */
+        bool read_checksum( uint32_t *checksum ) const;
+
+        /**
+         * @brief Compute the CRC32C of the payload in place and compare it with m_checksum
+         * @return false on a mismatch or if the checksum is not mapped
+         */
+        bool verify_checksum( ) const;
+
+        /**
+         * @brief Whether the producer has not started an update since the view was taken
+         */
+        bool consistent( ) const;
+
+    private:
+        uint32_t load_header_word( size_t offset ) const;
+
+        std::shared_ptr< const section_mapping_t > m_mapping      = { }; ///< Keeps the section mapped
+        uint32_t                                   m_sequence     = { }; ///< Counter value at creation, even unless the producer leaves it alone
+        size_t                                     m_record_count = { }; ///< Bounded record count
+    };
+} // namespace vac::modules::process_informer
@@ -0,0 +1,67 @@
+#include "shm_directory_source.hpp"
+
+#if defined( __linux__ )
+#include "../../utils/vac_dirent_utils.hpp"
+#include "../../utils/vac_instrumentation.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace vac::modules::process_informer {
+    shm_directory_source_t::shm_directory_source_t( const char *directory_path ) : m_directory_path( directory_path ) {
+        m_buffer.resize( g_initial_buffer_size );
+    }
+
+    int shm_directory_source_t::enumerate( const object_directory_visitor_t &visitor ) {
+        VAC_TRACE_SCOPE( "shm_directory_source_t::enumerate" );
+
+        m_query_count = 0;
+
+        VAC_COUNT_SYSCALL( );
+        const int directory_fd = open( m_directory_path.c_str( ), O_RDONLY | O_DIRECTORY | O_CLOEXEC );
+        if ( directory_fd < 0 )
+            return errno;
+
+        int result = 0;
+
+        while ( true ) {
+            ++m_query_count;
+            const long bytes_read = utils::read_directory_batch( directory_fd, m_buffer );
+
+            // EINVAL: not even one record fit
+            if ( bytes_read < 0 ) {
+                if ( errno == EINVAL && m_buffer.size( ) < g_max_buffer_size ) {
+                    m_buffer.resize( m_buffer.size( ) * 2 );
+                    continue;
+                }
+
+                result = errno;
+                break;
+            }
+
+            if ( bytes_read == 0 )
+                break;
+
+            const bool stopped = utils::for_each_batch_entry( m_buffer.data( ), bytes_read, [ & ]( const char *name ) {
+                object_directory_entry_t entry;
+                entry.m_name        = name;
+                entry.m_name_length = static_cast< uint32_t >( strlen( name ) );
+                entry.m_char_size   = 1;
+                return visitor( entry );
+            } );
+
+            if ( stopped )
+                break;
+
+            if ( m_buffer.size( ) < g_max_buffer_size )
+                m_buffer.resize( m_buffer.size( ) * 2 );
+        }
+
+        VAC_COUNT_SYSCALL( );
+        close( directory_fd );
+        return result;
+    }
+} // namespace vac::modules::process_informer
+#endif
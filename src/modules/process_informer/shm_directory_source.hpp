@@ -0,0 +1,38 @@
+#pragma once
+#include "object_directory_source.hpp"
+
+#if defined( __linux__ )
+#include <string>
+#include <vector>
+
+namespace vac::modules::process_informer {
+    /**
+     * @brief Object directory source over a Linux directory, /dev/shm by default
+     *
+     * Stand-in for \BaseNamedObjects where POSIX shared memory objects live. Reads with raw
+     * getdents64 into a buffer kept between enumerations that doubles (up to
+     * g_max_buffer_size) after every full batch, mirroring nt_object_directory_source_t.
+     * Any directory can be passed, so large synthetic directories can be searched the same way.
+     */
+    class shm_directory_source_t final : public object_directory_source_t {
+    public:
+        static constexpr size_t g_initial_buffer_size = 0x1000;  ///< First getdents64 buffer
+        static constexpr size_t g_max_buffer_size     = 0x40000; ///< Growth stops here
+
+        /**
+         * @param directory_path Directory to enumerate
+         */
+        explicit shm_directory_source_t( const char *directory_path = "/dev/shm" );
+
+        /**
+         * @brief Enumerate the directory in batches, "." and ".." are skipped
+         * @return 0 on success, errno of the failed open / getdents64
+         */
+        int enumerate( const object_directory_visitor_t &visitor ) override;
+
+    private:
+        std::string         m_directory_path; ///< Directory to enumerate
+        std::vector< char > m_buffer;         ///< getdents64 buffer reused across enumerations
+    };
+} // namespace vac::modules::process_informer
+#endif
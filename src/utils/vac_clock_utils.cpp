@@ -0,0 +1,156 @@
+#include "vac_clock_utils.hpp"
+
+#include "../common/platform.hpp"
+
+#if defined( _MSC_VER )
+#include <intrin.h>
+#elif defined( __GNUC__ ) && ( defined( __x86_64__ ) || defined( __i386__ ) )
+#include <cpuid.h>
+#include <x86intrin.h>
+#endif
+
+#if defined( __linux__ )
+#include <time.h>
+#endif
+
+#include <chrono>
+
+namespace vac::utils {
+    namespace {
+        constexpr uint32_t g_read_cost_samples       = 4096; ///< Reads timed by measure_read_cost()
+        constexpr uint32_t g_tsc_calibration_ms      = 5;    ///< Calibration window against steady_clock
+        constexpr uint32_t g_shared_data_max_backoff = 64;   ///< Most _mm_pause per retry while the tick count is mid-update
+
+        uint64_t steady_now_ns( ) {
+            return static_cast< uint64_t >(
+                std::chrono::duration_cast< std::chrono::nanoseconds >( std::chrono::steady_clock::now( ).time_since_epoch( ) ).count( ) );
+        }
+    } // namespace
+
+    void clock_source_t::measure_read_cost( ) {
+        volatile uint64_t sink = 0;
+
+        const uint64_t start = steady_now_ns( );
+        for ( uint32_t sample = 0; sample < g_read_cost_samples; ++sample )
+            sink = now_ns( );
+        const uint64_t end = steady_now_ns( );
+
+        static_cast< void >( sink );
+        m_read_cost_ns = static_cast< double >( end - start ) / g_read_cost_samples;
+    }
+
+#if defined( __x86_64__ ) || defined( __i386__ ) || defined( _M_X64 ) || defined( _M_IX86 )
+    tsc_clock_t::tsc_clock_t( ) {
+        // Invariant TSC: CPUID 0x80000007 EDX bit 8
+#if defined( _MSC_VER )
+        int registers[ 4 ] = { };
+        __cpuid( registers, static_cast< int >( 0x80000000 ) );
+        if ( static_cast< uint32_t >( registers[ 0 ] ) >= 0x80000007 ) {
+            __cpuid( registers, static_cast< int >( 0x80000007 ) );
+            m_invariant = ( registers[ 3 ] >> 8 ) & 1;
+        }
+#else
+        uint32_t eax = 0, ebx = 0, ecx = 0, edx = 0;
+        if ( __get_cpuid( 0x80000007, &eax, &ebx, &ecx, &edx ) )
+            m_invariant = ( edx >> 8 ) & 1;
+#endif
+
+        const uint64_t steady_start = steady_now_ns( );
+        const uint64_t tsc_start    = __rdtsc( );
+
+        uint64_t steady_end;
+        while ( ( steady_end = steady_now_ns( ) ) - steady_start < g_tsc_calibration_ms * 1000000ull ) { }
+        const uint64_t tsc_end = __rdtsc( );
+
+        const uint64_t elapsed_ns    = steady_end - steady_start;
+        const uint64_t elapsed_ticks = tsc_end - tsc_start;
+
+        m_frequency_hz = elapsed_ns ? static_cast< uint64_t >( static_cast< double >( elapsed_ticks ) * 1e9 / static_cast< double >( elapsed_ns ) ) : 0;
+        m_ns_per_tick_fixed
+            = m_frequency_hz ? static_cast< uint64_t >( 1e9 * 4294967296.0 / static_cast< double >( m_frequency_hz ) ) : 0;
+
+        measure_read_cost( );
+    }
+
+    uint64_t tsc_clock_t::now_ns( ) const {
+        const uint64_t ticks = __rdtsc( );
+
+        // ticks * m_ns_per_tick_fixed >> 32 without a 128-bit product
+        return ( ticks >> 32 ) * m_ns_per_tick_fixed + ( ( ticks & 0xFFFFFFFF ) * m_ns_per_tick_fixed >> 32 );
+    }
+#endif
+
+#if defined( __linux__ )
+    monotonic_raw_clock_t::monotonic_raw_clock_t( ) { measure_read_cost( ); }
+
+    uint64_t monotonic_raw_clock_t::now_ns( ) const {
+        timespec now = { };
+        clock_gettime( CLOCK_MONOTONIC_RAW, &now );
+        return static_cast< uint64_t >( now.tv_sec ) * 1000000000ull + static_cast< uint64_t >( now.tv_nsec );
+    }
+#endif
+
+#if defined( _WIN32 )
+    shared_data_clock_t::shared_data_clock_t( ) { measure_read_cost( ); }
+
+    uint64_t shared_data_clock_t::now_ns( ) const {
+        const auto *tick_low        = reinterpret_cast< const volatile uint32_t * >( 0x7FFE0320 );
+        const auto *tick_high1      = reinterpret_cast< const volatile uint32_t * >( 0x7FFE0324 );
+        const auto *tick_high2      = reinterpret_cast< const volatile uint32_t * >( 0x7FFE0328 );
+        const auto *tick_multiplier = reinterpret_cast< const volatile uint32_t * >( 0x7FFE0004 );
+        const auto *tick_deprecated = reinterpret_cast< const volatile uint32_t * >( 0x7FFE0000 );
+
+        uint32_t backoff = 1;
+        uint32_t low, high;
+
+        // High2Time is written first and High1Time last, so matching halves mean LowPart is stable
+        while ( true ) {
+            high = *tick_high1;
+            low  = *tick_low;
+            if ( high == *tick_high2 )
+                break;
+
+            for ( uint32_t pause = 0; pause < backoff; ++pause )
+                _mm_pause( );
+
+            backoff = backoff < g_shared_data_max_backoff ? backoff * 2 : backoff;
+        }
+
+        // Systems that never filled TickCount only keep the 32-bit TickCountLowDeprecated
+        const uint64_t ticks = ( static_cast< uint64_t >( high ) << 32 ) | low;
+        if ( !ticks )
+            return ( static_cast< uint64_t >( *tick_deprecated ) * *tick_multiplier >> 24 ) * 1000000ull;
+
+        const uint64_t milliseconds
+            = ( ticks >> 32 ) * ( static_cast< uint64_t >( *tick_multiplier ) << 8 ) + ( ( ticks & 0xFFFFFFFF ) * *tick_multiplier >> 24 );
+
+        return milliseconds * 1000000ull;
+    }
+#endif
+
+    const clock_source_t &platform_clock( ) {
+#if defined( _WIN32 )
+        static const shared_data_clock_t clock;
+#elif defined( __linux__ )
+        static const monotonic_raw_clock_t clock;
+#endif
+
+        return clock;
+    }
+
+    const clock_source_t &precise_clock( ) {
+        static const clock_source_t *clock = [ ]( ) -> const clock_source_t * {
+            const clock_source_t &fallback_clock = platform_clock( );
+
+#if defined( __x86_64__ ) || defined( __i386__ ) || defined( _M_X64 ) || defined( _M_IX86 )
+            static const tsc_clock_t tsc_clock;
+            if ( tsc_clock.invariant( ) && tsc_clock.frequency_hz( ) && tsc_clock.read_cost_ns( ) < fallback_clock.read_cost_ns( ) )
+                return &tsc_clock;
+#endif
+
+            return &fallback_clock;
+        }( );
+
+        return *clock;
+    }
+} // namespace vac::utils
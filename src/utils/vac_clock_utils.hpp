@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cstdint>
+
+namespace vac::utils {
+    /**
+     * @brief Monotonic time source
+     *
+     * Every backend reports nanoseconds from its own epoch (boot or reset), so only
+     * differences and coarse units are comparable across backends. read_cost_ns() is
+     * the average cost of one now_ns() call, measured when the clock is created.
+     */
+    class clock_source_t {
+    public:
+        virtual ~clock_source_t( ) = default;
+
+        /**
+         * @brief Current time in nanoseconds
+         */
+        virtual uint64_t now_ns( ) const = 0;
+
+        /**
+         * @brief Backend name for reports
+         */
+        virtual const char *name( ) const = 0;
+
+        double read_cost_ns( ) const { return m_read_cost_ns; }
+
+        /**
+         * @brief Current time in milliseconds, truncated like GetTickCount()
+         */
+        uint32_t now_ms( ) const { return static_cast< uint32_t >( now_ns( ) / 1000000 ); }
+
+    protected:
+        /**
+         * @brief Time a burst of now_ns() calls against std::chrono::steady_clock
+         */
+        void measure_read_cost( );
+
+        double m_read_cost_ns = { }; ///< Average cost of one read
+    };
+
+#if defined( __x86_64__ ) || defined( __i386__ ) || defined( _M_X64 ) || defined( _M_IX86 )
+    /**
+     * @brief Calibrated time stamp counter
+     *
+     * Calibrated once against std::chrono::steady_clock over a few milliseconds and
+     * converted with a 32.32 fixed-point multiplier, so a read is one RDTSC and two
+     * multiplies. Only trustworthy when the TSC is invariant (CPUID 0x80000007 EDX bit 8).
+     */
+    class tsc_clock_t final : public clock_source_t {
+    public:
+        tsc_clock_t( );
+
+        uint64_t    now_ns( ) const override;
+        const char *name( ) const override { return "tsc"; }
+
+        bool     invariant( ) const { return m_invariant; }
+        uint64_t frequency_hz( ) const { return m_frequency_hz; }
+
+    private:
+        uint64_t m_ns_per_tick_fixed = { }; ///< Nanoseconds per tick, 32.32 fixed point
+        uint64_t m_frequency_hz      = { }; ///< Calibrated TSC frequency
+        bool     m_invariant         = { }; ///< CPUID reports an invariant TSC
+    };
+#endif
+
+#if defined( __linux__ )
+    /**
+     * @brief clock_gettime( CLOCK_MONOTONIC_RAW ), not slewed by NTP
+     */
+    class monotonic_raw_clock_t final : public clock_source_t {
+    public:
+        monotonic_raw_clock_t( );
+
+        uint64_t    now_ns( ) const override;
+        const char *name( ) const override { return "monotonic_raw"; }
+    };
+#endif
+
+#if defined( _WIN32 )
+    /**
+     * @brief Tick count from KUSER_SHARED_DATA, the value GetTickCount() returns
+     *
+     * Reads TickCount (+0x320) as a KSYSTEM_TIME: LowPart is only consistent when
+     * High1Time (+0x324) equals High2Time (+0x328), so the read retries with an
+     * exponential _mm_pause backoff while the kernel is mid-update. Scaled by
+     * TickCountMultiplier (+0x004) into milliseconds; millisecond resolution only.
+     */
+    class shared_data_clock_t final : public clock_source_t {
+    public:
+        shared_data_clock_t( );
+
+        uint64_t    now_ns( ) const override;
+        const char *name( ) const override { return "kuser_shared_data"; }
+    };
+#endif
+
+    /**
+     * @brief Process-wide platform tick-count clock, created on first use
+     *
+     * Shared data on Windows, whose now_ms() is the GetTickCount() value, and
+     * CLOCK_MONOTONIC_RAW on Linux. Never touches the TSC, so it is what timestamps that
+     * end up in module output and coarse timeouts read.
+     */
+    const clock_source_t &platform_clock( );
+
+    /**
+     * @brief Process-wide clock for timing intervals, created on first use
+     *
+     * The platform clock unless an invariant TSC is measured to be cheaper to read. The first
+     * call calibrates the TSC (a few milliseconds of busy waiting), so only callers that time
+     * short intervals (instrumentation, the runner, benchmarks) use it.
+     */
+    const clock_source_t &precise_clock( );
+} // namespace vac::utils
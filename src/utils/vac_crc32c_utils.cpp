@@ -0,0 +1,238 @@
+#include "vac_crc32c_utils.hpp"
+
+#if defined( _MSC_VER )
+#include <intrin.h>
+#include <nmmintrin.h>
+#elif defined( __GNUC__ ) && ( defined( __x86_64__ ) || defined( __i386__ ) )
+#include <cpuid.h>
+#include <nmmintrin.h>
+#endif
+
+#include <array>
+#include <cstring>
+
+#if defined( __GNUC__ ) || defined( __clang__ )
+#define VAC_CRC32C_TARGET_SSE42 __attribute__( ( target( "sse4.2" ) ) )
+#else
+#define VAC_CRC32C_TARGET_SSE42
+#endif
+
+namespace vac::utils {
+    namespace {
+        constexpr uint32_t g_crc32c_polynomial = 0x82F63B78; ///< Castagnoli, reflected
+
+        /**
+         * @brief Slice-by-8 tables, g_crc32c_tables[ 0 ] is the classic byte table
+         */
+        constexpr std::array< std::array< uint32_t, 256 >, 8 > make_crc32c_tables( ) {
+            std::array< std::array< uint32_t, 256 >, 8 > tables = { };
+
+            for ( uint32_t index = 0; index < 256; ++index ) {
+                uint32_t crc = index;
+                for ( uint32_t bit = 0; bit < 8; ++bit )
+                    crc = crc & 1 ? ( crc >> 1 ) ^ g_crc32c_polynomial : crc >> 1;
+
+                tables[ 0 ][ index ] = crc;
+            }
+
+            for ( uint32_t index = 0; index < 256; ++index ) {
+                for ( size_t slice = 1; slice < 8; ++slice )
+                    tables[ slice ][ index ] = ( tables[ slice - 1 ][ index ] >> 8 ) ^ tables[ 0 ][ tables[ slice - 1 ][ index ] & 0xFF ];
+            }
+
+            return tables;
+        }
+
+        constexpr auto g_crc32c_tables = make_crc32c_tables( );
+
+        static_assert( g_crc32c_tables[ 0 ][ 1 ] == 0xF26B8303, "CRC32C byte table mismatch" );
+
+        /**
+         * @brief a * b mod p over GF(2), reflected representation (zlib's multmodp)
+         */
+        constexpr uint32_t multmodp( const uint32_t a, uint32_t b ) {
+            uint32_t product = 0;
+
+            for ( uint32_t mask = 1u << 31; mask; mask >>= 1 ) {
+                if ( a & mask ) {
+                    product ^= b;
+                    if ( !( a & ( mask - 1 ) ) )
+                        break;
+                }
+
+                b = b & 1 ? ( b >> 1 ) ^ g_crc32c_polynomial : b >> 1;
+            }
+
+            return product;
+        }
+
+        /**
+         * @brief x^( n * 2^k ) mod p (zlib's x2nmodp), x^( 8n ) shifts a CRC register over n zero bytes with k = 3
+         */
+        constexpr uint32_t x2nmodp( size_t n, uint32_t k ) {
+            // x2n_table[ i ] = x^( 2^i ) mod p
+            std::array< uint32_t, 32 > x2n_table = { };
+
+            uint32_t power = 1u << 30; // x^1
+            x2n_table[ 0 ] = power;
+            for ( size_t index = 1; index < 32; ++index )
+                x2n_table[ index ] = power = multmodp( power, power );
+
+            uint32_t result = 1u << 31; // x^0
+            while ( n ) {
+                if ( n & 1 )
+                    result = multmodp( x2n_table[ k & 31 ], result );
+
+                n >>= 1;
+                ++k;
+            }
+
+            return result;
+        }
+
+        static_assert( x2nmodp( 0, 3 ) == 1u << 31, "x^0 must be the multiplicative identity" );
+
+        uint32_t load_u32( const uint8_t *bytes ) {
+            uint32_t value;
+            memcpy( &value, bytes, sizeof( value ) );
+            return value;
+        }
+
+        /**
+         * @brief Raw register update (no pre/post inversion), copying when dest is set
+         */
+        uint32_t slice8_update( uint32_t crc, uint8_t *dest, const uint8_t *source, size_t length ) {
+            const auto &t = g_crc32c_tables;
+
+            for ( ; length >= 8; length -= 8, source += 8 ) {
+                if ( dest ) {
+                    memcpy( dest, source, 8 );
+                    dest += 8;
+                }
+
+                // Little-endian word order, the byte table applies to the lowest byte first
+                const uint32_t low  = load_u32( source ) ^ crc;
+                const uint32_t high = load_u32( source + 4 );
+
+                crc = t[ 7 ][ low & 0xFF ] ^ t[ 6 ][ ( low >> 8 ) & 0xFF ] ^ t[ 5 ][ ( low >> 16 ) & 0xFF ] ^ t[ 4 ][ low >> 24 ]
+                    ^ t[ 3 ][ high & 0xFF ] ^ t[ 2 ][ ( high >> 8 ) & 0xFF ] ^ t[ 1 ][ ( high >> 16 ) & 0xFF ] ^ t[ 0 ][ high >> 24 ];
+            }
+
+            for ( ; length; --length, ++source ) {
+                if ( dest )
+                    *dest++ = *source;
+
+                crc = ( crc >> 8 ) ^ t[ 0 ][ ( crc ^ *source ) & 0xFF ];
+            }
+
+            return crc;
+        }
+
+#if defined( __x86_64__ ) || defined( __i386__ ) || defined( _M_X64 ) || defined( _M_IX86 )
+        constexpr size_t   g_crc32c_lane_size      = 1344; ///< Bytes per stream, three lanes cover a 4 KB payload in one block
+        constexpr size_t   g_crc32c_block_size     = 3 * g_crc32c_lane_size;
+        constexpr uint32_t g_crc32c_shift_one_lane = x2nmodp( g_crc32c_lane_size, 3 );     ///< Shift over one lane
+        constexpr uint32_t g_crc32c_shift_two_lane = x2nmodp( 2 * g_crc32c_lane_size, 3 ); ///< Shift over two lanes
+
+        static_assert( g_crc32c_lane_size % 8 == 0, "lanes are consumed in 8-byte words" );
+
+        VAC_CRC32C_TARGET_SSE42 uint32_t sse42_update_word( uint32_t crc, const uint8_t *source ) {
+#if defined( __x86_64__ ) || defined( _M_X64 )
+            uint64_t word;
+            memcpy( &word, source, sizeof( word ) );
+            return static_cast< uint32_t >( _mm_crc32_u64( crc, word ) );
+#else
+            crc = _mm_crc32_u32( crc, load_u32( source ) );
+            return _mm_crc32_u32( crc, load_u32( source + 4 ) );
+#endif
+        }
+
+        /**
+         * @brief Raw register update (no pre/post inversion), copying when dest is set
+         */
+        VAC_CRC32C_TARGET_SSE42 uint32_t sse42_update( uint32_t crc, uint8_t *dest, const uint8_t *source, size_t length ) {
+            // Three independent streams hide the 3-cycle latency of crc32, then get folded together
+            for ( ; length >= g_crc32c_block_size; length -= g_crc32c_block_size, source += g_crc32c_block_size ) {
+                uint32_t crc0 = crc, crc1 = 0, crc2 = 0;
+
+                for ( size_t offset = 0; offset < g_crc32c_lane_size; offset += 8 ) {
+                    const uint8_t *word0 = source + offset;
+                    const uint8_t *word1 = word0 + g_crc32c_lane_size;
+                    const uint8_t *word2 = word1 + g_crc32c_lane_size;
+
+                    if ( dest ) {
+                        memcpy( dest + offset, word0, 8 );
+                        memcpy( dest + offset + g_crc32c_lane_size, word1, 8 );
+                        memcpy( dest + offset + 2 * g_crc32c_lane_size, word2, 8 );
+                    }
+
+                    crc0 = sse42_update_word( crc0, word0 );
+                    crc1 = sse42_update_word( crc1, word1 );
+                    crc2 = sse42_update_word( crc2, word2 );
+                }
+
+                crc = multmodp( g_crc32c_shift_two_lane, crc0 ) ^ multmodp( g_crc32c_shift_one_lane, crc1 ) ^ crc2;
+
+                if ( dest )
+                    dest += g_crc32c_block_size;
+            }
+
+            for ( ; length >= 8; length -= 8, source += 8 ) {
+                if ( dest ) {
+                    memcpy( dest, source, 8 );
+                    dest += 8;
+                }
+
+                crc = sse42_update_word( crc, source );
+            }
+
+            for ( ; length; --length, ++source ) {
+                if ( dest )
+                    *dest++ = *source;
+
+                crc = _mm_crc32_u8( crc, *source );
+            }
+
+            return crc;
+        }
+
+        bool probe_sse42( ) {
+            // CPUID 1 ECX bit 20
+#if defined( _MSC_VER )
+            int registers[ 4 ] = { };
+            __cpuid( registers, 1 );
+            return ( registers[ 2 ] >> 20 ) & 1;
+#else
+            uint32_t eax = 0, ebx = 0, ecx = 0, edx = 0;
+            return __get_cpuid( 1, &eax, &ebx, &ecx, &edx ) && ( ( ecx >> 20 ) & 1 );
+#endif
+        }
+#endif
+    } // namespace
+
+    uint32_t copy_memory_crc32c_slice8( void *dest, const void *source, const size_t length, const uint32_t crc ) {
+        return ~slice8_update( ~crc, static_cast< uint8_t * >( dest ), static_cast< const uint8_t * >( source ), length );
+    }
+
+#if defined( __x86_64__ ) || defined( __i386__ ) || defined( _M_X64 ) || defined( _M_IX86 )
+    uint32_t copy_memory_crc32c_sse42( void *dest, const void *source, const size_t length, const uint32_t crc ) {
+        return ~sse42_update( ~crc, static_cast< uint8_t * >( dest ), static_cast< const uint8_t * >( source ), length );
+    }
+
+    bool crc32c_hardware_supported( ) {
+        static const bool supported = probe_sse42( );
+        return supported;
+    }
+
+    uint32_t copy_memory_crc32c( void *dest, const void *source, const size_t length, const uint32_t crc ) {
+        return crc32c_hardware_supported( ) ? copy_memory_crc32c_sse42( dest, source, length, crc )
+                                            : copy_memory_crc32c_slice8( dest, source, length, crc );
+    }
+#else
+    bool crc32c_hardware_supported( ) { return false; }
+
+    uint32_t copy_memory_crc32c( void *dest, const void *source, const size_t length, const uint32_t crc ) {
+        return copy_memory_crc32c_slice8( dest, source, length, crc );
+    }
+#endif
+} // namespace vac::utils
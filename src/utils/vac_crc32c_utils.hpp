@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace vac::utils {
+    /**
+     * @brief Copy memory and compute its CRC32C (Castagnoli) in the same pass
+     *
+     * Every source byte is read once: the SSE4.2 path (chosen at run time when the CPU has
+     * the crc32 instruction) runs three interleaved crc32 streams over thirds of each block
+     * and stores the loaded words as it goes; otherwise slice-by-8 does the same with
+     * compile-time tables. Chained calls continue a checksum by passing the previous result.
+     *
+     * @param dest Destination buffer, may be nullptr to only compute the checksum
+     * @param source Source bytes
+     * @param length Number of bytes
+     * @param crc Checksum of the preceding bytes, 0 to start
+     * @return CRC32C of all bytes so far
+     */
+    uint32_t copy_memory_crc32c( void *dest, const void *source, size_t length, uint32_t crc = 0 );
+
+    /**
+     * @brief CRC32C of a buffer, see copy_memory_crc32c()
+     */
+    inline uint32_t crc32c( const void *data, const size_t length, const uint32_t crc = 0 ) {
+        return copy_memory_crc32c( nullptr, data, length, crc );
+    }
+
+    /**
+     * @brief Portable slice-by-8 implementation, always available
+     */
+    uint32_t copy_memory_crc32c_slice8( void *dest, const void *source, size_t length, uint32_t crc = 0 );
+
+    /**
+     * @brief Whether copy_memory_crc32c() uses the SSE4.2 crc32 instruction
+     */
+    bool crc32c_hardware_supported( );
+
+#if defined( __x86_64__ ) || defined( __i386__ ) || defined( _M_X64 ) || defined( _M_IX86 )
+    /**
+     * @brief SSE4.2 implementation, only call when crc32c_hardware_supported() is true
+     */
+    uint32_t copy_memory_crc32c_sse42( void *dest, const void *source, size_t length, uint32_t crc = 0 );
+#endif
+} // namespace vac::utils
@@ -0,0 +1,15 @@
+#include "vac_dirent_utils.hpp"
+
+#if defined( __linux__ )
+#include "vac_instrumentation.hpp"
+
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace vac::utils {
+    long read_directory_batch( const int directory_fd, std::vector< char > &buffer ) {
+        VAC_COUNT_SYSCALL( );
+        return syscall( SYS_getdents64, directory_fd, buffer.data( ), buffer.size( ) );
+    }
+} // namespace vac::utils
+#endif
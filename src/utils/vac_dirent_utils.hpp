@@ -0,0 +1,72 @@
+#pragma once
+
+#if defined( __linux__ )
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace vac::utils {
+    /**
+     * @brief Kernel record layout returned by getdents64
+     */
+    struct linux_dirent64_t {
+        uint64_t       m_inode         = { }; ///< +0: Inode number
+        int64_t        m_next_offset   = { }; ///< +8: Offset of the next record
+        unsigned short m_record_length = { }; ///< +16: Size of this record
+        unsigned char  m_type          = { }; ///< +18: DT_* file type
+        char           m_name[ 1 ]     = { }; ///< +19: Null terminated name
+    };
+
+    constexpr size_t g_dirent_buffer_size = 0x8000; ///< getdents64 buffer for callers without their own sizing
+
+    inline bool is_dot_entry( const char *name ) { return name[ 0 ] == '.' && ( !name[ 1 ] || ( name[ 1 ] == '.' && !name[ 2 ] ) ); }
+
+    /**
+     * @brief Read the next records of an open directory with one raw getdents64 call
+     * @param directory_fd Directory opened with O_DIRECTORY
+     * @param buffer Receives the records, its size is the request size
+     * @return Bytes of records, 0 at the end of the directory, -1 with errno set on failure
+     */
+    long read_directory_batch( int directory_fd, std::vector< char > &buffer );
+
+    /**
+     * @brief Call callback( name ) for every record of a batch except "." and ".."
+     * @param batch Records returned by read_directory_batch()
+     * @param batch_size Bytes of records
+     * @param callback bool( const char *name ), returning true stops the batch
+     * @return true if the callback stopped the batch
+     */
+    template < typename callback_t >
+    bool for_each_batch_entry( const char *batch, const long batch_size, callback_t &&callback ) {
+        for ( long offset = 0; offset < batch_size; ) {
+            const auto *record = reinterpret_cast< const linux_dirent64_t * >( batch + offset );
+            offset            += record->m_record_length;
+
+            if ( !is_dot_entry( record->m_name ) && callback( static_cast< const char * >( record->m_name ) ) )
+                return true;
+        }
+
+        return false;
+    }
+
+    /**
+     * @brief Walk an open directory with raw getdents64 batches, skipping "." and ".."
+     * @param directory_fd Directory opened with O_DIRECTORY
+     * @param buffer Batch buffer, reused across calls by the owner
+     * @param callback bool( const char *name ), returning true stops the walk
+     * @return 0 once the directory is exhausted or the callback stopped the walk, errno otherwise
+     */
+    template < typename callback_t >
+    int for_each_directory_entry( const int directory_fd, std::vector< char > &buffer, callback_t &&callback ) {
+        while ( true ) {
+            const long bytes_read = read_directory_batch( directory_fd, buffer );
+            if ( bytes_read < 0 )
+                return errno;
+
+            if ( !bytes_read || for_each_batch_entry( buffer.data( ), bytes_read, callback ) )
+                return 0;
+        }
+    }
+} // namespace vac::utils
+#endif
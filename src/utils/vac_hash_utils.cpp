@@ -1,5 +1,6 @@
 #include "vac_hash_utils.hpp"
 #include "../common/types.hpp"
+#include "vac_instrumentation.hpp"
 #include "vac_string_utils.hpp"
 
 namespace vac::utils {
@@ -74,6 +75,7 @@ namespace vac::utils {
 
             // Reallocate buffer
             const HANDLE heap = GetProcessHeap( );
+            VAC_COUNT_HEAP_ALLOCATION( 4 * reinterpret_cast< size_t >( new_end ) );
             void        *new_buffer;
             if ( old_buffer ) {
                 new_buffer = HeapReAlloc( heap, 0, old_buffer, 4 * reinterpret_cast< size_t >( new_end ) );
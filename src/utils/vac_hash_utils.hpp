@@ -1,4 +1,6 @@
 #pragma once
+#include "vac_instrumentation.hpp"
+
 #include <cstdint>
 #include <windows.h>
 
@@ -94,6 +96,8 @@ namespace vac::utils {
      * @return Pointer to allocated/reallocated memory, or nullptr on failure
      */
     inline LPVOID allocate_from_heap( const LPVOID existing_memory, const SIZE_T new_size ) {
+        VAC_COUNT_HEAP_ALLOCATION( new_size );
+
         const HANDLE process_heap = GetProcessHeap( );
         if ( existing_memory ) {
             return HeapReAlloc( process_heap, 0, existing_memory, new_size );
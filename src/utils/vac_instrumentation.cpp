@@ -0,0 +1,291 @@
+#include "vac_instrumentation.hpp"
+#include "vac_clock_utils.hpp"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <string_view>
+#include <unordered_map>
+
+namespace vac::utils {
+    namespace {
+        /**
+         * @brief Bounds-checked reader over a binary trace
+         */
+        struct trace_cursor_t {
+            const uint8_t *m_data   = { }; ///< Trace bytes
+            size_t         m_size   = { }; ///< Number of bytes
+            size_t         m_offset = { }; ///< Next byte to read
+
+            bool read( void *dest, const size_t length ) {
+                if ( m_size - m_offset < length )
+                    return false;
+
+                // Empty tables pass a null vector data() as dest
+                if ( !length )
+                    return true;
+
+                memcpy( dest, m_data + m_offset, length );
+                m_offset += length;
+                return true;
+            }
+        };
+
+        /**
+         * @brief Append a JSON string literal
+         */
+        void append_json_string( std::string *json, const std::string_view text ) {
+            json->push_back( '"' );
+
+            for ( const char character : text ) {
+                if ( character == '"' || character == '\\' ) {
+                    json->push_back( '\\' );
+                    json->push_back( character );
+                } else if ( static_cast< unsigned char >( character ) < 0x20 ) {
+                    char escaped[ 8 ];
+                    snprintf( escaped, sizeof( escaped ), "\\u%04x", static_cast< unsigned char >( character ) );
+                    json->append( escaped );
+                } else {
+                    json->push_back( character );
+                }
+            }
+
+            json->push_back( '"' );
+        }
+
+        /**
+         * @brief Append nanoseconds as the microseconds Chrome traces use, keeping the nanosecond digits
+         */
+        void append_json_microseconds( std::string *json, const uint64_t nanoseconds ) {
+            char number[ 32 ];
+            snprintf( number, sizeof( number ), "%" PRIu64 ".%03" PRIu64, nanoseconds / 1000, nanoseconds % 1000 );
+            json->append( number );
+        }
+    } // namespace
+
+    bool convert_trace_to_chrome_json( const uint8_t *trace, const size_t trace_size, std::string *json ) {
+        trace_cursor_t      cursor{ trace, trace_size };
+        trace_file_header_t header;
+
+        if ( !cursor.read( &header, sizeof( header ) ) || header.m_magic != g_trace_magic || header.m_version != g_trace_version )
+            return false;
+
+        std::vector< std::string_view > names( header.m_name_count );
+        for ( std::string_view &name : names ) {
+            uint16_t name_length = 0;
+            if ( !cursor.read( &name_length, sizeof( name_length ) ) || trace_size - cursor.m_offset < name_length )
+                return false;
+
+            name = std::string_view( reinterpret_cast< const char * >( trace + cursor.m_offset ), name_length );
+            cursor.m_offset += name_length;
+        }
+
+        const size_t remaining = trace_size - cursor.m_offset;
+        if ( header.m_event_count > remaining / sizeof( trace_record_t )
+             || remaining - header.m_event_count * sizeof( trace_record_t ) < header.m_thread_count * sizeof( trace_counter_record_t ) )
+            return false;
+
+        std::vector< trace_record_t >         events( header.m_event_count );
+        std::vector< trace_counter_record_t > counters( header.m_thread_count );
+        cursor.read( events.data( ), events.size( ) * sizeof( trace_record_t ) );
+        cursor.read( counters.data( ), counters.size( ) * sizeof( trace_counter_record_t ) );
+
+        // Chrome only needs relative times; start at the earliest event
+        uint64_t base_ns = UINT64_MAX;
+        uint64_t end_ns  = 0;
+        for ( const trace_record_t &event : events ) {
+            base_ns = std::min( base_ns, event.m_begin_ns );
+            end_ns  = std::max( end_ns, event.m_begin_ns + event.m_duration_ns );
+        }
+        if ( events.empty( ) )
+            base_ns = 0;
+
+        json->clear( );
+        json->append( "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[" );
+
+        bool first_event = true;
+        for ( const trace_record_t &event : events ) {
+            if ( event.m_name_index >= names.size( ) )
+                return false;
+
+            json->append( first_event ? "{\"name\":" : ",{\"name\":" );
+            append_json_string( json, names[ event.m_name_index ] );
+            json->append( ",\"cat\":\"vac\",\"ph\":\"X\",\"pid\":1,\"tid\":" );
+            json->append( std::to_string( event.m_thread_id ) );
+            json->append( ",\"ts\":" );
+            append_json_microseconds( json, event.m_begin_ns - base_ns );
+            json->append( ",\"dur\":" );
+            append_json_microseconds( json, event.m_duration_ns );
+            json->push_back( '}' );
+
+            first_event = false;
+        }
+
+        for ( const trace_counter_record_t &counter : counters ) {
+            json->append( first_event ? "{\"name\":\"vac_counters\",\"ph\":\"C\",\"pid\":1,\"tid\":"
+                                      : ",{\"name\":\"vac_counters\",\"ph\":\"C\",\"pid\":1,\"tid\":" );
+            json->append( std::to_string( counter.m_thread_id ) );
+            json->append( ",\"ts\":" );
+            append_json_microseconds( json, end_ns - base_ns );
+            json->append( ",\"args\":{\"syscalls\":" );
+            json->append( std::to_string( counter.m_counters.m_syscalls ) );
+            json->append( ",\"bytes_copied\":" );
+            json->append( std::to_string( counter.m_counters.m_bytes_copied ) );
+            json->append( ",\"heap_allocations\":" );
+            json->append( std::to_string( counter.m_counters.m_heap_allocations ) );
+            json->append( ",\"heap_bytes\":" );
+            json->append( std::to_string( counter.m_counters.m_heap_bytes ) );
+            json->append( "}}" );
+
+            first_event = false;
+        }
+
+        json->append( "]}" );
+        return true;
+    }
+
+#if VAC_INSTRUMENTATION
+    namespace {
+        constexpr uint64_t g_ring_mask = VAC_INSTRUMENTATION_RING_EVENTS - 1;
+
+        std::atomic< thread_instrumentation_t * > g_thread_list     = { };   ///< Most recently registered thread, linked through m_next
+        std::atomic< uint32_t >                    g_next_thread_id  = { 1 }; ///< Id of the next registered thread
+        thread_local thread_instrumentation_t     *t_instrumentation = { };   ///< State of this thread, once registered
+
+        thread_counters_t read_counters( const thread_instrumentation_t &state ) {
+            thread_counters_t counters;
+            counters.m_syscalls         = state.m_syscalls.load( std::memory_order_relaxed );
+            counters.m_bytes_copied     = state.m_bytes_copied.load( std::memory_order_relaxed );
+            counters.m_heap_allocations = state.m_heap_allocations.load( std::memory_order_relaxed );
+            counters.m_heap_bytes       = state.m_heap_bytes.load( std::memory_order_relaxed );
+            return counters;
+        }
+
+        /**
+         * @brief Append raw bytes to a trace
+         */
+        void append_bytes( std::vector< uint8_t > *trace, const void *data, const size_t length ) {
+            const auto *bytes = static_cast< const uint8_t * >( data );
+            trace->insert( trace->end( ), bytes, bytes + length );
+        }
+    } // namespace
+
+    thread_instrumentation_t &current_thread_instrumentation( ) {
+        if ( t_instrumentation )
+            return *t_instrumentation;
+
+        // Never freed, serialize_trace() may walk the list after the thread exits
+        auto *state        = new thread_instrumentation_t( );
+        state->m_thread_id = g_next_thread_id.fetch_add( 1, std::memory_order_relaxed );
+
+        thread_instrumentation_t *list_head = g_thread_list.load( std::memory_order_relaxed );
+        do {
+            state->m_next = list_head;
+        } while ( !g_thread_list.compare_exchange_weak( list_head, state, std::memory_order_release, std::memory_order_relaxed ) );
+
+        t_instrumentation = state;
+        return *state;
+    }
+
+    void record_trace_event( const char *name, const uint64_t begin_ns, const uint64_t duration_ns ) {
+        thread_instrumentation_t &state = current_thread_instrumentation( );
+        const uint64_t            head  = state.m_head.load( std::memory_order_relaxed );
+
+        state.m_events[ head & g_ring_mask ] = { name, begin_ns, duration_ns };
+        state.m_head.store( head + 1, std::memory_order_release );
+    }
+
+    thread_counters_t current_thread_counters( ) { return read_counters( current_thread_instrumentation( ) ); }
+
+    thread_counters_t total_thread_counters( ) {
+        thread_counters_t total;
+
+        for ( const thread_instrumentation_t *state = g_thread_list.load( std::memory_order_acquire ); state; state = state->m_next ) {
+            const thread_counters_t counters = read_counters( *state );
+            total.m_syscalls         += counters.m_syscalls;
+            total.m_bytes_copied     += counters.m_bytes_copied;
+            total.m_heap_allocations += counters.m_heap_allocations;
+            total.m_heap_bytes       += counters.m_heap_bytes;
+        }
+
+        return total;
+    }
+
+    void serialize_trace( std::vector< uint8_t > *trace ) {
+        std::vector< trace_record_t >                    events;
+        std::vector< trace_counter_record_t >            counters;
+        std::vector< std::string_view >                  names;
+        std::unordered_map< std::string_view, uint32_t > name_indices;
+        std::vector< trace_event_t >                     ring;
+
+        for ( const thread_instrumentation_t *state = g_thread_list.load( std::memory_order_acquire ); state; state = state->m_next ) {
+            // Copy the live part of the ring, then keep only what the owner cannot have overwritten meanwhile
+            const uint64_t head  = state->m_head.load( std::memory_order_acquire );
+            const uint64_t first = head > VAC_INSTRUMENTATION_RING_EVENTS ? head - VAC_INSTRUMENTATION_RING_EVENTS : 0;
+
+            ring.resize( static_cast< size_t >( head - first ) );
+            for ( uint64_t index = first; index < head; ++index )
+                ring[ static_cast< size_t >( index - first ) ] = state->m_events[ index & g_ring_mask ];
+
+            std::atomic_thread_fence( std::memory_order_acquire );
+            const uint64_t head_after = state->m_head.load( std::memory_order_relaxed );
+
+            // The owner may be writing slot head_after, which held event head_after - ring size
+            const uint64_t first_intact
+                = std::max( first, head_after >= VAC_INSTRUMENTATION_RING_EVENTS ? head_after - VAC_INSTRUMENTATION_RING_EVENTS + 1 : 0 );
+
+            for ( uint64_t index = first_intact; index < head; ++index ) {
+                const trace_event_t &event = ring[ static_cast< size_t >( index - first ) ];
+                const std::string_view name( event.m_name, std::min< size_t >( strlen( event.m_name ), UINT16_MAX ) );
+
+                const auto [ name_entry, inserted ] = name_indices.try_emplace( name, static_cast< uint32_t >( names.size( ) ) );
+                if ( inserted )
+                    names.push_back( name );
+
+                events.push_back( { event.m_begin_ns, event.m_duration_ns, name_entry->second, state->m_thread_id } );
+            }
+
+            counters.push_back( { state->m_thread_id, 0, read_counters( *state ) } );
+        }
+
+        trace_file_header_t header;
+        header.m_magic        = g_trace_magic;
+        header.m_version      = g_trace_version;
+        header.m_name_count   = static_cast< uint32_t >( names.size( ) );
+        header.m_thread_count = static_cast< uint32_t >( counters.size( ) );
+        header.m_event_count  = events.size( );
+
+        trace->clear( );
+        append_bytes( trace, &header, sizeof( header ) );
+
+        for ( const std::string_view name : names ) {
+            const uint16_t name_length = static_cast< uint16_t >( name.size( ) );
+            append_bytes( trace, &name_length, sizeof( name_length ) );
+            append_bytes( trace, name.data( ), name.size( ) );
+        }
+
+        append_bytes( trace, events.data( ), events.size( ) * sizeof( trace_record_t ) );
+        append_bytes( trace, counters.data( ), counters.size( ) * sizeof( trace_counter_record_t ) );
+    }
+
+    bool dump_trace( const char *path ) {
+        std::vector< uint8_t > trace;
+        serialize_trace( &trace );
+
+        FILE *trace_file = fopen( path, "wb" );
+        if ( !trace_file )
+            return false;
+
+        const bool written = fwrite( trace.data( ), 1, trace.size( ), trace_file ) == trace.size( );
+        return fclose( trace_file ) == 0 && written;
+    }
+
+    scoped_timer_t::scoped_timer_t( const char *name ) : m_name( name ), m_begin_ns( precise_clock( ).now_ns( ) ) { }
+
+    scoped_timer_t::~scoped_timer_t( ) {
+        const uint64_t end_ns = precise_clock( ).now_ns( );
+        record_trace_event( m_name, m_begin_ns, end_ns - m_begin_ns );
+    }
+#endif
+} // namespace vac::utils
@@ -0,0 +1,225 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Build with -DVAC_INSTRUMENTATION=1 to compile in scoped timers, counters and the event trace
+ *
+ * With the default of 0 every VAC_TRACE_* and VAC_COUNT_* macro expands to an unevaluated
+ * expression and none of the recording code is compiled, so annotated code is unchanged.
+ */
+#ifndef VAC_INSTRUMENTATION
+#define VAC_INSTRUMENTATION 0
+#endif
+
+/**
+ * @brief Events kept per thread, older events are overwritten; must be a power of two
+ */
+#ifndef VAC_INSTRUMENTATION_RING_EVENTS
+#define VAC_INSTRUMENTATION_RING_EVENTS 8192
+#endif
+
+#if VAC_INSTRUMENTATION
+#include <atomic>
+#endif
+
+namespace vac::utils {
+    /**
+     * @brief Header of a binary trace written by serialize_trace()
+     *
+     * Followed by m_name_count names (uint16_t length, then the bytes, indexed in order),
+     * m_event_count trace_record_t and m_thread_count trace_counter_record_t.
+     */
+    struct trace_file_header_t {
+        uint32_t m_magic        = { }; ///< g_trace_magic
+        uint32_t m_version      = { }; ///< g_trace_version
+        uint32_t m_name_count   = { }; ///< Entries in the name table
+        uint32_t m_thread_count = { }; ///< Counter records
+        uint64_t m_event_count  = { }; ///< Event records
+    };
+
+    /**
+     * @brief One completed scope in a binary trace
+     */
+    struct trace_record_t {
+        uint64_t m_begin_ns    = { }; ///< precise_clock() time the scope was entered
+        uint64_t m_duration_ns = { }; ///< Time spent in the scope
+        uint32_t m_name_index  = { }; ///< Index into the name table
+        uint32_t m_thread_id   = { }; ///< Instrumentation thread id, 1 for the first thread seen
+    };
+
+    /**
+     * @brief Counters of one thread
+     */
+    struct thread_counters_t {
+        uint64_t m_syscalls         = { }; ///< System calls and native API calls made
+        uint64_t m_bytes_copied     = { }; ///< Bytes copied by copy_memory_vac()
+        uint64_t m_heap_allocations = { }; ///< allocate_from_heap() and HeapAlloc() calls
+        uint64_t m_heap_bytes       = { }; ///< Bytes requested by those calls
+    };
+
+    /**
+     * @brief Counters of one thread in a binary trace
+     */
+    struct trace_counter_record_t {
+        uint32_t          m_thread_id = { }; ///< Instrumentation thread id
+        uint32_t          m_reserved  = { }; ///< Zero
+        thread_counters_t m_counters  = { }; ///< Values at serialization time
+    };
+
+    constexpr uint32_t g_trace_magic   = 0x54434156; ///< "VACT"
+    constexpr uint32_t g_trace_version = 1;
+
+    static_assert( sizeof( trace_file_header_t ) == 24 );
+    static_assert( sizeof( trace_record_t ) == 24 );
+    static_assert( sizeof( trace_counter_record_t ) == 40 );
+
+    /**
+     * @brief Convert a binary trace to the Chrome trace event format (chrome://tracing, Perfetto)
+     *
+     * Scopes become complete ("X") events and the per-thread counters one counter ("C")
+     * event per thread at the end of the trace. Timestamps are microseconds relative to the
+     * earliest event. Available in every build so traces can be converted by release tools.
+     *
+     * @param trace Bytes written by serialize_trace()
+     * @param trace_size Number of bytes
+     * @param json Receives the JSON document
+     * @return False if the trace is truncated or not a version 1 trace
+     */
+    bool convert_trace_to_chrome_json( const uint8_t *trace, size_t trace_size, std::string *json );
+
+#if VAC_INSTRUMENTATION
+    /**
+     * @brief Event of a thread's ring, name is the string literal passed to the scope
+     */
+    struct trace_event_t {
+        const char *m_name        = { }; ///< Scope name, must outlive the trace
+        uint64_t    m_begin_ns    = { }; ///< precise_clock() time the scope was entered
+        uint64_t    m_duration_ns = { }; ///< Time spent in the scope
+    };
+
+    /**
+     * @brief Per-thread instrumentation state
+     *
+     * Created on a thread's first recording and linked into a process-wide list that is
+     * only ever prepended to, so serialize_trace() walks it without a lock; blocks are never
+     * freed and the events of exited threads stay available. Only the owning thread writes:
+     * counters are relaxed atomics updated with a load and a store, and the event ring is
+     * published by a release store of m_head. A reader copies the ring and then drops
+     * every event the owner may have overwritten meanwhile.
+     */
+    struct thread_instrumentation_t {
+        std::atomic< uint64_t > m_syscalls         = { }; ///< thread_counters_t::m_syscalls
+        std::atomic< uint64_t > m_bytes_copied     = { }; ///< thread_counters_t::m_bytes_copied
+        std::atomic< uint64_t > m_heap_allocations = { }; ///< thread_counters_t::m_heap_allocations
+        std::atomic< uint64_t > m_heap_bytes       = { }; ///< thread_counters_t::m_heap_bytes
+
+        std::atomic< uint64_t >   m_head                                       = { }; ///< Events ever recorded, next slot is m_head % ring size
+        trace_event_t             m_events[ VAC_INSTRUMENTATION_RING_EVENTS ] = { }; ///< Event ring
+        uint32_t                  m_thread_id                                  = { }; ///< 1 for the first thread seen
+        thread_instrumentation_t *m_next                                       = { }; ///< Previously registered thread
+    };
+
+    static_assert( ( VAC_INSTRUMENTATION_RING_EVENTS & ( VAC_INSTRUMENTATION_RING_EVENTS - 1 ) ) == 0 );
+
+    /**
+     * @brief State of the calling thread, registered on first use
+     */
+    thread_instrumentation_t &current_thread_instrumentation( );
+
+    /**
+     * @brief Add to a counter of the calling thread; single writer, so no read-modify-write
+     */
+    inline void add_thread_counter( std::atomic< uint64_t > &counter, const uint64_t value ) {
+        counter.store( counter.load( std::memory_order_relaxed ) + value, std::memory_order_relaxed );
+    }
+
+    /**
+     * @brief Append a completed scope to the calling thread's ring
+     */
+    void record_trace_event( const char *name, uint64_t begin_ns, uint64_t duration_ns );
+
+    /**
+     * @brief Counters of the calling thread
+     */
+    thread_counters_t current_thread_counters( );
+
+    /**
+     * @brief Counters summed over every thread seen so far
+     */
+    thread_counters_t total_thread_counters( );
+
+    /**
+     * @brief Snapshot every thread's ring and counters into the binary trace format
+     * @param trace Receives the trace, replaced
+     */
+    void serialize_trace( std::vector< uint8_t > *trace );
+
+    /**
+     * @brief serialize_trace() into a file
+     * @return False if the file could not be written
+     */
+    bool dump_trace( const char *path );
+
+    /**
+     * @brief Time a scope and record it in the calling thread's ring
+     *
+     * Times come from precise_clock(), so the resolution is that of its backend.
+     */
+    class scoped_timer_t {
+    public:
+        explicit scoped_timer_t( const char *name );
+        ~scoped_timer_t( );
+
+        scoped_timer_t( const scoped_timer_t & )            = delete;
+        scoped_timer_t &operator=( const scoped_timer_t & ) = delete;
+
+    private:
+        const char *m_name     = { }; ///< String literal naming the scope
+        uint64_t    m_begin_ns = { }; ///< Entry time
+    };
+#endif
+} // namespace vac::utils
+
+#if VAC_INSTRUMENTATION
+#define VAC_TRACE_CONCAT_INNER( a, b ) a##b
+#define VAC_TRACE_CONCAT( a, b )       VAC_TRACE_CONCAT_INNER( a, b )
+
+/**
+ * @brief Time the rest of the enclosing scope under a string literal name
+ */
+#define VAC_TRACE_SCOPE( name ) const ::vac::utils::scoped_timer_t VAC_TRACE_CONCAT( vac_trace_scope_, __LINE__ )( name )
+
+/**
+ * @brief Time the rest of the enclosing function under its name
+ */
+#define VAC_TRACE_FUNCTION( ) VAC_TRACE_SCOPE( __func__ )
+
+/**
+ * @brief Count system calls, copied bytes and heap allocations on the calling thread
+ */
+#define VAC_COUNT_SYSCALLS( count )                                                                                                        \
+    ::vac::utils::add_thread_counter( ::vac::utils::current_thread_instrumentation( ).m_syscalls, static_cast< uint64_t >( count ) )
+
+#define VAC_COUNT_SYSCALL( ) VAC_COUNT_SYSCALLS( 1 )
+
+#define VAC_COUNT_BYTES_COPIED( bytes )                                                                                                    \
+    ::vac::utils::add_thread_counter( ::vac::utils::current_thread_instrumentation( ).m_bytes_copied, static_cast< uint64_t >( bytes ) )
+
+#define VAC_COUNT_HEAP_ALLOCATION( bytes )                                                                                                 \
+    do {                                                                                                                                   \
+        ::vac::utils::thread_instrumentation_t &vac_trace_state = ::vac::utils::current_thread_instrumentation( );                        \
+        ::vac::utils::add_thread_counter( vac_trace_state.m_heap_allocations, 1 );                                                         \
+        ::vac::utils::add_thread_counter( vac_trace_state.m_heap_bytes, static_cast< uint64_t >( bytes ) );                               \
+    } while ( false )
+#else
+#define VAC_TRACE_SCOPE( name )            static_cast< void >( 0 )
+#define VAC_TRACE_FUNCTION( )              static_cast< void >( 0 )
+#define VAC_COUNT_SYSCALLS( count )        static_cast< void >( sizeof( count ) )
+#define VAC_COUNT_SYSCALL( )               static_cast< void >( 0 )
+#define VAC_COUNT_BYTES_COPIED( bytes )    static_cast< void >( sizeof( bytes ) )
+#define VAC_COUNT_HEAP_ALLOCATION( bytes ) static_cast< void >( sizeof( bytes ) )
+#endif
@@ -0,0 +1,117 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace vac::utils {
+    /**
+     * @brief Derive the key of one literal from its module key
+     *
+     * Every literal gets its own key so equal strings in one module do not share
+     * ciphertext; a zero result falls back to the module key so nothing is stored
+     * in plain text.
+     *
+     * @param module_key Module wide key (VAC_PNP_STRING_KEY, ...)
+     * @param literal_salt Per-literal salt, __COUNTER__ at the use site
+     * @return Key byte for the literal
+     */
+    consteval uint8_t make_literal_key( const uint8_t module_key, const uint32_t literal_salt ) {
+        const uint8_t literal_key = static_cast< uint8_t >( module_key ^ ( literal_salt * 0x9Du ) );
+        return literal_key ? literal_key : module_key;
+    }
+
+    /**
+     * @brief Key byte of one character position, key ^ ( index * 0x1D )
+     *
+     * 0x1D is odd, so one position in every 256 would get a zero key and be stored in
+     * plain text; that position uses 0xA5 instead.
+     *
+     * @param key Key byte of the literal
+     * @param index Character position
+     * @return Non-zero key byte
+     */
+    constexpr uint8_t position_key( const uint8_t key, const size_t index ) {
+        const uint8_t rolled_key = static_cast< uint8_t >( key ^ ( index * 0x1D ) );
+        return rolled_key ? rolled_key : 0xA5;
+    }
+
+    /**
+     * @brief Check every key and position residue (the roll repeats every 256 positions)
+     */
+    consteval bool position_keys_are_nonzero( ) {
+        for ( size_t key = 0; key < 256; ++key ) {
+            for ( size_t index = 0; index < 256; ++index ) {
+                if ( !position_key( static_cast< uint8_t >( key ), index ) )
+                    return false;
+            }
+        }
+
+        return true;
+    }
+
+    static_assert( position_keys_are_nonzero( ), "a zero position key leaves the character in plain text" );
+
+    /**
+     * @brief String literal stored XOR encoded, encoded entirely at compile time
+     *
+     * Character i is XORed with position_key( key, i ): VAC's single-byte XOR scheme with
+     * the key rolled per position, so runs of equal characters do not leak. The
+     * constructor is consteval, so the plain text never ends up in the binary; only
+     * decode() at run time (or at() while building other compile-time tables) reveals it.
+     *
+     * @tparam length Size of the literal including its terminator
+     * @tparam key Key byte of this literal
+     */
+    template < size_t length, uint8_t key >
+    class obfuscated_string_t {
+    public:
+        consteval obfuscated_string_t( const char ( &text )[ length ] ) {
+            for ( size_t index = 0; index < length; ++index )
+                m_encoded[ index ] = static_cast< char >( text[ index ] ^ key_at( index ) );
+        }
+
+        /**
+         * @brief Decoded character, for compile-time consumers
+         */
+        constexpr char at( const size_t index ) const { return static_cast< char >( m_encoded[ index ] ^ key_at( index ) ); }
+
+        /**
+         * @return Number of characters without the terminator
+         */
+        static constexpr size_t size( ) { return length - 1; }
+
+        /**
+         * @brief Decode into a null terminated copy
+         */
+        std::array< char, length > decode( ) const {
+            std::array< char, length > decoded = { };
+            for ( size_t index = 0; index < length; ++index )
+                decoded[ index ] = at( index );
+
+            return decoded;
+        }
+
+    private:
+        static constexpr uint8_t key_at( const size_t index ) { return position_key( key, index ); }
+
+        std::array< char, length > m_encoded = { };
+    };
+} // namespace vac::utils
+
+/**
+ * @brief Obfuscated literal decoded once, on first use, into a function-local static
+ *
+ * Evaluates to a const char * that stays valid for the lifetime of the process.
+ * Decoding is thread safe (static initialisation) and costs nothing after the first call.
+ *
+ * @param text String literal
+ * @param module_key Key byte of the calling module, e.g. VAC_PNP_STRING_KEY
+ */
+#define VAC_OBFUSCATED_STRING( text, module_key )                                                                                          \
+    ( [ ]( ) -> const char * {                                                                                                             \
+        static constexpr ::vac::utils::obfuscated_string_t< sizeof( text ),                                                                \
+                                                            ::vac::utils::make_literal_key( ( module_key ), __COUNTER__ ) >                \
+                           encoded_string( text );                                                                                         \
+        static const auto decoded_string = encoded_string.decode( );                                                                      \
+        return decoded_string.data( );                                                                                                     \
+    }( ) )
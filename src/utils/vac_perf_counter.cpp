@@ -0,0 +1,73 @@
+#include "vac_perf_counter.hpp"
+#include "vac_instrumentation.hpp"
+
+#if defined( __linux__ )
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace vac::utils {
+#if defined( __linux__ )
+    perf_counter_t::perf_counter_t( const perf_event_t event ) {
+        perf_event_attr attributes = { };
+        attributes.type            = PERF_TYPE_HARDWARE;
+        attributes.size            = sizeof( attributes );
+        attributes.disabled        = 1;
+        attributes.exclude_kernel  = 1;
+        attributes.exclude_hv      = 1;
+
+        switch ( event ) {
+            case perf_event_t::cache_misses: attributes.config = PERF_COUNT_HW_CACHE_MISSES; break;
+            case perf_event_t::instructions: attributes.config = PERF_COUNT_HW_INSTRUCTIONS; break;
+            case perf_event_t::cycles: attributes.config = PERF_COUNT_HW_CPU_CYCLES; break;
+        }
+
+        // Calling thread on any CPU, no group
+        VAC_COUNT_SYSCALL( );
+        m_fd = static_cast< int >( syscall( SYS_perf_event_open, &attributes, 0, -1, -1, 0 ) );
+    }
+
+    perf_counter_t::~perf_counter_t( ) {
+        if ( m_fd < 0 )
+            return;
+
+        VAC_COUNT_SYSCALL( );
+        close( m_fd );
+    }
+
+    void perf_counter_t::start( ) {
+        if ( m_fd < 0 )
+            return;
+
+        VAC_COUNT_SYSCALL( );
+        ioctl( m_fd, PERF_EVENT_IOC_RESET, 0 );
+        VAC_COUNT_SYSCALL( );
+        ioctl( m_fd, PERF_EVENT_IOC_ENABLE, 0 );
+    }
+
+    uint64_t perf_counter_t::stop( ) {
+        if ( m_fd < 0 )
+            return 0;
+
+        VAC_COUNT_SYSCALL( );
+        ioctl( m_fd, PERF_EVENT_IOC_DISABLE, 0 );
+
+        uint64_t count = 0;
+        VAC_COUNT_SYSCALL( );
+        if ( read( m_fd, &count, sizeof( count ) ) != sizeof( count ) )
+            return 0;
+
+        return count;
+    }
+#else
+    perf_counter_t::perf_counter_t( [[maybe_unused]] const perf_event_t event ) { }
+
+    perf_counter_t::~perf_counter_t( ) = default;
+
+    void perf_counter_t::start( ) { }
+
+    uint64_t perf_counter_t::stop( ) { return 0; }
+#endif
+} // namespace vac::utils
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+
+namespace vac::utils {
+    /**
+     * @brief Hardware events perf_counter_t can count
+     */
+    enum class perf_event_t : uint32_t {
+        cache_misses = 0, ///< Last-level cache misses
+        instructions = 1, ///< Retired instructions
+        cycles       = 2, ///< Core cycles
+    };
+
+    /**
+     * @brief Hardware event counter of the calling thread, user mode only
+     *
+     * Backed by perf_event_open on Linux, which works at the default perf_event_paranoid
+     * of 2 because kernel events are excluded. Other platforms and kernels or hypervisors
+     * without a PMU leave the counter unavailable, and benchmarks report the event as
+     * missing rather than zero.
+     */
+    class perf_counter_t {
+    public:
+        explicit perf_counter_t( perf_event_t event );
+        ~perf_counter_t( );
+
+        perf_counter_t( const perf_counter_t & )            = delete;
+        perf_counter_t &operator=( const perf_counter_t & ) = delete;
+
+        bool available( ) const { return m_fd >= 0; }
+
+        /**
+         * @brief Reset the count to zero and start counting
+         */
+        void start( );
+
+        /**
+         * @brief Stop counting
+         * @return Events since start(), 0 if the counter is unavailable
+         */
+        uint64_t stop( );
+
+    private:
+        int m_fd = -1; ///< perf event descriptor, -1 when unavailable
+    };
+} // namespace vac::utils
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstdint>
+
+namespace vac::utils {
+    /**
+     * @brief splitmix64 step, a small seeded generator for synthetic inputs and fixtures
+     *
+     * Equal seeds give equal sequences on every platform; not for anything security related.
+     *
+     * @param state Generator state, advanced by the call
+     * @return Next 64-bit value
+     */
+    inline uint64_t next_random( uint64_t *state ) {
+        uint64_t value = ( *state += 0x9E3779B97F4A7C15ULL );
+        value          = ( value ^ ( value >> 30 ) ) * 0xBF58476D1CE4E5B9ULL;
+        value          = ( value ^ ( value >> 27 ) ) * 0x94D049BB133111EBULL;
+        return value ^ ( value >> 31 );
+    }
+} // namespace vac::utils
@@ -1,7 +1,12 @@
 #include "vac_string_utils.hpp"
+#include "vac_instrumentation.hpp"
+
+#include <cstring>
 
 namespace vac::utils {
     unsigned char * copy_memory_vac( unsigned char *dest, const intptr_t source, const int length ) {
+        VAC_COUNT_BYTES_COPIED( length );
+
         int            remaining = length;
         unsigned char *result    = dest;
         if ( length ) {
@@ -26,6 +31,7 @@ namespace vac::utils {
         return buffer;
     }
 
+#if defined( _WIN32 )
     unsigned char *copy_wide_string_vac( unsigned char *dest, const WCHAR *source ) {
         copy_memory_vac( dest, reinterpret_cast< intptr_t >( source ), 1024 );
         const uint32_t length = lstrlenW( source );
@@ -34,4 +40,5 @@ namespace vac::utils {
         }
         return dest;
     }
+#endif
 } // namespace vac::utils
\ No newline at end of file
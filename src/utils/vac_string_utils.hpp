@@ -1,6 +1,7 @@
 #pragma once
+#include "../common/platform.hpp"
+
 #include <cstdint>
-#include <windows.h>
 
 namespace vac::utils {
     /**
@@ -21,6 +22,7 @@ namespace vac::utils {
      */
     char *__cdecl zero_memory_vac( char *buffer, char fill_value, uint32_t size );
 
+#if defined( _WIN32 )
     /**
      * @brief Wide string copy with path replacement
      * @param dest Destination buffer
@@ -28,4 +30,5 @@ namespace vac::utils {
      * @return Destination pointer
      */
     unsigned char * copy_wide_string_vac( unsigned char *dest, const WCHAR *source );
+#endif
 } // namespace vac::utils
\ No newline at end of file
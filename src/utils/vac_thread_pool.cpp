@@ -0,0 +1,98 @@
+#include "vac_thread_pool.hpp"
+
+namespace vac::utils {
+    namespace {
+        thread_local const thread_pool_t *t_current_pool   = { }; ///< Pool the calling thread works for, if any
+        thread_local unsigned int         t_current_worker = { }; ///< Worker index within t_current_pool
+    } // namespace
+
+    thread_pool_t::thread_pool_t( unsigned int worker_count ) {
+        if ( !worker_count )
+            worker_count = std::max( std::thread::hardware_concurrency( ), 1u );
+
+        m_queues.reserve( worker_count );
+        for ( unsigned int worker = 0; worker < worker_count; ++worker )
+            m_queues.push_back( std::make_unique< worker_queue_t >( ) );
+
+        m_workers.reserve( worker_count );
+        for ( unsigned int worker = 0; worker < worker_count; ++worker )
+            m_workers.emplace_back( [ this, worker ] { worker_loop( worker ); } );
+    }
+
+    thread_pool_t::~thread_pool_t( ) {
+        {
+            std::lock_guard< std::mutex > lock( m_sleep_mutex );
+            m_stopping = true;
+        }
+        m_task_available.notify_all( );
+
+        for ( auto &worker : m_workers )
+            worker.join( );
+    }
+
+    void thread_pool_t::submit( std::function< void( ) > task ) {
+        // Workers keep their own follow-up tasks local, outside submits are spread out
+        const unsigned int queue_index = t_current_pool == this ? t_current_worker
+                                                                : m_next_queue.fetch_add( 1, std::memory_order_relaxed ) % worker_count( );
+        {
+            // Counted under the queue lock, so the pop that takes the task always decrements after this
+            std::lock_guard< std::mutex > lock( m_queues[ queue_index ]->m_mutex );
+            m_queues[ queue_index ]->m_tasks.push_back( std::move( task ) );
+            m_pending.fetch_add( 1 );
+        }
+
+        // Taking the sleep mutex orders the count with a worker that is about to wait
+        { std::lock_guard< std::mutex > lock( m_sleep_mutex ); }
+        m_task_available.notify_one( );
+    }
+
+    bool thread_pool_t::take_task( const unsigned int worker, std::function< void( ) > *task ) {
+        {
+            worker_queue_t               &own_queue = *m_queues[ worker ];
+            std::lock_guard< std::mutex > lock( own_queue.m_mutex );
+
+            if ( !own_queue.m_tasks.empty( ) ) {
+                *task = std::move( own_queue.m_tasks.back( ) );
+                own_queue.m_tasks.pop_back( );
+                m_pending.fetch_sub( 1 );
+                return true;
+            }
+        }
+
+        // Steal the oldest task of the next busy worker
+        for ( unsigned int offset = 1; offset < worker_count( ); ++offset ) {
+            worker_queue_t               &victim_queue = *m_queues[ ( worker + offset ) % worker_count( ) ];
+            std::lock_guard< std::mutex > lock( victim_queue.m_mutex );
+
+            if ( !victim_queue.m_tasks.empty( ) ) {
+                *task = std::move( victim_queue.m_tasks.front( ) );
+                victim_queue.m_tasks.pop_front( );
+                m_pending.fetch_sub( 1 );
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void thread_pool_t::worker_loop( const unsigned int worker ) {
+        t_current_pool   = this;
+        t_current_worker = worker;
+
+        while ( true ) {
+            std::function< void( ) > task;
+
+            if ( take_task( worker, &task ) ) {
+                task( );
+                continue;
+            }
+
+            std::unique_lock< std::mutex > lock( m_sleep_mutex );
+            m_task_available.wait( lock, [ this ] { return m_stopping || m_pending.load( ) != 0; } );
+
+            // Pending tasks are drained before shutting down
+            if ( m_stopping && !m_pending.load( ) )
+                return;
+        }
+    }
+} // namespace vac::utils
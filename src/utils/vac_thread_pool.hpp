@@ -0,0 +1,108 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace vac::utils {
+    /**
+     * @brief Small fixed-size work-stealing pool
+     *
+     * Every worker owns a deque: tasks submitted from a worker go to the back of its own
+     * deque and are taken from there (LIFO, cache warm), tasks submitted from outside are
+     * spread round-robin over the deques, and an idle worker steals from the front of the
+     * others. Meant for fan-out jobs such as property reads across a few hundred devices or
+     * one task per scan module. parallel_for() blocks the caller and must not be called from
+     * a pool worker.
+     */
+    class thread_pool_t {
+    public:
+        /**
+         * @param worker_count Number of worker threads, 0 to use the hardware concurrency
+         */
+        explicit thread_pool_t( unsigned int worker_count = 0 );
+        ~thread_pool_t( );
+
+        thread_pool_t( const thread_pool_t & )             = delete;
+        thread_pool_t &operator=( const thread_pool_t & ) = delete;
+
+        unsigned int worker_count( ) const { return static_cast< unsigned int >( m_queues.size( ) ); }
+
+        /**
+         * @brief Queue a task for any worker
+         */
+        void submit( std::function< void( ) > task );
+
+        /**
+         * @brief Run body over [0, count) in grains and wait for completion
+         *
+         * At most worker_count() slots run at once; each slot pulls the next grain from
+         * a shared counter, so grains are handed out in increasing order and a slot
+         * sees its own ranges in increasing order too. The slot index (below
+         * worker_count()) lets callers keep per-slot state without locking.
+         *
+         * @param count Number of items
+         * @param grain Items per call of body, at least 1
+         * @param body Callable as body( size_t begin, size_t end, unsigned int slot )
+         */
+        template < typename body_t >
+        void parallel_for( const size_t count, const size_t grain, body_t &&body ) {
+            if ( !count )
+                return;
+
+            const size_t       grain_size = std::max< size_t >( grain, 1 );
+            const unsigned int slot_count
+                = static_cast< unsigned int >( std::min< size_t >( worker_count( ), ( count + grain_size - 1 ) / grain_size ) );
+
+            std::atomic< size_t >   next_item     = { 0 };
+            unsigned int            slots_running = slot_count;
+            std::mutex              done_mutex;
+            std::condition_variable done_signal;
+
+            for ( unsigned int slot = 0; slot < slot_count; ++slot ) {
+                submit( [ &, slot ] {
+                    for ( size_t begin = next_item.fetch_add( grain_size ); begin < count; begin = next_item.fetch_add( grain_size ) )
+                        body( begin, std::min( begin + grain_size, count ), slot );
+
+                    std::lock_guard< std::mutex > done_lock( done_mutex );
+                    if ( !--slots_running )
+                        done_signal.notify_one( );
+                } );
+            }
+
+            std::unique_lock< std::mutex > done_lock( done_mutex );
+            done_signal.wait( done_lock, [ & ] { return !slots_running; } );
+        }
+
+    private:
+        /**
+         * @brief Deque of one worker, the owner uses the back and thieves the front
+         */
+        struct worker_queue_t {
+            std::mutex                            m_mutex; ///< Guards m_tasks
+            std::deque< std::function< void( ) > > m_tasks; ///< Pending tasks
+        };
+
+        /**
+         * @brief Take a task from the worker's own deque, or steal one from another
+         */
+        bool take_task( unsigned int worker, std::function< void( ) > *task );
+
+        void worker_loop( unsigned int worker );
+
+        std::vector< std::thread >                        m_workers;
+        std::vector< std::unique_ptr< worker_queue_t > > m_queues;          ///< One per worker
+        std::atomic< size_t >                             m_pending     = { }; ///< Tasks queued and not yet taken
+        std::atomic< unsigned int >                       m_next_queue  = { }; ///< Round-robin target for outside submits
+        std::mutex                                        m_sleep_mutex;       ///< Guards m_stopping, pairs with m_task_available
+        std::condition_variable                           m_task_available;    ///< Signalled on submit and shutdown
+        bool                                              m_stopping    = { }; ///< Set by the destructor
+    };
+} // namespace vac::utils